@@ -0,0 +1,215 @@
+#include "adaptive.h"
+#include "stats.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * Bandit
+ *
+ * Cada braço guarda as contagens descontadas que o bandit usa (n e soma das
+ * recompensas para o UCB, sucessos e falhas para o Thompson) e os totais
+ * sem desconto para o relatório.
+ */
+
+typedef struct {
+    int policy;
+    char name[16];
+    double n;                  // jogadas descontadas
+    double sum;                // recompensas descontadas
+    double wins, losses;       // ensaios de Bernoulli descontados (Thompson)
+    uint32_t plays;
+    double reward_sum;
+} arm_t;
+
+static arm_t arms[ADAPTIVE_MAX_ARMS];
+static int narms = 0;
+static int cur = 0;
+static adaptive_bandit_en bandit = ADAPTIVE_UCB;
+static uint32_t epoch_ms = ADAPTIVE_EPOCH_MS;
+static uint32_t next_epoch_ms = ADAPTIVE_EPOCH_MS;
+
+// Bursts terminados na época atual
+static uint32_t epoch_done = 0;
+static double epoch_speed = 0.0;       // Σ 1 / slowdown
+
+static uint32_t epochs = 0;            // épocas com recompensa
+static uint32_t dwell = 0;             // épocas do braço atual desde que começou a jogar
+static double reward_min = 1.0;        // recompensas observadas (escala da exploração)
+static double reward_max = 0.0;
+static uint32_t switches = 0;
+static double reward_total = 0.0;
+
+static uint64_t rng_state = ADAPTIVE_SEED;
+
+void adaptive_set_epoch(uint32_t ms) {
+    epoch_ms = ms;
+    next_epoch_ms = ms;
+}
+
+void adaptive_set_bandit(adaptive_bandit_en b) {
+    bandit = b;
+}
+
+void adaptive_add_arm(int policy, const char *name) {
+    if (narms == ADAPTIVE_MAX_ARMS) return;
+    arm_t *a = &arms[narms++];
+    memset(a, 0, sizeof(*a));
+    a->policy = policy;
+    strncpy(a->name, name, sizeof(a->name) - 1);
+}
+
+int adaptive_policy(void) {
+    return arms[cur].policy;
+}
+
+// xorshift64*: uniforme em (0, 1)
+static double uniform(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return ((rng_state * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0) + 1e-12;
+}
+
+static double normal(void) {
+    return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+// Gamma(k, 1) pelo método de Marsaglia e Tsang
+static double gamma_sample(double k) {
+    if (k < 1.0) return gamma_sample(k + 1.0) * pow(uniform(), 1.0 / k);
+    double d = k - 1.0 / 3.0;
+    double c = 1.0 / sqrt(9.0 * d);
+    for (;;) {
+        double x = normal();
+        double v = 1.0 + c * x;
+        if (v <= 0.0) continue;
+        v = v * v * v;
+        if (log(uniform()) < 0.5 * x * x + d - d * v + d * log(v)) return d * v;
+    }
+}
+
+static int all_played(void) {
+    for (int i = 0; i < narms; i++) {
+        if (arms[i].plays == 0) return 0;
+    }
+    return 1;
+}
+
+// UCB descontado: a exploração é escalada pela gama das recompensas
+// observadas, senão o sqrt(2 ln n / n_braço) do UCB1, com contagens
+// descontadas (poucas unidades por braço), pesa mais do que as diferenças
+// entre as médias e o bandit muda de política em quase todas as épocas
+static int choose_ucb(void) {
+    double total = 0.0;
+    for (int i = 0; i < narms; i++) {
+        if (arms[i].plays == 0) return i;
+        total += arms[i].n;
+    }
+    double range = reward_max > reward_min ? reward_max - reward_min : 0.0;
+    int best = 0;
+    double best_score = -1.0;
+    for (int i = 0; i < narms; i++) {
+        const arm_t *a = &arms[i];
+        double score = a->sum / a->n + range * sqrt(ADAPTIVE_UCB_XI * log(total) / a->n);
+        if (score > best_score) {
+            best = i;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+static int choose_thompson(void) {
+    int best = 0;
+    double best_theta = -1.0;
+    for (int i = 0; i < narms; i++) {
+        double x = gamma_sample(1.0 + arms[i].wins);
+        double y = gamma_sample(1.0 + arms[i].losses);
+        double theta = x / (x + y);
+        if (theta > best_theta) {
+            best = i;
+            best_theta = theta;
+        }
+    }
+    return best;
+}
+
+void adaptive_burst_done(const pcb_t *task, uint32_t now_ms) {
+    if (narms == 0) return;
+    uint32_t run = task->requested_ms > ADAPTIVE_TAU_MS ? task->requested_ms : ADAPTIVE_TAU_MS;
+    uint32_t latency = now_ms - task->arrival_time_ms;
+    epoch_done++;
+    epoch_speed += latency > run ? (double)run / latency : 1.0;
+}
+
+void adaptive_tick(uint32_t now_ms, adaptive_migrate_fn migrate, void *ctx) {
+    if (now_ms < next_epoch_ms || narms == 0) return;
+    next_epoch_ms += epoch_ms;
+
+    uint32_t done = epoch_done;
+    double speed = epoch_speed;
+    uint32_t backlog = stats_runnable();
+    epoch_done = 0;
+    epoch_speed = 0.0;
+    if (done == 0 && backlog == 0) return;
+
+    double r = speed / (done + backlog);
+    for (int i = 0; i < narms; i++) {
+        arms[i].n *= ADAPTIVE_DISCOUNT;
+        arms[i].sum *= ADAPTIVE_DISCOUNT;
+        arms[i].wins *= ADAPTIVE_DISCOUNT;
+        arms[i].losses *= ADAPTIVE_DISCOUNT;
+    }
+    arm_t *a = &arms[cur];
+    a->n += 1.0;
+    a->sum += r;
+    if (uniform() < r) {
+        a->wins += 1.0;
+    } else {
+        a->losses += 1.0;
+    }
+    a->plays++;
+    a->reward_sum += r;
+    epochs++;
+    reward_total += r;
+    if (r < reward_min) reward_min = r;
+    if (r > reward_max) reward_max = r;
+
+    // No Thompson a amostra da posterior muda em cada época e o bandit
+    // mudava de política quase sempre: depois de todos os braços terem
+    // jogado, cada um joga pelo menos ADAPTIVE_DWELL épocas seguidas (o UCB
+    // é determinístico e, com a exploração escalada, já não oscila)
+    dwell++;
+    if (bandit == ADAPTIVE_THOMPSON && dwell < ADAPTIVE_DWELL && all_played()) return;
+    int next = bandit == ADAPTIVE_UCB ? choose_ucb() : choose_thompson();
+    if (next != cur) {
+        migrate(arms[cur].policy, arms[next].policy, ctx);
+        cur = next;
+        switches++;
+        dwell = 0;
+    }
+}
+
+void adaptive_report(FILE *out) {
+    if (narms == 0) return;
+    fprintf(out, "---- Adaptive meta-scheduler (%s, %u ms epochs) ----\n",
+            bandit == ADAPTIVE_UCB ? "discounted UCB" : "Thompson sampling", epoch_ms);
+    fprintf(out, "%-8s %6s %11s\n", "arm", "plays", "mean.reward");
+    int best = -1;
+    for (int i = 0; i < narms; i++) {
+        const arm_t *a = &arms[i];
+        double mean = a->plays ? a->reward_sum / a->plays : 0.0;
+        fprintf(out, "%-8s %6u %11.3f\n", a->name, a->plays, mean);
+        if (a->plays && (best < 0 || mean > arms[best].reward_sum / arms[best].plays)) best = i;
+    }
+    fprintf(out, "Epochs:               %u (%u policy switches)\n", epochs, switches);
+    if (best >= 0) {
+        // Estimativa: o melhor braço a ganhar em todas as épocas a média que
+        // teve nesta corrida (não é uma corrida com essa política fixa)
+        double best_total = epochs * (arms[best].reward_sum / arms[best].plays);
+        fprintf(out, "Est. regret:          %.2f vs %s at its observed mean (%.1f %% of that reward)\n",
+                best_total - reward_total, arms[best].name,
+                best_total > 0 ? 100.0 * reward_total / best_total : 0.0);
+    }
+    fflush(out);
+}
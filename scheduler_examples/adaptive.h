@@ -0,0 +1,89 @@
+#ifndef ADAPTIVE_H
+#define ADAPTIVE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "queue.h"
+
+/*
+ * Meta-escalonador ADAPTIVE: escolhe online, com um multi-armed bandit, qual
+ * das políticas registadas (os "braços") escalona cada época.
+ *
+ * O tempo divide-se em épocas de --epoch ms. No fim de cada época o braço
+ * que jogou recebe uma recompensa em [0, 1] a partir do que se observou:
+ *
+ *     r = Σ (1 / slowdown de cada burst terminado) / (terminados + executáveis)
+ *
+ * com slowdown = latência / max(duração, ADAPTIVE_TAU_MS). Despachar todo o
+ * trabalho pendente (débito) sem atrasar ninguém (latência) dá 1. As épocas
+ * em que não terminou nada nem havia nada para correr não contam. O bandit
+ * escolhe o braço da época seguinte:
+ *
+ *   ucb       UCB descontado, média + gama * sqrt(ξ ln n / n_braço), com gama a
+ *             amplitude das recompensas observadas; cada braço joga uma vez primeiro
+ *   thompson  amostragem de Thompson com priors Beta(1, 1) e recompensas de
+ *             Bernoulli; cada braço joga pelo menos ADAPTIVE_DWELL épocas seguidas
+ *
+ * As contagens são descontadas em cada época (ADAPTIVE_DISCOUNT) para que o
+ * bandit acompanhe as mudanças de fase da carga.
+ *
+ * Quando o braço muda, o ossim migra as tarefas em fila para a nova política
+ * (ver adaptive_migrate_fn). O relatório estima o regret contra o melhor
+ * braço com as médias observadas nesta corrida; a comparação real é correr
+ * cada política fixa.
+ */
+
+#define ADAPTIVE_MAX_ARMS 8
+#define ADAPTIVE_EPOCH_MS 1000      // duração de uma época, por omissão
+#define ADAPTIVE_TAU_MS 100         // duração mínima no slowdown (bursts muito curtos)
+#define ADAPTIVE_DISCOUNT 0.95      // peso, na época seguinte, do que já foi observado
+#define ADAPTIVE_SEED 12345         // semente do gerador do Thompson (corridas reprodutíveis)
+#define ADAPTIVE_UCB_XI 0.5         // ξ, peso da exploração do UCB
+#define ADAPTIVE_DWELL 3            // épocas seguidas mínimas de um braço (Thompson)
+
+typedef enum {
+    ADAPTIVE_UCB = 0,
+    ADAPTIVE_THOMPSON
+} adaptive_bandit_en;
+
+// Migra as tarefas em fila da política from para a política to
+typedef void (*adaptive_migrate_fn)(int from, int to, void *ctx);
+
+/**
+ * @brief Duração de cada época, em ms
+ */
+void adaptive_set_epoch(uint32_t epoch_ms);
+
+/**
+ * @brief Algoritmo do bandit (por omissão o UCB)
+ */
+void adaptive_set_bandit(adaptive_bandit_en bandit);
+
+/**
+ * @brief Regista um braço: a política policy (scheduler_en do ossim) com este nome
+ */
+void adaptive_add_arm(int policy, const char *name);
+
+/**
+ * @brief Política que joga na época atual
+ */
+int adaptive_policy(void);
+
+/**
+ * @brief Um burst terminou: conta para a recompensa da época atual
+ */
+void adaptive_burst_done(const pcb_t *task, uint32_t now_ms);
+
+/**
+ * @brief Fecha a época se now_ms chegou ao fim dela e escolhe o braço seguinte
+ *
+ * Deve ser chamada no início de cada tick; chama migrate se o braço mudar.
+ */
+void adaptive_tick(uint32_t now_ms, adaptive_migrate_fn migrate, void *ctx);
+
+/**
+ * @brief Imprime as jogadas e a recompensa de cada braço e o regret estimado
+ */
+void adaptive_report(FILE *out);
+
+#endif //ADAPTIVE_H
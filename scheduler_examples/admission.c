@@ -0,0 +1,112 @@
+#include "admission.h"
+
+#include <stdlib.h>
+
+// Fila de pedidos retidos de uma ligação
+typedef struct adm_conn_st {
+    uint32_t sockfd;
+    queue_t pending;
+    struct adm_conn_st *next;
+} adm_conn_t;
+
+// Lista circular das ligações com pedidos retidos.
+// "cursor" aponta para a ligação a servir a seguir.
+static adm_conn_t *cursor = NULL;
+static uint32_t pending_count = 0;
+static adm_conn_t *free_conns = NULL;   // ligações reutilizadas (sem malloc por pedido)
+
+static adm_conn_t *find_conn(uint32_t sockfd) {
+    if (!cursor) return NULL;
+    adm_conn_t *c = cursor;
+    do {
+        if (c->sockfd == sockfd) return c;
+        c = c->next;
+    } while (c != cursor);
+    return NULL;
+}
+
+// Remove a ligação "c" da lista circular (a fila já tem de estar vazia)
+static void unlink_conn(adm_conn_t *c) {
+    if (c->next == c) {
+        cursor = NULL;
+    } else {
+        adm_conn_t *prev = c;
+        while (prev->next != c) prev = prev->next;
+        prev->next = c->next;
+        if (cursor == c) cursor = c->next;
+    }
+    c->next = free_conns;
+    free_conns = c;
+}
+
+int admission_park(pcb_t *task) {
+    adm_conn_t *c = find_conn(task->sockfd);
+    if (!c) {
+        if (free_conns) {
+            c = free_conns;
+            free_conns = c->next;
+        } else {
+            c = malloc(sizeof(adm_conn_t));
+            if (!c) return 0;
+        }
+        c->sockfd = task->sockfd;
+        c->pending.head = NULL;
+        c->pending.tail = NULL;
+        // Novas ligações entram logo antes do cursor (fim da ronda atual)
+        if (cursor) {
+            adm_conn_t *prev = cursor;
+            while (prev->next != cursor) prev = prev->next;
+            prev->next = c;
+            c->next = cursor;
+        } else {
+            c->next = c;
+            cursor = c;
+        }
+    }
+    if (!enqueue_pcb(&c->pending, task)) {
+        if (!c->pending.head) unlink_conn(c);
+        return 0;
+    }
+    pending_count++;
+    return 1;
+}
+
+pcb_t *admission_next(void) {
+    if (!cursor) return NULL;
+
+    adm_conn_t *c = cursor;
+    pcb_t *task = dequeue_pcb(&c->pending);
+    pending_count--;
+
+    // Avança o cursor para a próxima ligação (round-robin)
+    if (c->pending.head) {
+        cursor = c->next;
+    } else {
+        unlink_conn(c);
+    }
+    return task;
+}
+
+void admission_drop(uint32_t sockfd) {
+    adm_conn_t *c = find_conn(sockfd);
+    if (!c) return;
+    pcb_t *task;
+    while ((task = dequeue_pcb(&c->pending)) != NULL) {
+        free_pcb(task);
+        pending_count--;
+    }
+    unlink_conn(c);
+}
+
+uint32_t admission_pending(void) {
+    return pending_count;
+}
+
+void admission_free(void) {
+    while (cursor) admission_drop(cursor->sockfd);
+    while (free_conns) {
+        adm_conn_t *next = free_conns->next;
+        free(free_conns);
+        free_conns = next;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include <stdint.h>
+#include "queue.h"
+
+/*
+ * Controlo de admissão (flow control) para pedidos RUN.
+ *
+ * Quando o número de tarefas executáveis atinge o high-water mark, os novos
+ * pedidos RUN ficam retidos aqui sem ACK. Como as aplicações esperam pelo ACK
+ * antes de continuar, isto empurra a pressão de volta para os clientes.
+ *
+ * Os pedidos retidos ficam numa fila por ligação (socket) e são libertados
+ * em round-robin entre ligações, para que um cliente com muitos pedidos não
+ * consiga atrasar os restantes.
+ */
+
+/**
+ * @brief Retém um pedido RUN (PCB já criado) até haver capacidade
+ * @return 1 se o pedido ficou retido, 0 em caso de erro de memória
+ */
+int admission_park(pcb_t *task);
+
+/**
+ * @brief Retira o próximo pedido retido, alternando entre ligações
+ * @return O PCB do pedido, ou NULL se não houver pedidos retidos
+ */
+pcb_t *admission_next(void);
+
+/**
+ * @brief Descarta os pedidos retidos de uma ligação que foi fechada
+ */
+void admission_drop(uint32_t sockfd);
+
+/**
+ * @brief Número de pedidos retidos neste momento
+ */
+uint32_t admission_pending(void);
+
+/**
+ * @brief Descarta todos os pedidos retidos e liberta a memória (no fim)
+ */
+void admission_free(void);
+
+#endif //ADMISSION_H
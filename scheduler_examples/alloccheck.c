@@ -0,0 +1,135 @@
+#include "alloccheck.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <execinfo.h>
+
+/*
+ * Interposição de malloc/calloc/realloc/free (glibc): as funções abaixo
+ * substituem as da libc no executável scheduler-alloccheck e chamam as
+ * implementações originais (__libc_*) depois de contar a chamada.
+ * O simulador é single-threaded, por isso o estado não é protegido.
+ */
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+#define ALLOC_SITES 32      // locais diferentes guardados
+#define ALLOC_FRAMES 6      // profundidade do call stack de cada local
+
+typedef enum { OP_MALLOC = 0, OP_CALLOC, OP_REALLOC, OP_FREE, OP_COUNT } alloc_op_en;
+
+static const char *OP_NAMES[OP_COUNT] = {"malloc", "calloc", "realloc", "free"};
+static const char *PHASE_NAMES[ALLOC_PHASE_COUNT] = {"setup", "warm-up", "tick", "shutdown"};
+
+typedef struct {
+    void *frames[ALLOC_FRAMES];
+    int nframes;
+    alloc_op_en op;
+    unsigned long count;
+} alloc_site_t;
+
+static alloc_phase_en phase = ALLOC_PHASE_SETUP;
+static unsigned long counts[ALLOC_PHASE_COUNT][OP_COUNT];
+static alloc_site_t sites[ALLOC_SITES];
+static int nsites = 0;
+static unsigned long untracked = 0;   // chamadas em locais além de ALLOC_SITES
+static int in_hook = 0;               // o backtrace() pode ele próprio alocar
+
+#define SKIP_FRAMES 3        // record_site, count e a função interposta
+
+// Guarda o local da chamada
+static __attribute__((noinline)) void record_site(alloc_op_en op) {
+    void *frames[ALLOC_FRAMES + SKIP_FRAMES];
+    int n = backtrace(frames, ALLOC_FRAMES + SKIP_FRAMES) - SKIP_FRAMES;
+    if (n <= 0) return;
+    for (int i = 0; i < nsites; i++) {
+        if (sites[i].op == op && sites[i].nframes == n &&
+            !memcmp(sites[i].frames, frames + SKIP_FRAMES, (size_t)n * sizeof(void *))) {
+            sites[i].count++;
+            return;
+        }
+    }
+    if (nsites == ALLOC_SITES) {
+        untracked++;
+        return;
+    }
+    alloc_site_t *s = &sites[nsites++];
+    memcpy(s->frames, frames + SKIP_FRAMES, (size_t)n * sizeof(void *));
+    s->nframes = n;
+    s->op = op;
+    s->count = 1;
+}
+
+static __attribute__((noinline)) void count(alloc_op_en op) {
+    counts[phase][op]++;
+    if (phase != ALLOC_PHASE_TICK || in_hook) return;
+    in_hook = 1;
+    record_site(op);
+    in_hook = 0;
+}
+
+void *malloc(size_t size) {
+    count(OP_MALLOC);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+    count(OP_CALLOC);
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    count(OP_REALLOC);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    if (!ptr) return;
+    count(OP_FREE);
+    __libc_free(ptr);
+}
+
+void alloc_check_phase(alloc_phase_en p) {
+    if (phase == ALLOC_PHASE_SETUP && p != ALLOC_PHASE_SETUP) {
+        // A primeira chamada a backtrace() carrega a libgcc (e aloca):
+        // faz-se ainda no arranque para não contar como alocação do tick
+        void *frame;
+        in_hook = 1;
+        backtrace(&frame, 1);
+        in_hook = 0;
+    }
+    phase = p;
+}
+
+unsigned long alloc_check_report(FILE *out) {
+    alloc_phase_en saved = phase;
+    phase = ALLOC_PHASE_SHUTDOWN;
+
+    unsigned long in_tick = 0;
+    for (int op = 0; op < OP_COUNT; op++) in_tick += counts[ALLOC_PHASE_TICK][op];
+
+    fprintf(out, "---- Heap calls per phase ----\n");
+    fprintf(out, "%-10s %10s %10s %10s %10s\n", "phase", "malloc", "calloc", "realloc", "free");
+    for (int ph = 0; ph < ALLOC_PHASE_COUNT; ph++) {
+        fprintf(out, "%-10s", PHASE_NAMES[ph]);
+        for (int op = 0; op < OP_COUNT; op++) fprintf(out, " %10lu", counts[ph][op]);
+        fprintf(out, "\n");
+    }
+    if (in_tick == 0) {
+        fprintf(out, "Steady state: no heap calls in the tick\n");
+    } else {
+        fprintf(out, "Steady state: %lu heap calls in the tick, from %d call sites%s\n",
+                in_tick, nsites, untracked ? " (more not recorded)" : "");
+        for (int i = 0; i < nsites; i++) {
+            fprintf(out, "%lu x %s\n", sites[i].count, OP_NAMES[sites[i].op]);
+            fflush(out);
+            backtrace_symbols_fd(sites[i].frames, sites[i].nframes, fileno(out));
+        }
+    }
+    fflush(out);
+    phase = saved;
+    return in_tick;
+}
@@ -0,0 +1,50 @@
+#ifndef ALLOCCHECK_H
+#define ALLOCCHECK_H
+
+#include <stdio.h>
+
+/*
+ * Verificação de que o ciclo principal não usa a heap.
+ *
+ * Com a opção de CMake OSSIM_ALLOC_CHECK é criado o executável
+ * scheduler-alloccheck, em que malloc, calloc, realloc e free passam por
+ * contadores (ver alloccheck.c) marcados com a fase atual do simulador.
+ * Com --alloc-check MS, cada chamada feita num tick depois dos primeiros MS
+ * de simulação guarda o seu call stack, e no fim o simulador mostra os
+ * locais das chamadas e termina com erro. No executável normal estas
+ * funções não fazem nada.
+ */
+
+typedef enum {
+    ALLOC_PHASE_SETUP = 0,   // antes do ciclo principal
+    ALLOC_PHASE_WARMUP,      // ticks antes do fim do aquecimento
+    ALLOC_PHASE_TICK,        // ticks em regime estacionário (não pode alocar)
+    ALLOC_PHASE_SHUTDOWN,    // relatórios e limpeza final
+    ALLOC_PHASE_COUNT
+} alloc_phase_en;
+
+#ifdef OSSIM_ALLOC_CHECK
+
+/**
+ * @brief Muda a fase a que são atribuídas as chamadas seguintes
+ */
+void alloc_check_phase(alloc_phase_en phase);
+
+/**
+ * @brief Imprime as chamadas por fase e os locais das chamadas em regime estacionário
+ * @return Número de chamadas à heap feitas em ALLOC_PHASE_TICK
+ */
+unsigned long alloc_check_report(FILE *out);
+
+#define ALLOC_CHECK_AVAILABLE 1
+
+#else
+
+static inline void alloc_check_phase(alloc_phase_en phase) { (void)phase; }
+static inline unsigned long alloc_check_report(FILE *out) { (void)out; return 0; }
+
+#define ALLOC_CHECK_AVAILABLE 0
+
+#endif
+
+#endif //ALLOCCHECK_H
@@ -42,7 +42,9 @@ process_status_en handle_process_requests(int sockfd, const pid_t pid, const cha
     msg_t msg = {
         .pid = pid,
         .request = request,
-        .time_ms = (request == PROCESS_REQUEST_RUN)?burst->burst_time_ms:burst->block_time_ms
+        .time_ms = (request == PROCESS_REQUEST_RUN)?burst->burst_time_ms:burst->block_time_ms,
+        .nice = burst->nice,
+        .lock = burst->lock_id
     };
     // Send request
     if (write(sockfd, &msg, sizeof(msg_t)) != sizeof(msg_t)) {
@@ -86,13 +88,43 @@ process_status_en handle_process_requests(int sockfd, const pid_t pid, const cha
 }
 
 /*
- * Run like: ./app-pre <burst-file.csv>
+ * Asks for a CPU reservation of runtime_ms every period_ms (CBS). Returns 1 if
+ * it was admitted, 0 if the scheduler rejected it, -1 on errors.
+ */
+static int request_reservation(int sockfd, pid_t pid, uint32_t runtime_ms, uint32_t period_ms) {
+    msg_t msg = {
+        .pid = pid,
+        .request = PROCESS_REQUEST_RESERVE,
+        .time_ms = runtime_ms,
+        .period_ms = period_ms
+    };
+    if (write(sockfd, &msg, sizeof(msg_t)) != sizeof(msg_t)) {
+        perror("write");
+        return -1;
+    }
+    if (read(sockfd, &msg, sizeof(msg_t)) != sizeof(msg_t)) {
+        perror("read");
+        return -1;
+    }
+    return msg.request == PROCESS_REQUEST_ACK;
+}
+
+/*
+ * Run like: ./app-pre <burst-file.csv> [runtime_ms period_ms]
+ *
+ * With the optional pair, the bursts run under a reservation of runtime_ms
+ * every period_ms (best-effort if the scheduler rejects it).
  */
 int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        printf("Usage: %s <burst-file.csv>\n", argv[0]);
+    if (argc != 2 && argc != 4) {
+        printf("Usage: %s <burst-file.csv> [runtime_ms period_ms]\n", argv[0]);
         exit(EXIT_FAILURE);
     }
+    uint32_t runtime_ms = 0, period_ms = 0;
+    if (argc == 4) {
+        runtime_ms = (uint32_t)strtoul(argv[2], NULL, 10);
+        period_ms = (uint32_t)strtoul(argv[3], NULL, 10);
+    }
 
     // Parse arguments
     const char *burstfile_name = argv[1];
@@ -123,6 +155,15 @@ int main(int argc, char *argv[]) {
     }
 
     pid_t pid = getpid();
+    if (period_ms > 0) {
+        int rc = request_reservation(sockfd, pid, runtime_ms, period_ms);
+        if (rc < 0) {
+            close(sockfd);
+            return EXIT_FAILURE;
+        }
+        printf("Application %s (PID %d): reservation of %u ms every %u ms %s\n",
+               app_name, pid, runtime_ms, period_ms, rc ? "admitted" : "rejected, running best-effort");
+    }
     uint32_t sim_clock_ms = 0;              // Clock of the scheduler
 
     uint32_t start_time_ms = 0;             // Start time of the app
@@ -132,6 +173,13 @@ int main(int argc, char *argv[]) {
     burst_t *active_burst;
 
     while ((active_burst = dequeue_burst(&bursts)) != NULL) {
+        // Lock steps: LOCK returns (DONE) once the mutex is held
+        if (active_burst->kind != BURST_CPU) {
+            process_request_t request = (active_burst->kind == BURST_LOCK) ? PROCESS_REQUEST_LOCK : PROCESS_REQUEST_UNLOCK;
+            if (handle_process_requests(sockfd, pid, app_name, active_burst, request, &start_time_ms, &sim_clock_ms) == process_error)
+                break;
+            continue;
+        }
         if (handle_process_requests(sockfd, pid, app_name, active_burst, PROCESS_REQUEST_RUN, &start_time_ms, &sim_clock_ms) == process_error)
             break;
         cpu_duration_ms += active_burst->burst_time_ms;
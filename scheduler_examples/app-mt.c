@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "debug.h"
+
+#include "msg.h"
+#include "burst_queue.h"
+
+/*
+ * Multi-threaded application: every thread runs the same burst file, and all
+ * threads share the connection to the scheduler. Requests and replies carry
+ * the thread id, so several threads can be runnable (or blocked) at once.
+ */
+
+#define MAX_THREADS 32
+
+typedef struct {
+    uint32_t next;                  // index of the current burst
+    process_request_t phase;        // request in flight for the current burst
+    int finished;
+} thread_state_t;
+
+// First request of a burst: RUN for CPU bursts, LOCK/UNLOCK for lock steps
+static process_request_t step_request(const burst_t *b) {
+    if (b->kind == BURST_LOCK) return PROCESS_REQUEST_LOCK;
+    if (b->kind == BURST_UNLOCK) return PROCESS_REQUEST_UNLOCK;
+    return PROCESS_REQUEST_RUN;
+}
+
+static int send_request(int sockfd, pid_t pid, uint32_t tid, process_request_t request, const burst_t *b) {
+    msg_t msg = {
+        .pid = pid,
+        .tid = tid,
+        .request = request,
+        .time_ms = (request == PROCESS_REQUEST_BLOCK) ? b->block_time_ms : b->burst_time_ms,
+        .nice = b->nice,
+        .lock = b->lock_id
+    };
+    if (write(sockfd, &msg, sizeof(msg_t)) != sizeof(msg_t)) {
+        perror("write");
+        return -1;
+    }
+    DBG("Thread %u of PID %d sent %s request for %u ms",
+        tid, pid, PROCESS_REQUEST_STRINGS[request], msg.time_ms);
+    return 0;
+}
+
+/*
+ * Run like: ./app-mt <burst-file.csv> <threads>
+ */
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        printf("Usage: %s <burst-file.csv> <threads>\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    // Parse arguments
+    const char *burstfile_name = argv[1];
+    char *endptr;
+    errno = 0;
+    long nthreads = strtol(argv[2], &endptr, 10);
+    if (errno != 0 || *endptr != '\0' || nthreads < 1 || nthreads > MAX_THREADS) {
+        fprintf(stderr, "Invalid number of threads: %s (1..%d)\n", argv[2], MAX_THREADS);
+        return EXIT_FAILURE;
+    }
+
+    // Every thread replays the same bursts, so keep them in an array
+    burst_queue_t queue = {.head = NULL, .tail = NULL};
+    int nbursts = read_queue_from_file(&queue, burstfile_name);
+    if (nbursts <= 0) {
+        fprintf(stderr, "Failed to read burst file %s\n", burstfile_name);
+        return EXIT_FAILURE;
+    }
+    burst_t *bursts = malloc((size_t)nbursts * sizeof(burst_t));
+    if (!bursts) return EXIT_FAILURE;
+    for (int i = 0; i < nbursts; i++) {
+        burst_t *b = dequeue_burst(&queue);
+        bursts[i] = *b;
+        free(b);
+    }
+
+    // Setup socket for communication
+    int sockfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sockfd < 0) {
+        perror("socket");
+        return EXIT_FAILURE;
+    }
+
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, SOCKET_PATH, sizeof(addr.sun_path) - 1);
+
+    if (connect(sockfd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("connect");
+        close(sockfd);
+        return EXIT_FAILURE;
+    }
+
+    pid_t pid = getpid();
+    thread_state_t threads[MAX_THREADS] = {0};
+    uint32_t start_time_ms = 0;
+    int started = 0;
+    uint32_t sim_clock_ms = 0;
+    uint32_t cpu_duration_ms = 0;
+    uint32_t block_duration_ms = 0;
+
+    // All threads start at the same time
+    for (uint32_t t = 0; t < (uint32_t)nthreads; t++) {
+        threads[t].phase = step_request(&bursts[0]);
+        if (send_request(sockfd, pid, t, threads[t].phase, &bursts[0]) < 0) {
+            close(sockfd);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Replies for different threads can arrive in any order
+    long active = nthreads;
+    while (active > 0) {
+        msg_t msg;
+        if (read(sockfd, &msg, sizeof(msg_t)) != sizeof(msg_t)) {
+            perror("read");
+            close(sockfd);
+            return EXIT_FAILURE;
+        }
+        sim_clock_ms = msg.time_ms;
+        if (msg.tid >= (uint32_t)nthreads || threads[msg.tid].finished) {
+            printf("Received %s for unknown thread %u\n", PROCESS_REQUEST_STRINGS[msg.request], msg.tid);
+            continue;
+        }
+        if (msg.request == PROCESS_REQUEST_ACK) {
+            if (!started) {
+                started = 1;
+                start_time_ms = msg.time_ms;
+            }
+            continue;
+        }
+        if (msg.request != PROCESS_REQUEST_DONE) {
+            printf("Received invalid request. Expected ACK or DONE, received %s\n",
+                   PROCESS_REQUEST_STRINGS[msg.request]);
+            continue;
+        }
+
+        // DONE: move this thread to its next request
+        thread_state_t *th = &threads[msg.tid];
+        burst_t *b = &bursts[th->next];
+        int rc = 0;
+        if (th->phase == PROCESS_REQUEST_RUN) {
+            cpu_duration_ms += b->burst_time_ms;
+            if (b->block_time_ms > 0) {
+                th->phase = PROCESS_REQUEST_BLOCK;
+                rc = send_request(sockfd, pid, msg.tid, PROCESS_REQUEST_BLOCK, b);
+                if (rc < 0) break;
+                continue;
+            }
+        } else if (th->phase == PROCESS_REQUEST_BLOCK) {
+            block_duration_ms += b->block_time_ms;
+        }
+        if (++th->next < (uint32_t)nbursts) {
+            th->phase = step_request(&bursts[th->next]);
+            rc = send_request(sockfd, pid, msg.tid, th->phase, &bursts[th->next]);
+            if (rc < 0) break;
+        } else {
+            th->finished = 1;
+            active--;
+            DBG("Thread %u of PID %d finished at time %u ms", msg.tid, pid, msg.time_ms);
+        }
+    }
+
+    // All threads finished, print stats (CPU and BLOCKED are summed over the threads)
+    double real = (sim_clock_ms - start_time_ms)/1000.0;
+    double user = (double)cpu_duration_ms/1000.0;
+    double sys = (double)block_duration_ms/1000.0;
+
+    printf("Application %s (PID %d, %ld threads) finished at time %u ms, Elapsed: %.03f seconds, CPU: %.03f seconds, BLOCKED: %.03f seconds, Parallelism: %.02f\n",
+           burstfile_name, pid, nthreads, sim_clock_ms, real, user, sys, real > 0 ? user / real : 0.0);
+
+    close(sockfd);
+    free(bursts);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <limits.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "debug.h"
+
+#include "msg.h"
+
+/*
+ * Periodic real-time application: a single PERIODIC request declares the
+ * task, and the scheduler releases one job every period on its own. The
+ * application only counts the DONE replies (one per job) and checks each
+ * job against its deadline.
+ */
+
+#define DEFAULT_JOBS 10
+
+/*
+ * Parses a non-negative integer argument, returns -1 on error
+ */
+static long parse_arg(const char *arg) {
+    char *endptr;
+    errno = 0;
+    long val = strtol(arg, &endptr, 10);
+    if (errno != 0 || *endptr != '\0' || val < 0 || val > INT_MAX) {
+        fprintf(stderr, "Invalid number: %s\n", arg);
+        return -1;
+    }
+    return val;
+}
+
+/*
+ * Run like: ./app-rt <name> <period_ms> <cost_ms> [deadline_ms] [jobs]
+ *
+ * Periods and deadlines must be multiples of the scheduler tick, with the
+ * deadline (default: the period) no longer than the period.
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 4 || argc > 6) {
+        printf("Usage: %s <name> <period_ms> <cost_ms> [deadline_ms] [jobs]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    const char *app_name = argv[1];
+    long period = parse_arg(argv[2]);
+    long cost = parse_arg(argv[3]);
+    long deadline = argc >= 5 ? parse_arg(argv[4]) : 0;
+    long jobs = argc == 6 ? parse_arg(argv[5]) : DEFAULT_JOBS;
+    if (period < 0 || cost < 0 || deadline < 0 || jobs < 0) return EXIT_FAILURE;
+    if (deadline == 0) deadline = period;
+    if (cost == 0 || jobs == 0 || period % TICKS_MS != 0 || deadline % TICKS_MS != 0 ||
+        deadline > period) {
+        fprintf(stderr, "Need cost > 0, jobs > 0, and period, deadline multiples of %d ms with deadline <= period\n",
+                TICKS_MS);
+        return EXIT_FAILURE;
+    }
+
+    // Setup socket for communication
+    int sockfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sockfd < 0) {
+        perror("socket");
+        return EXIT_FAILURE;
+    }
+
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, SOCKET_PATH, sizeof(addr.sun_path) - 1);
+
+    if (connect(sockfd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("connect");
+        close(sockfd);
+        return EXIT_FAILURE;
+    }
+
+    pid_t pid = getpid();
+    msg_t msg = {
+        .pid = pid,
+        .request = PROCESS_REQUEST_PERIODIC,
+        .time_ms = (uint32_t)cost,
+        .period_ms = (uint32_t)period,
+        .deadline_ms = (uint32_t)deadline,
+        .jobs = (uint32_t)jobs
+    };
+    if (write(sockfd, &msg, sizeof(msg_t)) != sizeof(msg_t)) {
+        perror("write");
+        close(sockfd);
+        return EXIT_FAILURE;
+    }
+    DBG("Application %s (PID %d) declared a periodic task: C=%ld T=%ld D=%ld",
+        app_name, pid, cost, period, deadline);
+
+    // The ACK carries the release time of the first job
+    if (read(sockfd, &msg, sizeof(msg_t)) != sizeof(msg_t)) {
+        perror("read");
+        close(sockfd);
+        return EXIT_FAILURE;
+    }
+    if (msg.request != PROCESS_REQUEST_ACK) {
+        printf("Received invalid request. Expected ACK\n");
+        close(sockfd);
+        return EXIT_FAILURE;
+    }
+    uint32_t first_release_ms = msg.time_ms;
+
+    // Jobs of one task complete in release order (same priority, FIFO among equals)
+    uint32_t worst_ms = 0;
+    long misses = 0;
+    for (long k = 0; k < jobs; k++) {
+        if (read(sockfd, &msg, sizeof(msg_t)) != sizeof(msg_t)) {
+            perror("read");
+            close(sockfd);
+            return EXIT_FAILURE;
+        }
+        if (msg.request != PROCESS_REQUEST_DONE) {
+            printf("Received invalid request. Expected DONE, received %s\n",
+                   PROCESS_REQUEST_STRINGS[msg.request]);
+            continue;
+        }
+        uint32_t release_ms = first_release_ms + (uint32_t)(k * period);
+        uint32_t response_ms = msg.time_ms - release_ms;
+        if (response_ms > worst_ms) worst_ms = response_ms;
+        if (response_ms > (uint32_t)deadline) misses++;
+        DBG("Job %ld of %s released at %u ms finished at %u ms", k, app_name, release_ms, msg.time_ms);
+    }
+
+    printf("Application %s (PID %d) finished at time %u ms, Jobs: %ld, Worst response: %u ms, Deadline misses: %ld\n",
+           app_name, pid, msg.time_ms, jobs, worst_ms, misses);
+
+    close(sockfd);
+    return EXIT_SUCCESS;
+}
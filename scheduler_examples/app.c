@@ -12,33 +12,58 @@
 #include "msg.h"
 
 /*
- * Run like: ./app <name> <time_s>
+ * Parses a non-negative integer argument, returns -1 on error
  */
-int main(int argc, char *argv[]) {
-    if (argc != 3) {
-        printf("Usage: %s <name> <time_s>\n", argv[0]);
-        exit(EXIT_FAILURE);
-    }
-
-    // Parse arguments
-    const char *app_name = argv[1];
+static long parse_arg(const char *arg) {
     char *endptr;
     errno = 0;
-    long val = strtol(argv[2], &endptr, 10);
+    long val = strtol(arg, &endptr, 10);
     if (errno != 0) {
         perror("strtol");  // conversion error (overflow, etc.)
-        return 1;
+        return -1;
     }
     if (*endptr != '\0') {
-        fprintf(stderr, "Invalid number: %s\n", argv[2]);
-        return 1;
+        fprintf(stderr, "Invalid number: %s\n", arg);
+        return -1;
     }
     if (val < 0 || val > INT_MAX) {  // optional range check
         fprintf(stderr, "Value out of range: %ld\n", val);
-        return 1;
+        return -1;
+    }
+    return val;
+}
+
+/*
+ * Run like: ./app <name> <time_s> [cpus] [estimate_s]
+ *
+ * The optional arguments describe a batch job (BATCH scheduler): the number
+ * of CPUs it needs at the same time and its declared walltime.
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 3 || argc > 5) {
+        printf("Usage: %s <name> <time_s> [cpus] [estimate_s]\n", argv[0]);
+        exit(EXIT_FAILURE);
     }
+
+    // Parse arguments
+    const char *app_name = argv[1];
+    long val = parse_arg(argv[2]);
+    if (val < 0) return 1;
     int32_t time_s = (int32_t) val;
 
+    uint32_t cpus = 1;
+    uint32_t estimate_s = (uint32_t) time_s;
+    if (argc >= 4) {
+        val = parse_arg(argv[3]);
+        if (val < 1) return 1;
+        cpus = (uint32_t) val;
+    }
+    if (argc == 5) {
+        val = parse_arg(argv[4]);
+        if (val < 0) return 1;
+        estimate_s = (uint32_t) val;
+    }
+
     // Setup socket for communication
     int sockfd = socket(AF_UNIX, SOCK_STREAM, 0);
     if (sockfd < 0) {
@@ -64,7 +89,9 @@ int main(int argc, char *argv[]) {
     msg_t msg = {
         .pid = pid,
         .request = PROCESS_REQUEST_RUN,
-        .time_ms = time_s * 1000
+        .time_ms = time_s * 1000,
+        .cpus = cpus,
+        .estimate_ms = estimate_s * 1000
     };
     if (write(sockfd, &msg, sizeof(msg_t)) != sizeof(msg_t)) {
         perror("write");
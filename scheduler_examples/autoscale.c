@@ -0,0 +1,127 @@
+#include "autoscale.h"
+#include "stats.h"
+#include "psi.h"
+
+/**
+ * Controlador de target tracking
+ *
+ * Os sinais vêm dos totais que o stats e o psi já acumulam (tempo de CPU
+ * ocupado e tempo com pressão de CPU): em cada janela só se tira a
+ * diferença. Os CPU-segundos provisionados somam-se em cada mudança.
+ */
+
+static autoscale_signal_en signal_type = AUTOSCALE_OFF;
+static uint32_t target = 0;
+static int min_cpus = 1;
+static int max_cpus = 1;
+static uint32_t cooldown_out_ms = AUTOSCALE_COOLDOWN_OUT_MS;
+static uint32_t cooldown_in_ms = AUTOSCALE_COOLDOWN_IN_MS;
+
+static uint32_t next_eval_ms = AUTOSCALE_WINDOW_MS;
+static uint64_t window_busy_ms = 0;        // stats_cpu_busy_ms() no início da janela
+static uint64_t window_stall_us = 0;       // pressão cpu some no início da janela
+static uint32_t last_out_ms = 0;
+static uint32_t last_change_ms = 0;
+static int have_out = 0;                   // já houve alguma subida
+static int have_change = 0;
+
+static int cur_online = 1;
+static int seen_min = 1;
+static int seen_max = 1;
+static uint64_t provisioned_ms = 0;        // Σ online × tempo (CPU-ms)
+static uint32_t provisioned_since_ms = 0;
+static uint32_t scale_outs = 0;
+static uint32_t scale_ins = 0;
+
+void autoscale_set_signal(autoscale_signal_en signal) {
+    signal_type = signal;
+}
+
+void autoscale_set_target(uint32_t percent) {
+    target = percent;
+}
+
+void autoscale_set_min(int cpus) {
+    min_cpus = cpus;
+}
+
+void autoscale_set_cooldowns(uint32_t out_ms, uint32_t in_ms) {
+    cooldown_out_ms = out_ms;
+    cooldown_in_ms = in_ms;
+}
+
+int autoscale_enabled(void) {
+    return signal_type != AUTOSCALE_OFF;
+}
+
+int autoscale_start(int cpus) {
+    max_cpus = cpus;
+    if (min_cpus > max_cpus) min_cpus = max_cpus;
+    if (target == 0) target = signal_type == AUTOSCALE_PSI ? AUTOSCALE_PSI_TARGET : AUTOSCALE_UTIL_TARGET;
+    cur_online = seen_min = seen_max = min_cpus;
+    return min_cpus;
+}
+
+// Sinal da janela que acaba agora, em %
+static double window_signal(int online) {
+    if (signal_type == AUTOSCALE_UTIL) {
+        uint64_t busy = stats_cpu_busy_ms();
+        double v = 100.0 * (double)(busy - window_busy_ms) / ((double)online * AUTOSCALE_WINDOW_MS);
+        window_busy_ms = busy;
+        return v;
+    }
+    double avg[3];
+    uint64_t stall_us;
+    psi_pressure(PSI_CPU, 0, avg, &stall_us);
+    double v = 100.0 * (double)(stall_us - window_stall_us) / (AUTOSCALE_WINDOW_MS * 1000.0);
+    window_stall_us = stall_us;
+    return v;
+}
+
+int autoscale_tick(uint32_t now_ms, int online) {
+    if (now_ms < next_eval_ms) return online;
+    next_eval_ms += AUTOSCALE_WINDOW_MS;
+
+    double signal = window_signal(online);
+    // Arredonda para cima: uma fração de CPU em falta já pede mais um
+    int desired = (int)((online * signal + target - 1e-9) / target);
+    if (desired < min_cpus) desired = min_cpus;
+    if (desired > max_cpus) desired = max_cpus;
+
+    int next = online;
+    if (desired > online && (!have_out || now_ms - last_out_ms >= cooldown_out_ms)) {
+        next = desired;
+        last_out_ms = now_ms;
+        have_out = 1;
+        scale_outs++;
+    } else if (desired < online && (!have_change || now_ms - last_change_ms >= cooldown_in_ms)) {
+        next = online - 1;
+        scale_ins++;
+    }
+    if (next == online) return online;
+
+    provisioned_ms += (uint64_t)cur_online * (now_ms - provisioned_since_ms);
+    provisioned_since_ms = now_ms;
+    cur_online = next;
+    if (next < seen_min) seen_min = next;
+    if (next > seen_max) seen_max = next;
+    last_change_ms = now_ms;
+    have_change = 1;
+    return next;
+}
+
+void autoscale_report(FILE *out, uint32_t now_ms) {
+    if (!autoscale_enabled()) return;
+    uint64_t provisioned = provisioned_ms + (uint64_t)cur_online * (now_ms - provisioned_since_ms);
+    uint64_t busy = stats_cpu_busy_ms();
+    fprintf(out, "---- Autoscaling (%s target %u %%, %d..%d CPUs, cooldown out %u ms / in %u ms) ----\n",
+            signal_type == AUTOSCALE_UTIL ? "util" : "cpu pressure", target, min_cpus, max_cpus,
+            cooldown_out_ms, cooldown_in_ms);
+    fprintf(out, "Online CPUs:          mean %.2f, min %d, max %d, now %d (%u scale-outs, %u scale-ins)\n",
+            now_ms ? (double)provisioned / now_ms : 0.0, seen_min, seen_max, cur_online,
+            scale_outs, scale_ins);
+    fprintf(out, "CPU-seconds:          %.2f provisioned (%.2f with %d static CPUs), %.2f busy (%.1f %%)\n",
+            provisioned / 1000.0, (double)now_ms * max_cpus / 1000.0, max_cpus, busy / 1000.0,
+            provisioned ? 100.0 * busy / provisioned : 0.0);
+    fflush(out);
+}
@@ -0,0 +1,83 @@
+#ifndef AUTOSCALE_H
+#define AUTOSCALE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Autoscaling dos CPUs simulados (modo SMP com políticas de um CPU).
+ *
+ * Com --autoscale o simulador começa com --as-min CPUs online e, a cada
+ * AUTOSCALE_WINDOW_MS, um controlador de target tracking compara um sinal
+ * medido na janela com o alvo e calcula a capacidade desejada:
+ *
+ *     desejados = ceil(online × sinal / alvo), limitado a [min, --cpus]
+ *
+ * O sinal é a utilização dos CPUs online (util) ou a fração de tempo com
+ * tarefas à espera de CPU, a pressão "cpu some" (psi, ver psi.h). Sobe-se
+ * logo para os CPUs desejados, desce-se um CPU de cada vez, e cada sentido
+ * tem o seu cooldown: depois de subir não se volta a subir antes de
+ * --as-cooldown-out ms e depois de qualquer mudança não se desce antes de
+ * --as-cooldown-in ms.
+ *
+ * Os CPUs online são sempre os primeiros; quando um CPU sai, a tarefa que
+ * lá estava volta à fila de prontos (migra para outro CPU).
+ */
+
+#define AUTOSCALE_WINDOW_MS 1000            // período de avaliação do controlador
+#define AUTOSCALE_UTIL_TARGET 70            // alvo por omissão do sinal util (%)
+#define AUTOSCALE_PSI_TARGET 20             // alvo por omissão do sinal psi (%)
+#define AUTOSCALE_COOLDOWN_OUT_MS 1000
+#define AUTOSCALE_COOLDOWN_IN_MS 5000
+
+typedef enum {
+    AUTOSCALE_OFF = 0,
+    AUTOSCALE_UTIL,
+    AUTOSCALE_PSI
+} autoscale_signal_en;
+
+/**
+ * @brief Escolhe o sinal do controlador (AUTOSCALE_OFF desliga o autoscaling)
+ */
+void autoscale_set_signal(autoscale_signal_en signal);
+
+/**
+ * @brief Valor alvo do sinal, em % (0 = o alvo por omissão do sinal)
+ */
+void autoscale_set_target(uint32_t percent);
+
+/**
+ * @brief Mínimo de CPUs online (também é o número inicial)
+ */
+void autoscale_set_min(int min_cpus);
+
+/**
+ * @brief Cooldowns depois de subir (out) e antes de descer (in), em ms
+ */
+void autoscale_set_cooldowns(uint32_t out_ms, uint32_t in_ms);
+
+/**
+ * @brief Indica se o autoscaling está ligado
+ */
+int autoscale_enabled(void);
+
+/**
+ * @brief CPUs online no arranque, com max_cpus CPUs na máquina
+ */
+int autoscale_start(int max_cpus);
+
+/**
+ * @brief Avalia o controlador no fim de cada janela
+ *
+ * Deve ser chamada em cada tick, antes de stats_cpu_tick(), com os CPUs
+ * online atuais.
+ * @return CPUs online a partir deste tick
+ */
+int autoscale_tick(uint32_t now_ms, int online);
+
+/**
+ * @brief Imprime as decisões do controlador e os CPU-segundos provisionados
+ */
+void autoscale_report(FILE *out, uint32_t now_ms);
+
+#endif //AUTOSCALE_H
@@ -0,0 +1,197 @@
+#include "batch.h"
+#include "msg.h"
+#include "stats.h"
+#include "channel.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+/**
+ * Escalonador BATCH com backfilling (EASY ou conservativo)
+ *
+ * O estado da máquina é descrito por um "perfil" de disponibilidade:
+ * uma sequência de degraus (instante, CPUs livres a partir desse instante),
+ * construída a partir dos jobs em execução e dos respetivos walltimes.
+ *
+ * Para cada job da fila (por ordem de chegada) procura-se o primeiro instante
+ * em que há CPUs suficientes durante todo o walltime declarado:
+ *  - se esse instante é "agora", o job arranca (e ocupa o perfil);
+ *  - senão, recebe uma reserva no perfil. Em modo EASY só o primeiro job
+ *    bloqueado recebe reserva; em modo conservativo todos recebem.
+ * Assim um job mais pequeno só passa à frente se não atrasar nenhuma reserva.
+ */
+
+// Degrau do perfil de disponibilidade
+typedef struct {
+    uint32_t time_ms;   // a partir deste instante...
+    int free;           // ...estão livres estes CPUs
+} step_t;
+
+static batch_backfill_en backfill_mode = BACKFILL_EASY;
+
+// Jobs em execução (cada um pode ocupar vários CPUs)
+static queue_t running = {.head = NULL, .tail = NULL};
+
+// Perfil reutilizado entre ticks (só cresce)
+static step_t *profile = NULL;
+static int profile_len = 0;
+static int profile_cap = 0;
+
+void batch_set_backfill(batch_backfill_en mode) {
+    backfill_mode = mode;
+}
+
+// Número de CPUs do job, limitado ao tamanho da máquina
+static int job_cpus(const pcb_t *job, int ncpus) {
+    int k = job->cpus ? (int)job->cpus : 1;
+    return k > ncpus ? ncpus : k;
+}
+
+// Walltime restante previsto. Um job que excede a estimativa
+// é tratado como estando a terminar no próximo tick.
+static uint32_t job_remaining(const pcb_t *job) {
+    uint32_t est = job->estimate_ms ? job->estimate_ms : job->time_ms;
+    if (job->ellapsed_time_ms >= est) return TICKS_MS;
+    return est - job->ellapsed_time_ms;
+}
+
+static int profile_reserve_room(int n) {
+    if (n <= profile_cap) return 0;
+    int cap = profile_cap ? profile_cap : 16;
+    while (cap < n) cap *= 2;
+    step_t *p = realloc(profile, (size_t)cap * sizeof(step_t));
+    if (!p) return -1;
+    profile = p;
+    profile_cap = cap;
+    return 0;
+}
+
+// Devolve o índice do degrau que começa em t, criando-o se necessário
+static int profile_split(uint32_t t) {
+    int i = 0;
+    while (i < profile_len && profile[i].time_ms < t) i++;
+    if (i < profile_len && profile[i].time_ms == t) return i;
+    // O novo degrau herda os CPUs livres do degrau anterior
+    if (profile_reserve_room(profile_len + 1) < 0) return -1;
+    for (int j = profile_len; j > i; j--) profile[j] = profile[j - 1];
+    profile[i].time_ms = t;
+    profile[i].free = profile[i - 1].free;
+    profile_len++;
+    return i;
+}
+
+// Ocupa k CPUs no intervalo [t, t + dur)
+static void profile_take(uint32_t t, uint32_t dur, int k) {
+    int first = profile_split(t);
+    int last = profile_split(t + dur);
+    if (first < 0 || last < 0) return;
+    for (int i = first; i < last; i++) profile[i].free -= k;
+}
+
+// Primeiro instante em que k CPUs estão livres durante dur ms
+static uint32_t profile_find(int k, uint32_t dur) {
+    for (int i = 0; i < profile_len; i++) {
+        uint32_t start = profile[i].time_ms;
+        int ok = 1;
+        for (int j = i; j < profile_len && profile[j].time_ms < start + dur; j++) {
+            if (profile[j].free < k) { ok = 0; break; }
+        }
+        if (ok) return start;
+    }
+    return profile[profile_len - 1].time_ms; // último degrau: máquina vazia
+}
+
+// Constrói o perfil a partir dos jobs em execução
+static int profile_build(uint32_t now, int ncpus) {
+    int nrun = 0;
+    for (queue_elem_t *it = running.head; it; it = it->next) nrun++;
+    if (profile_reserve_room(nrun + 1) < 0) return -1;
+
+    profile_len = 1;
+    profile[0].time_ms = now;
+    profile[0].free = ncpus;
+    for (queue_elem_t *it = running.head; it; it = it->next) {
+        // O job ocupa os seus CPUs de agora até ao fim previsto
+        int k = job_cpus(it->pcb, ncpus);
+        int i = profile_split(now + job_remaining(it->pcb));
+        if (i < 0) return -1;
+        for (int j = 0; j < i; j++) profile[j].free -= k;
+    }
+    return 0;
+}
+
+// Atribui k CPUs livres ao job e coloca-o em execução
+static void start_job(pcb_t *job, int k, pcb_t **cpu_tasks, int ncpus) {
+    for (int c = 0; c < ncpus && k > 0; c++) {
+        if (cpu_tasks[c] == NULL) {
+            cpu_tasks[c] = job;
+            k--;
+        }
+    }
+    enqueue_pcb(&running, job);
+}
+
+void batch_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_tasks, int ncpus) {
+    // 1) Avança os jobs em execução e liberta os que terminaram
+    queue_elem_t *it = running.head;
+    while (it) {
+        pcb_t *job = it->pcb;
+        job->ellapsed_time_ms += TICKS_MS;
+        if (job->ellapsed_time_ms < job->time_ms) {
+            it = it->next;
+            continue;
+        }
+
+        // O job terminou → envia DONE e liberta os seus CPUs
+        msg_t msg = {
+            .pid = job->pid,
+            .tid = job->tid,
+            .request = PROCESS_REQUEST_DONE,
+            .time_ms = current_time_ms
+        };
+        if (channel_send(job->sockfd, &msg) < 0) {
+            perror("write");
+        }
+        for (int c = 0; c < ncpus; c++) {
+            if (cpu_tasks[c] == job) cpu_tasks[c] = NULL;
+        }
+        stats_burst_done(job, current_time_ms);
+
+        queue_elem_t *done = it;
+        it = it->next;
+        queue_elem_t *removed = remove_queue_elem(&running, done);
+        if (removed) {
+            free_pcb(removed->pcb);
+            free_queue_elem(removed);
+        }
+    }
+
+    if (rq->head == NULL) return;
+
+    // 2) Percorre a fila por ordem de chegada: arranca, reserva ou salta
+    if (profile_build(current_time_ms, ncpus) < 0) return;
+    int reservations = 0;
+    it = rq->head;
+    while (it) {
+        pcb_t *job = it->pcb;
+        int k = job_cpus(job, ncpus);
+        uint32_t dur = job_remaining(job);
+        uint32_t start = profile_find(k, dur);
+
+        if (start == current_time_ms) {
+            profile_take(start, dur, k);
+            queue_elem_t *next = it->next;
+            queue_elem_t *removed = remove_queue_elem(rq, it);
+            if (removed) {
+                start_job(job, k, cpu_tasks, ncpus);
+                free_queue_elem(removed);
+            }
+            it = next;
+            continue;
+        }
+        if (backfill_mode == BACKFILL_CONSERVATIVE || reservations == 0) {
+            profile_take(start, dur, k);
+            reservations++;
+        }
+        it = it->next;
+    }
+}
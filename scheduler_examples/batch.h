@@ -0,0 +1,30 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "queue.h"
+
+// Modos de backfilling do escalonador BATCH
+typedef enum {
+    BACKFILL_EASY = 0,      // só o primeiro job em espera tem reserva
+    BACKFILL_CONSERVATIVE   // todos os jobs em espera têm reserva
+} batch_backfill_en;
+
+/**
+ * @brief Escolhe o modo de backfilling (por omissão EASY)
+ */
+void batch_set_backfill(batch_backfill_en mode);
+
+/**
+ * @brief Escalonador de jobs batch (HPC) numa máquina SMP simulada
+ *
+ * Cada job pede p->cpus CPUs em simultâneo e declara um walltime estimado
+ * (p->estimate_ms). Os jobs arrancam por ordem de chegada; quando o primeiro
+ * não cabe, recebe uma reserva e os jobs seguintes só passam à frente
+ * (backfilling) se não atrasarem essa reserva.
+ *
+ * Um job em execução ocupa todas as entradas de cpu_tasks que lhe foram
+ * atribuídas (o mesmo ponteiro em cada uma).
+ */
+void batch_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_tasks, int ncpus);
+
+#endif //BATCH_H
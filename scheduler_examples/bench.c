@@ -0,0 +1,369 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/wait.h>
+
+/*
+ * ossim-bench: runs every scenario in a directory (workflow manifests, *.wf)
+ * under every policy, in virtual time, and compares the results with a JSON
+ * baseline. It exits with an error if a metric, or the wall-clock time of
+ * the simulator, got worse than the baseline by more than the tolerance.
+ *
+ * The baseline is written by this tool with one run per line, so it is read
+ * back line by line without a full JSON parser.
+ *
+ * Run like: ./ossim-bench [options] <scenario-dir>   (see usage())
+ * or through the scenario-bench / scenario-bench-update CMake targets.
+ */
+
+#define MAX_RUNS 256
+#define TIME_SLACK_MS 5.0      // wall-clock differences below this are noise
+
+static const char *POLICIES[] = {"FIFO", "SJF", "RR", "MLFQ", "BATCH", "HEFT", "GANG", "PRIO", "LOOKAHEAD"};
+#define NPOLICIES (sizeof(POLICIES) / sizeof(POLICIES[0]))
+
+static int perf = 0;           // --perf: pass it on and show the counters
+
+// Metrics read from the simulator output; lower is better unless stated
+static const struct {
+    const char *key;           // name in the baseline
+    const char *prefix;        // line of the simulator output
+    const char *format;        // sscanf format after the prefix
+    int higher_is_better;
+} METRICS[] = {
+    {"makespan_ms", "Makespan:",             " %lf", 0},
+    {"latency_ms",  "Latency (RUN->DONE):",  " mean %lf", 0},
+    {"wait_ms",     "Wait (RUN->dispatch):", " mean %lf", 0},
+    {"bsld",        "Bounded slowdown:",     " mean %lf", 0},
+    {"cpu_util",    "CPU utilization:",      " %lf", 1},
+};
+#define NMETRICS (sizeof(METRICS) / sizeof(METRICS[0]))
+
+typedef struct {
+    char scenario[64];
+    char policy[16];
+    double metric[NMETRICS];   // same order as METRICS
+    double runtime_ms;         // best wall-clock time of the simulator
+} bench_run_t;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static int by_name(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/**
+ * Lists the *.wf files of dir (sorted by name, without the extension)
+ * @return Number of scenarios, or -1 on error
+ */
+static int list_scenarios(const char *dir, char ***out) {
+    DIR *d = opendir(dir);
+    if (!d) {
+        perror(dir);
+        return -1;
+    }
+    char **names = NULL;
+    int n = 0;
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL) {
+        size_t len = strlen(e->d_name);
+        if (len <= 3 || strcmp(e->d_name + len - 3, ".wf") != 0) continue;
+        char **tmp = realloc(names, (size_t)(n + 1) * sizeof(char *));
+        if (!tmp) break;
+        names = tmp;
+        names[n] = strndup(e->d_name, len - 3);
+        if (names[n]) n++;
+    }
+    closedir(d);
+    qsort(names, (size_t)n, sizeof(char *), by_name);
+    *out = names;
+    return n;
+}
+
+/**
+ * Runs one scenario under one policy and parses the summary of the simulator
+ * (with echo_perf, the perf counter table of the run is copied to stdout)
+ * @return 0 on success, -1 if the simulator failed or a metric is missing
+ */
+static int run_once(const char *scheduler, const char *dir, int cpus, bench_run_t *r, int echo_perf) {
+    char cmd[PATH_MAX * 2 + 128];
+    snprintf(cmd, sizeof(cmd), "'%s' %s --cpus %d%s --workflow '%s/%s.wf' 2>&1",
+             scheduler, r->policy, cpus, perf ? " --perf" : "", dir, r->scenario);
+
+    double start = now_ms();
+    FILE *p = popen(cmd, "r");
+    if (!p) {
+        perror("popen");
+        return -1;
+    }
+    int found[NMETRICS] = {0};
+    int in_perf = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), p)) {
+        if (!strncmp(line, "----", 4)) in_perf = !strncmp(line, "---- Perf counters", 18);
+        if (echo_perf && (in_perf || !strncmp(line, "Perf events", 11))) {
+            if (in_perf && !strncmp(line, "----", 4)) printf("%s %s:\n", r->scenario, r->policy);
+            else printf("  %s", line);
+        }
+        for (size_t m = 0; m < NMETRICS; m++) {
+            size_t len = strlen(METRICS[m].prefix);
+            if (strncmp(line, METRICS[m].prefix, len) == 0 &&
+                sscanf(line + len, METRICS[m].format, &r->metric[m]) == 1) {
+                found[m] = 1;
+            }
+        }
+    }
+    int status = pclose(p);
+    double elapsed = now_ms() - start;
+    if (r->runtime_ms == 0.0 || elapsed < r->runtime_ms) r->runtime_ms = elapsed;
+
+    if (status == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "%s %s: simulator failed (%s)\n", r->scenario, r->policy, cmd);
+        return -1;
+    }
+    for (size_t m = 0; m < NMETRICS; m++) {
+        if (!found[m]) {
+            fprintf(stderr, "%s %s: no '%s' in the simulator output\n",
+                    r->scenario, r->policy, METRICS[m].prefix);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Finds "key": in a baseline line and returns what follows it
+static const char *json_value(const char *line, const char *key) {
+    char pat[64];
+    snprintf(pat, sizeof(pat), "\"%s\":", key);
+    const char *v = strstr(line, pat);
+    if (!v) return NULL;
+    v += strlen(pat);
+    while (*v == ' ') v++;
+    return v;
+}
+
+static int json_string(const char *line, const char *key, char *out, size_t len) {
+    const char *v = json_value(line, key);
+    if (!v || *v != '"') return -1;
+    const char *end = strchr(++v, '"');
+    if (!end) return -1;
+    snprintf(out, len, "%.*s", (int)(end - v), v);
+    return 0;
+}
+
+static int json_number(const char *line, const char *key, double *out) {
+    const char *v = json_value(line, key);
+    if (!v) return -1;
+    char *end;
+    *out = strtod(v, &end);
+    return end == v ? -1 : 0;
+}
+
+/**
+ * Reads a baseline written by write_baseline()
+ * @return Number of runs, or -1 if the file cannot be read
+ */
+static int read_baseline(const char *path, bench_run_t *runs, int max) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    int n = 0;
+    char line[1024];
+    while (n < max && fgets(line, sizeof(line), f)) {
+        bench_run_t *r = &runs[n];
+        memset(r, 0, sizeof(*r));
+        if (json_string(line, "scenario", r->scenario, sizeof(r->scenario)) < 0 ||
+            json_string(line, "policy", r->policy, sizeof(r->policy)) < 0 ||
+            json_number(line, "runtime_ms", &r->runtime_ms) < 0) {
+            continue;
+        }
+        int ok = 1;
+        for (size_t m = 0; m < NMETRICS; m++) {
+            if (json_number(line, METRICS[m].key, &r->metric[m]) < 0) ok = 0;
+        }
+        if (ok) n++;
+    }
+    fclose(f);
+    return n;
+}
+
+static int write_baseline(const char *path, const bench_run_t *runs, int n, int cpus) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "{\n  \"cpus\": %d,\n  \"runs\": [\n", cpus);
+    for (int i = 0; i < n; i++) {
+        fprintf(f, "    {\"scenario\": \"%s\", \"policy\": \"%s\"", runs[i].scenario, runs[i].policy);
+        for (size_t m = 0; m < NMETRICS; m++) {
+            fprintf(f, ", \"%s\": %.2f", METRICS[m].key, runs[i].metric[m]);
+        }
+        fprintf(f, ", \"runtime_ms\": %.2f}%s\n", runs[i].runtime_ms, i + 1 < n ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    return fclose(f);
+}
+
+static const bench_run_t *find_run(const bench_run_t *runs, int n, const bench_run_t *r) {
+    for (int i = 0; i < n; i++) {
+        if (!strcmp(runs[i].scenario, r->scenario) && !strcmp(runs[i].policy, r->policy)) return &runs[i];
+    }
+    return NULL;
+}
+
+// Relative change in %, positive when the run got worse
+static double regression_pct(double base, double now, int higher_is_better) {
+    double diff = higher_is_better ? base - now : now - base;
+    if (base == 0.0) return diff > 0.0 ? 100.0 : 0.0;
+    return 100.0 * diff / base;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [options] <scenario-dir>\n", prog);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  --scheduler P         simulator to run (default ./scheduler)\n");
+    fprintf(stderr, "  --baseline F          JSON baseline (default <scenario-dir>/baseline.json)\n");
+    fprintf(stderr, "  --update              write the results as the new baseline\n");
+    fprintf(stderr, "  --tolerance PCT       allowed regression of each metric (default 0.5)\n");
+    fprintf(stderr, "  --time-tolerance PCT  allowed regression of the simulator runtime (default 50)\n");
+    fprintf(stderr, "  --repeat N            runs per scenario, the fastest is kept (default 3)\n");
+    fprintf(stderr, "  --cpus N              simulated CPUs (default 1)\n");
+    fprintf(stderr, "  --perf                show the simulator perf counters of every run\n");
+}
+
+static int parse_double(const char *s, double *out) {
+    char *end;
+    errno = 0;
+    *out = strtod(s, &end);
+    return (errno != 0 || *end != '\0' || *out < 0.0) ? -1 : 0;
+}
+
+static int parse_int(const char *s, int min, int max, int *out) {
+    char *end;
+    errno = 0;
+    long v = strtol(s, &end, 10);
+    if (errno != 0 || *end != '\0' || v < min || v > max) return -1;
+    *out = (int)v;
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *scheduler = "./scheduler";
+    const char *baseline = NULL;
+    int update = 0;
+    double tolerance = 0.5;
+    double time_tolerance = 50.0;
+    int repeat = 3;
+    int cpus = 1;
+
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        int bad = 0;
+        if (!strcmp(argv[i], "--update")) {
+            update = 1;
+        } else if (!strcmp(argv[i], "--perf")) {
+            perf = 1;
+        } else if (i + 1 >= argc) {
+            bad = 1;
+        } else if (!strcmp(argv[i], "--scheduler")) {
+            scheduler = argv[++i];
+        } else if (!strcmp(argv[i], "--baseline")) {
+            baseline = argv[++i];
+        } else if (!strcmp(argv[i], "--tolerance")) {
+            bad = parse_double(argv[++i], &tolerance);
+        } else if (!strcmp(argv[i], "--time-tolerance")) {
+            bad = parse_double(argv[++i], &time_tolerance);
+        } else if (!strcmp(argv[i], "--repeat")) {
+            bad = parse_int(argv[++i], 1, 100, &repeat);
+        } else if (!strcmp(argv[i], "--cpus")) {
+            bad = parse_int(argv[++i], 1, 64, &cpus);
+        } else {
+            bad = 1;
+        }
+        if (bad) {
+            fprintf(stderr, "Invalid option: %s\n", argv[i]);
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc - i != 1) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char *dir = argv[i];
+    char default_baseline[PATH_MAX];
+    if (!baseline) {
+        snprintf(default_baseline, sizeof(default_baseline), "%s/baseline.json", dir);
+        baseline = default_baseline;
+    }
+
+    char **scenarios;
+    int nscenarios = list_scenarios(dir, &scenarios);
+    if (nscenarios <= 0) {
+        fprintf(stderr, "No scenarios (*.wf) in %s\n", dir);
+        return EXIT_FAILURE;
+    }
+
+    static bench_run_t runs[MAX_RUNS];
+    static bench_run_t base[MAX_RUNS];
+    int nruns = 0;
+    int failed = 0;
+    for (int s = 0; s < nscenarios && nruns < MAX_RUNS; s++) {
+        for (size_t p = 0; p < NPOLICIES && nruns < MAX_RUNS; p++) {
+            bench_run_t *r = &runs[nruns];
+            memset(r, 0, sizeof(*r));
+            snprintf(r->scenario, sizeof(r->scenario), "%s", scenarios[s]);
+            snprintf(r->policy, sizeof(r->policy), "%s", POLICIES[p]);
+            int ok = 1;
+            for (int k = 0; k < repeat && ok; k++) {
+                ok = run_once(scheduler, dir, cpus, r, perf && k == 0) == 0;
+            }
+            if (ok) nruns++; else failed = 1;
+        }
+    }
+    for (int s = 0; s < nscenarios; s++) free(scenarios[s]);
+    free(scenarios);
+
+    int nbase = update ? -1 : read_baseline(baseline, base, MAX_RUNS);
+    if (nbase < 0) {
+        if (write_baseline(baseline, runs, nruns, cpus) < 0) return EXIT_FAILURE;
+        printf("Baseline with %d runs written to %s\n", nruns, baseline);
+        return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    printf("%-12s %-10s", "scenario", "policy");
+    for (size_t m = 0; m < NMETRICS; m++) printf(" %12s", METRICS[m].key);
+    printf(" %10s\n", "runtime_ms");
+    int regressions = 0;
+    for (int r = 0; r < nruns; r++) {
+        const bench_run_t *b = find_run(base, nbase, &runs[r]);
+        printf("%-12s %-10s", runs[r].scenario, runs[r].policy);
+        for (size_t m = 0; m < NMETRICS; m++) printf(" %12.1f", runs[r].metric[m]);
+        printf(" %10.1f%s\n", runs[r].runtime_ms, b ? "" : "  (new)");
+        if (!b) continue;
+        for (size_t m = 0; m < NMETRICS; m++) {
+            double pct = regression_pct(b->metric[m], runs[r].metric[m], METRICS[m].higher_is_better);
+            if (pct > tolerance) {
+                printf("  REGRESSION %s: %.2f -> %.2f (%+.1f %%)\n",
+                       METRICS[m].key, b->metric[m], runs[r].metric[m], pct);
+                regressions++;
+            }
+        }
+        double pct = regression_pct(b->runtime_ms, runs[r].runtime_ms, 0);
+        if (pct > time_tolerance && runs[r].runtime_ms - b->runtime_ms > TIME_SLACK_MS) {
+            printf("  REGRESSION runtime_ms: %.2f -> %.2f (%+.1f %%)\n", b->runtime_ms, runs[r].runtime_ms, pct);
+            regressions++;
+        }
+    }
+    printf("%d runs, %d regressions (tolerance %.1f %%, runtime %.1f %%)\n",
+           nruns, regressions, tolerance, time_tolerance);
+    return (failed || regressions > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,358 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "trace.h"
+
+/*
+ * Offline lower bounds for a simulation trace (ossim --trace FILE):
+ *
+ *  - mean flow time: preemptive SRPT on a single CPU running ncpus times
+ *    faster, which is optimal for one CPU and a lower bound for ncpus CPUs,
+ *    and never below the mean burst length;
+ *  - makespan: the longest thread (its bursts and blocks back to back) and
+ *    the CPU demand of the threads started from each instant on, spread over
+ *    all CPUs. In a workflow the threads start when their parents finish, so
+ *    only the critical path and the total demand over all CPUs are used;
+ *  - deadlines: preemptive EDF on the same fast single CPU. If it misses a
+ *    deadline, no schedule on ncpus CPUs can meet them all.
+ *
+ * The flow and deadline bounds use the arrivals recorded in the trace. For
+ * closed-loop apps (the next request is sent after the previous DONE) these
+ * depend on the policy, so compare policies by their gap, not by the bound
+ * alone. The makespan bound only uses the start of each thread.
+ *
+ * Run like: ./sched-bounds [--deadline-factor F] trace.bin [trace.bin...]
+ */
+
+typedef struct {
+    int32_t pid;
+    uint32_t tid;
+    uint32_t arrival_ms;
+    uint32_t size_ms;
+    uint32_t deadline_ms;      // 0 = no deadline
+    uint32_t done_ms;
+    int done;
+} job_t;
+
+typedef struct {
+    uint32_t first_ms;         // first request of the thread
+    uint64_t chain_ms;         // bursts + blocks of the thread
+    uint64_t cpu_ms;           // bursts only
+} thread_t;
+
+typedef struct {
+    const char *path;
+    char policy[16];
+    uint32_t ncpus;
+    uint64_t bursts;
+    double flow_obs, flow_bound;
+    uint32_t makespan_obs, makespan_bound;
+    uint64_t misses_obs, misses_edf;
+    int has_deadlines;
+} result_t;
+
+// ---------------------------------------------------------
+// Binary min-heap of job indices keyed by a double
+// ---------------------------------------------------------
+typedef struct {
+    int *idx;
+    double *key;
+    int n;
+} heap_t;
+
+static void heap_push(heap_t *h, int idx, double key) {
+    int i = h->n++;
+    while (i > 0) {
+        int p = (i - 1) / 2;
+        if (h->key[p] <= key) break;
+        h->idx[i] = h->idx[p];
+        h->key[i] = h->key[p];
+        i = p;
+    }
+    h->idx[i] = idx;
+    h->key[i] = key;
+}
+
+static void heap_pop(heap_t *h) {
+    int idx = h->idx[--h->n];
+    double key = h->key[h->n];
+    int i = 0;
+    for (;;) {
+        int c = 2 * i + 1;
+        if (c >= h->n) break;
+        if (c + 1 < h->n && h->key[c + 1] < h->key[c]) c++;
+        if (key <= h->key[c]) break;
+        h->idx[i] = h->idx[c];
+        h->key[i] = h->key[c];
+        i = c;
+    }
+    h->idx[i] = idx;
+    h->key[i] = key;
+}
+
+/**
+ * Preemptive single-CPU simulation at the given speed. With edf == 0 the
+ * job with the shortest remaining time runs (SRPT) and the mean flow time is
+ * returned; with edf != 0 the earliest deadline runs and the number of missed
+ * deadlines is stored in *misses. Jobs must be sorted by arrival.
+ */
+static double simulate(const job_t *jobs, int n, double speed, int edf, uint64_t *misses) {
+    heap_t h = {malloc((size_t)n * sizeof(int)), malloc((size_t)n * sizeof(double)), 0};
+    double *remaining = malloc((size_t)n * sizeof(double));
+    if (!h.idx || !h.key || !remaining) {
+        free(h.idx);
+        free(h.key);
+        free(remaining);
+        return 0.0;
+    }
+
+    double t = 0.0, flow_sum = 0.0;
+    uint64_t missed = 0;
+    int next = 0;
+    while (next < n || h.n > 0) {
+        if (h.n == 0 && t < jobs[next].arrival_ms) t = jobs[next].arrival_ms;
+        while (next < n && jobs[next].arrival_ms <= t) {
+            remaining[next] = jobs[next].size_ms / speed;
+            heap_push(&h, next, edf ? (double)jobs[next].deadline_ms : remaining[next]);
+            next++;
+        }
+        // Run the head job until it finishes or the next arrival
+        int j = h.idx[0];
+        double until = next < n ? (double)jobs[next].arrival_ms : t + remaining[j];
+        if (t + remaining[j] <= until) {
+            t += remaining[j];
+            heap_pop(&h);
+            flow_sum += t - jobs[j].arrival_ms;
+            if (edf && t > jobs[j].deadline_ms) missed++;
+        } else {
+            remaining[j] -= until - t;
+            t = until;
+            // SRPT: the key is the remaining time, so the head moves down
+            if (!edf) {
+                heap_pop(&h);
+                heap_push(&h, j, remaining[j]);
+            }
+        }
+    }
+
+    free(h.idx);
+    free(h.key);
+    free(remaining);
+    if (misses) *misses = missed;
+    return n ? flow_sum / n : 0.0;
+}
+
+static int by_start(const void *a, const void *b) {
+    const thread_t *ta = a, *tb = b;
+    return (ta->first_ms > tb->first_ms) - (ta->first_ms < tb->first_ms);
+}
+
+static int by_arrival(const void *a, const void *b) {
+    const job_t *ja = a, *jb = b;
+    return (ja->arrival_ms > jb->arrival_ms) - (ja->arrival_ms < jb->arrival_ms);
+}
+
+static int analyze(const char *path, double deadline_factor, result_t *res) {
+    trace_reader_t rd;
+    if (trace_reader_open(&rd, path) < 0) return -1;
+    const trace_header_t hdr = rd.header;
+
+    job_t *jobs = NULL;
+    int njobs = 0, jobs_cap = 0;
+    thread_t *threads = NULL;
+    int nthreads = 0, threads_cap = 0;
+    trace_map_t open = {0}, tmap = {0};
+    uint32_t first_ms = UINT32_MAX, last_ms = 0;
+
+    // One pass over the records
+    const trace_rec_t *r;
+    int rc = 0;
+    while (rc == 0 && (r = trace_reader_next(&rd)) != NULL) {
+        uint64_t key = trace_key(r->pid, r->tid);
+        if (r->type == TRACE_ARRIVE || r->type == TRACE_BLOCK) {
+            int *ti = trace_map_get(&tmap, key);
+            if (!ti) { rc = -1; break; }
+            if (*ti < 0) {
+                if (nthreads == threads_cap) {
+                    threads_cap = threads_cap ? threads_cap * 2 : 256;
+                    thread_t *t = realloc(threads, (size_t)threads_cap * sizeof(thread_t));
+                    if (!t) { rc = -1; break; }
+                    threads = t;
+                }
+                *ti = nthreads;
+                threads[nthreads].first_ms = r->time_ms;
+                threads[nthreads].chain_ms = 0;
+                threads[nthreads++].cpu_ms = 0;
+            }
+            threads[*ti].chain_ms += r->arg;
+            if (r->type == TRACE_ARRIVE) threads[*ti].cpu_ms += r->arg;
+        }
+        if (r->type == TRACE_ARRIVE) {
+            if (njobs == jobs_cap) {
+                jobs_cap = jobs_cap ? jobs_cap * 2 : 1024;
+                job_t *j = realloc(jobs, (size_t)jobs_cap * sizeof(job_t));
+                if (!j) { rc = -1; break; }
+                jobs = j;
+            }
+            job_t *j = &jobs[njobs];
+            j->pid = r->pid;
+            j->tid = r->tid;
+            j->arrival_ms = r->time_ms;
+            j->size_ms = r->arg;
+            j->deadline_ms = r->arg2;
+            if (!j->deadline_ms && deadline_factor > 0) {
+                j->deadline_ms = r->time_ms + (uint32_t)(deadline_factor * r->arg);
+            }
+            j->done = 0;
+            int *ji = trace_map_get(&open, key);
+            if (!ji) { rc = -1; break; }
+            *ji = njobs++;
+            if (r->time_ms < first_ms) first_ms = r->time_ms;
+        } else if (r->type == TRACE_DONE) {
+            int *ji = trace_map_get(&open, key);
+            if (!ji) { rc = -1; break; }
+            if (*ji >= 0) {
+                jobs[*ji].done = 1;
+                jobs[*ji].done_ms = r->time_ms;
+                *ji = -1;
+            }
+            if (r->time_ms > last_ms) last_ms = r->time_ms;
+        } else if (r->type == TRACE_UNBLOCK) {
+            if (r->time_ms > last_ms) last_ms = r->time_ms;
+        }
+    }
+    trace_reader_close(&rd);
+    trace_map_free(&open);
+    trace_map_free(&tmap);
+    if (rc < 0) {
+        fprintf(stderr, "%s: out of memory\n", path);
+        free(jobs);
+        free(threads);
+        return -1;
+    }
+
+    // Only completed bursts are compared
+    int m = 0;
+    for (int i = 0; i < njobs; i++) {
+        if (jobs[i].done) jobs[m++] = jobs[i];
+    }
+    qsort(jobs, (size_t)m, sizeof(job_t), by_arrival);
+
+    memset(res, 0, sizeof(*res));
+    res->path = path;
+    memcpy(res->policy, hdr.policy, sizeof(hdr.policy));
+    res->ncpus = hdr.ncpus;
+    res->bursts = (uint64_t)m;
+
+    double speed = hdr.ncpus;
+    double flow_sum = 0.0, size_sum = 0.0;
+    int has_deadlines = 0;
+    for (int i = 0; i < m; i++) {
+        flow_sum += jobs[i].done_ms - jobs[i].arrival_ms;
+        size_sum += jobs[i].size_ms;
+        if (jobs[i].deadline_ms) {
+            has_deadlines = 1;
+            if (jobs[i].done_ms > jobs[i].deadline_ms) res->misses_obs++;
+        }
+    }
+    res->flow_obs = m ? flow_sum / m : 0.0;
+    res->flow_bound = simulate(jobs, m, speed, 0, NULL);
+    if (m && size_sum / m > res->flow_bound) res->flow_bound = size_sum / m;
+
+    // Makespan bound (from the first arrival)
+    double bound = 0.0, demand = 0.0;
+    if (hdr.critical_path_ms > 0) {
+        for (int i = 0; i < nthreads; i++) demand += threads[i].cpu_ms;
+        bound = first_ms + demand / speed;
+        if (first_ms + hdr.critical_path_ms > bound) bound = first_ms + hdr.critical_path_ms;
+    } else {
+        qsort(threads, (size_t)nthreads, sizeof(thread_t), by_start);
+        for (int i = nthreads - 1; i >= 0; i--) {
+            demand += threads[i].cpu_ms;
+            double b = threads[i].first_ms + demand / speed;
+            if (b > bound) bound = b;
+            if (threads[i].first_ms + threads[i].chain_ms > bound) bound = threads[i].first_ms + threads[i].chain_ms;
+        }
+    }
+    if (m) {
+        res->makespan_obs = last_ms - first_ms;
+        res->makespan_bound = (uint32_t)(bound - first_ms + 0.5);
+    }
+
+    res->has_deadlines = has_deadlines;
+    if (has_deadlines) {
+        // Bursts without a deadline never miss
+        for (int i = 0; i < m; i++) {
+            if (!jobs[i].deadline_ms) jobs[i].deadline_ms = UINT32_MAX;
+        }
+        simulate(jobs, m, speed, 1, &res->misses_edf);
+    }
+
+    free(jobs);
+    free(threads);
+    return 0;
+}
+
+static double gap(double obs, double bound) {
+    return bound > 0 ? 100.0 * (obs - bound) / bound : 0.0;
+}
+
+static void print_result(const result_t *r) {
+    printf("==== %s (%s, %u CPUs, %llu bursts) ====\n",
+           r->path, r->policy, r->ncpus, (unsigned long long)r->bursts);
+    printf("Mean flow:      observed %.1f ms, bound %.1f ms (SRPT on 1 CPU at %ux), gap %.1f %%\n",
+           r->flow_obs, r->flow_bound, r->ncpus, gap(r->flow_obs, r->flow_bound));
+    printf("Makespan:       observed %u ms, bound %u ms, gap %.1f %%\n",
+           r->makespan_obs, r->makespan_bound, gap(r->makespan_obs, r->makespan_bound));
+    if (r->has_deadlines) {
+        printf("Deadlines:      observed %llu misses; EDF on 1 CPU at %ux: %s (%llu misses)\n",
+               (unsigned long long)r->misses_obs, r->ncpus,
+               r->misses_edf ? "infeasible" : "feasible", (unsigned long long)r->misses_edf);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    double deadline_factor = 0.0;
+    int first = 1;
+    if (argc > 2 && !strcmp(argv[1], "--deadline-factor")) {
+        char *end;
+        errno = 0;
+        deadline_factor = strtod(argv[2], &end);
+        if (errno != 0 || *end != '\0' || deadline_factor < 1.0) {
+            fprintf(stderr, "Invalid deadline factor: %s (>= 1)\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+        first = 3;
+    }
+    if (first >= argc) {
+        printf("Usage: %s [--deadline-factor F] <trace.bin> [trace.bin...]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int ntraces = argc - first;
+    result_t *results = calloc((size_t)ntraces, sizeof(result_t));
+    if (!results) return EXIT_FAILURE;
+    int ok = 0;
+    for (int i = 0; i < ntraces; i++) {
+        if (analyze(argv[first + i], deadline_factor, &results[ok]) == 0) {
+            print_result(&results[ok]);
+            ok++;
+        }
+    }
+
+    // Several traces of the same workload: one line per policy
+    if (ok > 1) {
+        printf("\n%-12s %10s %10s %8s %10s %10s %8s\n",
+               "policy", "flow", "bound", "gap%", "makespan", "bound", "gap%");
+        for (int i = 0; i < ok; i++) {
+            const result_t *r = &results[i];
+            printf("%-12s %10.1f %10.1f %8.1f %10u %10u %8.1f\n", r->policy,
+                   r->flow_obs, r->flow_bound, gap(r->flow_obs, r->flow_bound),
+                   r->makespan_obs, r->makespan_bound, gap(r->makespan_obs, r->makespan_bound));
+        }
+    }
+    free(results);
+    return ok == ntraces ? EXIT_SUCCESS : EXIT_FAILURE;
+}
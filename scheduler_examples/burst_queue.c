@@ -26,24 +26,38 @@ int parse_burst_line(const char* line, burst_t* burst) {
         return -1;
     }
 
-    long burst_time = strtol(token, &endptr, 10);
-    if (*endptr != '\0' || burst_time < 0 || burst_time > INT_MAX) {
-        fprintf(stderr, "Invalid burst time: %s\n", token);
-        free(line_copy);
-        return -1;
-    }
-    burst->burst_time_ms = (int)burst_time;
-
-    // Optional: block time
-    token = strtok(NULL, ",\r\n");
-    if (token) {
-        long block_time_ms = strtol(token, &endptr, 10);
-        if (*endptr != '\0' || block_time_ms < INT_MIN || block_time_ms > INT_MAX) {
-            fprintf(stderr, "Invalid block time value: %s\n", token);
+    // Lock steps: lock,<id> or unlock,<id>, in place of cpu,io
+    if (!strcmp(token, "lock") || !strcmp(token, "unlock")) {
+        burst->kind = (token[0] == 'l') ? BURST_LOCK : BURST_UNLOCK;
+        token = strtok(NULL, ",\r\n");
+        long lock_id = token ? strtol(token, &endptr, 10) : -1;
+        if (!token || *endptr != '\0' || lock_id < 0 || lock_id > INT_MAX) {
+            fprintf(stderr, "Invalid lock id: %s\n", token ? token : "(missing)");
+            free(line_copy);
+            return -1;
+        }
+        burst->lock_id = (uint32_t)lock_id;
+    } else {
+        long burst_time = strtol(token, &endptr, 10);
+        if (*endptr != '\0' || burst_time < 0 || burst_time > INT_MAX) {
+            fprintf(stderr, "Invalid burst time: %s\n", token);
             free(line_copy);
             return -1;
         }
-        burst->block_time_ms = (int)block_time_ms;
+        burst->kind = BURST_CPU;
+        burst->burst_time_ms = (int)burst_time;
+
+        // Optional: block time
+        token = strtok(NULL, ",\r\n");
+        if (token) {
+            long block_time_ms = strtol(token, &endptr, 10);
+            if (*endptr != '\0' || block_time_ms < INT_MIN || block_time_ms > INT_MAX) {
+                fprintf(stderr, "Invalid block time value: %s\n", token);
+                free(line_copy);
+                return -1;
+            }
+            burst->block_time_ms = (int)block_time_ms;
+        }
     }
 
     // Optional: parse nice
@@ -3,7 +3,16 @@
 
 #include "msg.h"
 
+// Kind of step in a burst script
+typedef enum {
+    BURST_CPU = 0,                  // <cpu(ms)>,<io(ms)>[,nice] (RUN then optional BLOCK)
+    BURST_LOCK,                     // lock,<id>[,nice]
+    BURST_UNLOCK                    // unlock,<id>[,nice]
+} burst_kind_en;
+
 typedef struct {
+    burst_kind_en kind;
+    uint32_t lock_id;               // Mutex id of lock/unlock steps
     uint32_t burst_time_ms;         // Burst time in milliseconds
     uint32_t block_time_ms;         // Burst time in milliseconds
     int nice;                       // Nice value (priority)
@@ -0,0 +1,290 @@
+#include "cbs.h"
+#include "msg.h"
+#include "stats.h"
+#include "channel.h"
+#include <stdlib.h>
+
+/**
+ * Constant Bandwidth Servers com EDF global
+ *
+ * Há um servidor por reserva pedida; a tabela só cresce com pedidos
+ * RESERVE e as reservas de ligações fechadas (ou substituídas) ficam na
+ * tabela, fora da admissão, para o relatório. Cada burst guarda no PCB o
+ * índice do seu servidor (pcb->reservation).
+ */
+
+typedef struct {
+    int32_t pid;
+    uint32_t tid;
+    uint32_t sockfd;
+    uint32_t runtime_ms;        // Q
+    uint32_t period_ms;         // P
+    int admitted;               // conta para a admissão
+
+    uint32_t budget_ms;         // c
+    uint32_t deadline_ms;       // d
+    int throttled;              // orçamento esgotado, à espera de d
+    queue_t jobs;               // bursts por servir (o primeiro é o atual)
+    int cpu;                    // CPU onde correu no último tick (-1)
+    int picked;                 // escolhido pelo EDF neste tick
+
+    uint32_t done;
+    uint64_t response_sum_ms;
+    uint32_t response_max_ms;
+    uint64_t cpu_ms;
+    uint32_t throttles;
+    uint32_t misses;            // prazo do servidor passou com trabalho e orçamento
+} cbs_server_t;
+
+static uint32_t max_util = CBS_DEFAULT_MAX_UTIL;
+
+static cbs_server_t *servers = NULL;
+static int nservers = 0;
+static int servers_cap = 0;
+
+static uint32_t rejected = 0;
+static uint64_t reserved_done = 0;
+
+void cbs_set_max_util(uint32_t percent) {
+    max_util = percent;
+}
+
+int cbs_active(void) {
+    return nservers > 0;
+}
+
+int cbs_lookup(int32_t pid, uint32_t tid, uint32_t sockfd) {
+    for (int i = 0; i < nservers; i++) {
+        cbs_server_t *s = &servers[i];
+        if (s->admitted && s->pid == pid && s->tid == tid && s->sockfd == sockfd) return i;
+    }
+    return -1;
+}
+
+int cbs_reserve(int32_t pid, uint32_t tid, uint32_t sockfd,
+                uint32_t runtime_ms, uint32_t period_ms, int ncpus) {
+    if (runtime_ms == 0 || runtime_ms > period_ms ||
+        runtime_ms % TICKS_MS != 0 || period_ms % TICKS_MS != 0) {
+        rejected++;
+        return -1;
+    }
+
+    // Teste de utilização: Σ Q/P <= ncpus × max_util (sem a reserva que é substituída)
+    int old = cbs_lookup(pid, tid, sockfd);
+    double u = (double)runtime_ms / period_ms;
+    for (int i = 0; i < nservers; i++) {
+        if (servers[i].admitted && i != old) {
+            u += (double)servers[i].runtime_ms / servers[i].period_ms;
+        }
+    }
+    if (u > ncpus * max_util / 100.0 + 1e-9) {
+        rejected++;
+        return -1;
+    }
+
+    if (nservers == servers_cap) {
+        int cap = servers_cap ? 2 * servers_cap : 8;
+        cbs_server_t *v = realloc(servers, (size_t)cap * sizeof(cbs_server_t));
+        if (!v) return -1;
+        servers = v;
+        servers_cap = cap;
+    }
+    if (old >= 0) servers[old].admitted = 0;
+    servers[nservers++] = (cbs_server_t){
+        .pid = pid,
+        .tid = tid,
+        .sockfd = sockfd,
+        .runtime_ms = runtime_ms,
+        .period_ms = period_ms,
+        .admitted = 1,
+        .jobs = {.head = NULL, .tail = NULL},
+        .cpu = -1
+    };
+    return 0;
+}
+
+void cbs_enqueue(pcb_t *task, uint32_t now_ms) {
+    cbs_server_t *s = &servers[task->reservation];
+    // Regra de chegada: o orçamento que resta só se mantém se couber na
+    // largura de banda Q/P até ao prazo atual
+    if (!s->jobs.head && !s->throttled &&
+        (s->deadline_ms <= now_ms ||
+         (uint64_t)s->budget_ms * s->period_ms >= (uint64_t)(s->deadline_ms - now_ms) * s->runtime_ms)) {
+        s->budget_ms = s->runtime_ms;
+        s->deadline_ms = now_ms + s->period_ms;
+    }
+    task->deadline_ms = s->deadline_ms;
+    enqueue_pcb(&s->jobs, task);
+}
+
+// O burst atual do servidor recebeu o CPU durante o último tick
+static void account_tick(cbs_server_t *s, uint32_t now_ms) {
+    pcb_t *task = s->jobs.head->pcb;
+    task->ellapsed_time_ms += TICKS_MS;
+    s->budget_ms = s->budget_ms > TICKS_MS ? s->budget_ms - TICKS_MS : 0;
+    s->cpu_ms += TICKS_MS;
+
+    if (task->ellapsed_time_ms >= task->time_ms) {
+        msg_t msg = {
+            .pid = task->pid,
+            .tid = task->tid,
+            .request = PROCESS_REQUEST_DONE,
+            .time_ms = now_ms
+        };
+        if (channel_send(task->sockfd, &msg) < 0) {
+            perror("write");
+        }
+        stats_burst_done(task, now_ms);
+        free_pcb(dequeue_pcb(&s->jobs));
+    }
+}
+
+void cbs_scheduler(uint32_t now_ms, pcb_t **cpu_tasks, int ncpus,
+                   cbs_displace_fn displace, void *ctx) {
+    // 1) Tick das tarefas com reserva que estavam nos CPUs; os CPUs ficam
+    //    livres e são redistribuídos em baixo
+    for (int i = 0; i < nservers; i++) servers[i].cpu = -1;
+    for (int c = 0; c < ncpus; c++) {
+        pcb_t *task = cpu_tasks[c];
+        if (!task || task->reservation < 0) continue;
+        cbs_server_t *s = &servers[task->reservation];
+        cpu_tasks[c] = NULL;
+        s->cpu = c;
+        account_tick(s, now_ms);
+    }
+
+    // 2) Estrangulamento, reposição do orçamento e verificação dos prazos
+    for (int i = 0; i < nservers; i++) {
+        cbs_server_t *s = &servers[i];
+        if (s->throttled && now_ms >= s->deadline_ms) {
+            s->throttled = 0;
+            s->budget_ms = s->runtime_ms;
+            s->deadline_ms += s->period_ms;
+        }
+        if (!s->jobs.head || s->throttled) continue;
+        if (s->budget_ms == 0) {
+            s->throttled = 1;
+            s->throttles++;
+        } else if (now_ms >= s->deadline_ms) {
+            // O servidor não conseguiu gastar o orçamento até ao prazo
+            s->misses++;
+            s->budget_ms = s->runtime_ms;
+            s->deadline_ms = now_ms + s->period_ms;
+        }
+    }
+
+    // 3) EDF: os ncpus servidores ativos com prazo mais cedo (em caso de
+    //    empate fica o que já estava a correr)
+    int chosen[MAX_CPUS];
+    int nchosen = 0;
+    for (int i = 0; i < nservers; i++) servers[i].picked = 0;
+    while (nchosen < ncpus) {
+        int best = -1;
+        for (int i = 0; i < nservers; i++) {
+            cbs_server_t *s = &servers[i];
+            if (!s->jobs.head || s->throttled || s->picked) continue;
+            if (best < 0 || s->deadline_ms < servers[best].deadline_ms ||
+                (s->deadline_ms == servers[best].deadline_ms && s->cpu >= 0 && servers[best].cpu < 0)) {
+                best = i;
+            }
+        }
+        if (best < 0) break;
+        servers[best].picked = 1;
+        chosen[nchosen++] = best;
+    }
+
+    // 4) Colocação: o CPU anterior, depois CPUs livres e, por fim, desaloja
+    //    tarefas sem reserva (do último CPU para o primeiro)
+    for (int k = 0; k < nchosen; k++) {
+        cbs_server_t *s = &servers[chosen[k]];
+        if (s->cpu >= 0 && !cpu_tasks[s->cpu]) {
+            cpu_tasks[s->cpu] = s->jobs.head->pcb;
+            chosen[k] = -1;
+        }
+    }
+    for (int k = 0; k < nchosen; k++) {
+        if (chosen[k] < 0) continue;
+        int target = -1;
+        for (int c = 0; c < ncpus && target < 0; c++) {
+            if (!cpu_tasks[c]) target = c;
+        }
+        for (int c = ncpus - 1; c >= 0 && target < 0; c--) {
+            if (cpu_tasks[c]->reservation < 0) {
+                displace(cpu_tasks[c], ctx);
+                cpu_tasks[c] = NULL;
+                target = c;
+            }
+        }
+        if (target >= 0) cpu_tasks[target] = servers[chosen[k]].jobs.head->pcb;
+    }
+}
+
+void cbs_job_done(const pcb_t *task, uint32_t now_ms) {
+    if (task->reservation < 0 || task->reservation >= nservers) return;
+    cbs_server_t *s = &servers[task->reservation];
+    uint32_t response = now_ms - task->arrival_time_ms;
+    s->done++;
+    s->response_sum_ms += response;
+    if (response > s->response_max_ms) s->response_max_ms = response;
+    reserved_done++;
+}
+
+void cbs_drop(uint32_t sockfd) {
+    for (int i = 0; i < nservers; i++) {
+        if (servers[i].sockfd == sockfd) servers[i].admitted = 0;
+    }
+}
+
+void cbs_report(FILE *out, uint32_t now_ms, int ncpus) {
+    if (nservers == 0 && rejected == 0) return;
+    // Reservas em vigor: as substituídas e as dos clientes que saíram
+    // continuam na tabela (e nas linhas abaixo), mas já não contam
+    int admitted = 0;
+    double u = 0.0;
+    uint64_t reserved_ms = 0;
+    uint32_t misses = 0;
+    for (int i = 0; i < nservers; i++) {
+        if (servers[i].admitted) {
+            admitted++;
+            u += (double)servers[i].runtime_ms / servers[i].period_ms;
+        }
+        reserved_ms += servers[i].cpu_ms;
+        misses += servers[i].misses;
+    }
+
+    fprintf(out, "---- CBS reservations (EDF, limit %u %% per CPU) ----\n", max_util);
+    fprintf(out, "Reservations:         %d admitted at exit (bandwidth %.3f of %d CPU(s)), %u rejected\n",
+            admitted, u, ncpus, rejected);
+    fprintf(out, "Guarantees:           %s (%u server deadline misses)\n",
+            misses ? "violated" : "met", misses);
+    fprintf(out, "%-8s %4s %6s %6s %6s %9s %9s %8s %9s %6s\n",
+            "pid", "tid", "Q", "P", "bursts", "mean.R", "worst.R", "cpu.ms", "throttled", "missed");
+    for (int i = 0; i < nservers; i++) {
+        const cbs_server_t *s = &servers[i];
+        fprintf(out, "%-8d %4u %6u %6u %6u %9.1f %9u %8llu %9u %6u\n",
+                s->pid, s->tid, s->runtime_ms, s->period_ms, s->done,
+                s->done ? (double)s->response_sum_ms / s->done : 0.0, s->response_max_ms,
+                (unsigned long long)s->cpu_ms, s->throttles, s->misses);
+    }
+
+    // O que sobra é o trabalho sem reserva
+    double secs = now_ms / 1000.0;
+    uint64_t be_done = stats_bursts_done() - reserved_done;
+    uint64_t be_ms = stats_cpu_busy_ms() - reserved_ms;
+    fprintf(out, "Best-effort:          %llu bursts (%.2f bursts/s), %.1f %% of CPU capacity\n",
+            (unsigned long long)be_done, secs > 0 ? be_done / secs : 0.0,
+            now_ms ? 100.0 * be_ms / ((double)now_ms * ncpus) : 0.0);
+    fflush(out);
+}
+
+void cbs_free(void) {
+    for (int i = 0; i < nservers; i++) {
+        while (servers[i].jobs.head) free_pcb(dequeue_pcb(&servers[i].jobs));
+    }
+    free(servers);
+    servers = NULL;
+    nservers = 0;
+    servers_cap = 0;
+    rejected = 0;
+    reserved_done = 0;
+}
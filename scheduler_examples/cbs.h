@@ -0,0 +1,98 @@
+#ifndef CBS_H
+#define CBS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "queue.h"
+
+/*
+ * Reservas de CPU (estilo SCHED_DEADLINE) com Constant Bandwidth Servers.
+ *
+ * Um pedido RESERVE pede, para uma thread, um orçamento de runtime ms em
+ * cada período de period ms. Cada reserva é servida por um CBS com
+ * orçamento c e prazo d: quando um burst chega a um servidor parado e o
+ * orçamento que resta não cabe na largura de banda até d, o servidor
+ * recomeça com c = runtime e d = chegada + period. Enquanto a thread corre,
+ * c desce; se chegar a 0 o servidor fica estrangulado (throttled) até d, e
+ * aí recebe c = runtime e d = d + period. Assim um burst que exceda o seu
+ * orçamento só se atrasa a si próprio.
+ *
+ * Os servidores ativos são escalonados por EDF global (prazo mais cedo
+ * primeiro) e passam à frente de qualquer tarefa sem reserva, que corre na
+ * capacidade que sobra com a política escolhida. A admissão rejeita
+ * reservas que levem a soma de runtime/period acima do limite
+ * (por omissão 95 % de cada CPU).
+ */
+
+#define CBS_DEFAULT_MAX_UTIL 95   // % de cada CPU disponível para reservas
+
+// Chamada para devolver à fila de prontos uma tarefa sem reserva desalojada
+typedef void (*cbs_displace_fn)(pcb_t *task, void *ctx);
+
+/**
+ * @brief Percentagem de cada CPU que as reservas podem usar (1..100)
+ */
+void cbs_set_max_util(uint32_t percent);
+
+/**
+ * @brief Pede uma reserva (runtime, period) para a thread (pid, tid)
+ *
+ * O runtime e o período têm de ser múltiplos de TICKS_MS, com
+ * runtime <= period. Uma nova reserva da mesma thread substitui a anterior.
+ * @return 0 se foi admitida, -1 se foi rejeitada
+ */
+int cbs_reserve(int32_t pid, uint32_t tid, uint32_t sockfd,
+                uint32_t runtime_ms, uint32_t period_ms, int ncpus);
+
+/**
+ * @brief Reserva ativa da thread (pid, tid) nesta ligação, ou -1
+ */
+int cbs_lookup(int32_t pid, uint32_t tid, uint32_t sockfd);
+
+/**
+ * @brief Um burst RUN chega ao servidor da sua reserva (pcb->reservation)
+ *
+ * Aplica a regra de chegada do CBS e preenche pcb->deadline_ms com o prazo
+ * do servidor. O PCB passa a pertencer a este módulo até ao DONE.
+ */
+void cbs_enqueue(pcb_t *task, uint32_t now_ms);
+
+/**
+ * @brief Escalonamento EDF dos servidores num tick
+ *
+ * Deve ser chamada depois da política sem reservas, que não toca nos CPUs
+ * ocupados por tarefas com reserva. Contabiliza o tick das tarefas com
+ * reserva que estavam nos CPUs (DONE, orçamento, estrangulamento), repõe os
+ * orçamentos e coloca os servidores com prazo mais cedo nos CPUs: primeiro
+ * nos que já usavam, depois nos livres e, por fim, desalojando tarefas sem
+ * reserva (entregues a displace).
+ */
+void cbs_scheduler(uint32_t now_ms, pcb_t **cpu_tasks, int ncpus,
+                   cbs_displace_fn displace, void *ctx);
+
+/**
+ * @brief Indica se já houve alguma reserva admitida
+ */
+int cbs_active(void);
+
+/**
+ * @brief Um burst com reserva terminou: regista o tempo de resposta
+ */
+void cbs_job_done(const pcb_t *task, uint32_t now_ms);
+
+/**
+ * @brief Uma ligação fechou: as suas reservas deixam de contar na admissão
+ */
+void cbs_drop(uint32_t sockfd);
+
+/**
+ * @brief Imprime as garantias de cada reserva e o débito sem reservas
+ */
+void cbs_report(FILE *out, uint32_t now_ms, int ncpus);
+
+/**
+ * @brief Liberta as reservas (e os bursts ainda por servir)
+ */
+void cbs_free(void);
+
+#endif //CBS_H
@@ -0,0 +1,104 @@
+#include "channel.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Estado de um canal virtual
+typedef struct {
+    channel_handler_fn handler;   // entrega das mensagens do simulador
+    void *ctx;
+    msg_t inbox[CHANNEL_INBOX];   // pedidos ainda não lidos pelo simulador
+    int head;
+    int count;
+    int hung_up;                  // a aplicação terminou
+    int closed;                   // o simulador fechou o canal
+} vchannel_t;
+
+// Os identificadores nunca são reutilizados: um PCB antigo que ainda
+// guarde o identificador de um canal fechado não entrega mensagens a outro.
+static vchannel_t *vchannels = NULL;
+static uint32_t vchannel_count = 0;
+static uint32_t vchannel_cap = 0;
+
+static vchannel_t *lookup(uint32_t fd) {
+    uint32_t idx = fd & ~CHANNEL_VIRTUAL_FLAG;
+    if (idx >= vchannel_count) return NULL;
+    return &vchannels[idx];
+}
+
+static int is_virtual(uint32_t fd) {
+    return fd != (uint32_t)-1 && (fd & CHANNEL_VIRTUAL_FLAG);
+}
+
+int channel_send(uint32_t fd, const msg_t *msg) {
+    if (!is_virtual(fd)) {
+        if (write((int)fd, msg, sizeof(*msg)) != sizeof(*msg)) return -1;
+        return 0;
+    }
+    vchannel_t *ch = lookup(fd);
+    if (!ch || ch->closed || ch->hung_up) return -1;
+    ch->handler(fd, msg, ch->ctx);
+    return 0;
+}
+
+int channel_recv(uint32_t fd, msg_t *msg) {
+    if (!is_virtual(fd)) {
+        ssize_t n = recv((int)fd, msg, sizeof(*msg), MSG_DONTWAIT);
+        if (n == 0) return 0;                   // o cliente fechou a ligação
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return -2; // nada para ler agora
+            return -1;                          // erro real
+        }
+        if ((size_t)n != sizeof(*msg)) return -1;
+        return 1;
+    }
+    vchannel_t *ch = lookup(fd);
+    if (!ch || ch->closed) return -1;
+    if (ch->count == 0) return ch->hung_up ? 0 : -2;
+    *msg = ch->inbox[ch->head];
+    ch->head = (ch->head + 1) % CHANNEL_INBOX;
+    ch->count--;
+    return 1;
+}
+
+void channel_close(uint32_t fd) {
+    if (!is_virtual(fd)) {
+        close((int)fd);
+        return;
+    }
+    vchannel_t *ch = lookup(fd);
+    if (ch) ch->closed = 1;
+}
+
+uint32_t channel_open_virtual(channel_handler_fn handler, void *ctx) {
+    if (vchannel_count == vchannel_cap) {
+        uint32_t cap = vchannel_cap ? vchannel_cap * 2 : 16;
+        vchannel_t *v = realloc(vchannels, cap * sizeof(vchannel_t));
+        if (!v) return (uint32_t)-1;
+        vchannels = v;
+        vchannel_cap = cap;
+    }
+    vchannel_t *ch = &vchannels[vchannel_count];
+    ch->handler = handler;
+    ch->ctx = ctx;
+    ch->head = 0;
+    ch->count = 0;
+    ch->hung_up = 0;
+    ch->closed = 0;
+    return CHANNEL_VIRTUAL_FLAG | vchannel_count++;
+}
+
+int channel_post(uint32_t fd, const msg_t *msg) {
+    vchannel_t *ch = lookup(fd);
+    if (!ch || ch->count == CHANNEL_INBOX) return -1;
+    ch->inbox[(ch->head + ch->count) % CHANNEL_INBOX] = *msg;
+    ch->count++;
+    return 0;
+}
+
+void channel_hangup(uint32_t fd) {
+    vchannel_t *ch = lookup(fd);
+    if (ch) ch->hung_up = 1;
+}
@@ -0,0 +1,59 @@
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <stdint.h>
+#include "msg.h"
+
+/*
+ * Canal de comunicação entre o simulador e uma aplicação.
+ *
+ * Um canal é identificado pelo mesmo inteiro que o simulador guarda em
+ * pcb->sockfd. Pode ser um socket real (aplicações externas ligadas a
+ * SOCKET_PATH) ou um canal virtual, usado por aplicações simuladas dentro
+ * do próprio processo (ver workload.h). Os canais virtuais têm o bit
+ * CHANNEL_VIRTUAL_FLAG ligado e não fazem chamadas ao sistema.
+ */
+
+#define CHANNEL_VIRTUAL_FLAG 0x40000000u
+#define CHANNEL_INBOX 32   // pedidos pendentes por canal virtual
+
+// Chamada quando o simulador envia uma mensagem (ACK/DONE) a um canal virtual
+typedef void (*channel_handler_fn)(uint32_t fd, const msg_t *msg, void *ctx);
+
+/**
+ * @brief Envia uma mensagem para a aplicação
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int channel_send(uint32_t fd, const msg_t *msg);
+
+/**
+ * @brief Lê uma mensagem da aplicação sem bloquear
+ * @return 1 se leu uma mensagem, 0 se a ligação foi fechada,
+ *         -2 se não há nada para ler, -1 em caso de erro
+ */
+int channel_recv(uint32_t fd, msg_t *msg);
+
+/**
+ * @brief Fecha o lado do simulador (close() para sockets reais)
+ */
+void channel_close(uint32_t fd);
+
+/**
+ * @brief Abre um canal virtual; handler recebe as mensagens do simulador
+ * @return O identificador do canal, ou (uint32_t)-1 em caso de erro
+ */
+uint32_t channel_open_virtual(channel_handler_fn handler, void *ctx);
+
+/**
+ * @brief Coloca um pedido da aplicação virtual na caixa de entrada do canal
+ * @return 0 em caso de sucesso, -1 se a caixa estiver cheia
+ */
+int channel_post(uint32_t fd, const msg_t *msg);
+
+/**
+ * @brief A aplicação virtual terminou: depois de lidos os pedidos pendentes,
+ *        channel_recv() devolve 0 (como um socket fechado)
+ */
+void channel_hangup(uint32_t fd);
+
+#endif //CHANNEL_H
@@ -0,0 +1,421 @@
+#include "classes.h"
+#include "msg.h"
+#include "stats.h"
+#include "channel.h"
+#include <stdio.h>
+
+/**
+ * Pilha de classes de escalonamento
+ *
+ * Cada classe implementa as operações de sched_class_ops_t sobre a sua
+ * fila; o escalonador só fala com as classes através desta tabela, pela
+ * ordem de prioridade. class_mask tem um bit por classe com tarefas à
+ * espera (as que estão nos CPUs não contam).
+ */
+
+typedef enum {
+    CLASS_RT = 0,
+    CLASS_FAIR,
+    CLASS_BATCH,
+    CLASS_IDLE,
+    NUM_CLASSES
+} class_idx_en;
+
+// Resultado de preempt(): a tarefa fica, volta ao fim da fila (fatia
+// esgotada) ou à frente (ultrapassada por uma tarefa mais prioritária)
+#define PREEMPT_NONE 0
+#define PREEMPT_TAIL 1
+#define PREEMPT_HEAD 2
+
+typedef struct {
+    const char *name;
+    void (*enqueue)(pcb_t *task, int head);     // head: desalojada, volta à frente
+    void (*enqueue_batch)(queue_t *batch);      // chegadas de um tick, pela ordem (batch fica vazia)
+    pcb_t *(*pick)(void);                       // retira a próxima tarefa
+    void (*tick)(pcb_t *task);                  // a tarefa correu um tick
+    int (*preempt)(const pcb_t *curr, uint32_t now_ms);  // PREEMPT_* dentro da classe
+} sched_class_ops_t;
+
+static uint32_t class_mask = 0;
+
+// Pesos do CFS para nice -20..19 (sched_prio_to_weight)
+static const uint32_t FAIR_WEIGHTS[40] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+    9548, 7620, 6100, 4904, 3906,
+    3121, 2501, 1991, 1586, 1277,
+    1024, 820, 655, 526, 423,
+    335, 272, 215, 172, 137,
+    110, 87, 70, 56, 45,
+    36, 29, 23, 18, 15,
+};
+
+// Liga um PCB numa posição da fila (o elemento vem do pool via enqueue_pcb)
+static void insert_after(queue_t *q, queue_elem_t *prev, pcb_t *task) {
+    queue_t tmp = {.head = NULL, .tail = NULL};
+    if (!enqueue_pcb(&tmp, task)) return;
+    queue_elem_t *elem = tmp.head;
+    if (!prev) {
+        elem->next = q->head;
+        q->head = elem;
+    } else {
+        elem->next = prev->next;
+        prev->next = elem;
+    }
+    if (q->tail == prev) q->tail = elem;
+}
+
+static void push_head(queue_t *q, pcb_t *task) {
+    insert_after(q, NULL, task);
+}
+
+static void free_queue(queue_t *q) {
+    while (q->head) free_pcb(dequeue_pcb(q));
+}
+
+// ---------------------------------------------------------
+// Classe rt: vetor de prioridades com bitmap
+// ---------------------------------------------------------
+
+static queue_t rt_queues[RT_PRIO_LEVELS];
+static uint32_t rt_bitmap = 0;
+
+static int rt_level(const pcb_t *task) {
+    if (task->nice < 0) return 0;
+    if (task->nice >= RT_PRIO_LEVELS) return RT_PRIO_LEVELS - 1;
+    return task->nice;
+}
+
+static void rt_enqueue(pcb_t *task, int head) {
+    int l = rt_level(task);
+    if (head) {
+        push_head(&rt_queues[l], task);
+    } else {
+        enqueue_pcb(&rt_queues[l], task);
+    }
+    rt_bitmap |= 1u << l;
+    class_mask |= 1u << CLASS_RT;
+}
+
+static void rt_enqueue_batch(queue_t *batch) {
+    while (batch->head) {
+        int l = rt_level(batch->head->pcb);
+        move_queue_head(&rt_queues[l], batch);
+        rt_bitmap |= 1u << l;
+    }
+    class_mask |= 1u << CLASS_RT;
+}
+
+static pcb_t *rt_pick(void) {
+    int l = __builtin_ctz(rt_bitmap);
+    pcb_t *task = dequeue_pcb(&rt_queues[l]);
+    if (!rt_queues[l].head) rt_bitmap &= ~(1u << l);
+    if (!rt_bitmap) class_mask &= ~(1u << CLASS_RT);
+    return task;
+}
+
+static void no_tick(pcb_t *task) {
+    (void)task;
+}
+
+static int rt_preempt(const pcb_t *curr, uint32_t now_ms) {
+    if (!rt_bitmap) return PREEMPT_NONE;
+    int top = __builtin_ctz(rt_bitmap);
+    int l = rt_level(curr);
+    if (top < l) return PREEMPT_HEAD;
+    if (top > l) return PREEMPT_NONE;
+    // Mesmo nível: o RT_RR roda, o RT_FIFO continua
+    return curr->sched_class == SCHED_CLASS_RT_RR &&
+           now_ms - curr->slice_start_ms >= RT_RR_SLICE_MS ? PREEMPT_TAIL : PREEMPT_NONE;
+}
+
+// ---------------------------------------------------------
+// Classe fair: fila ordenada pelo vruntime
+// ---------------------------------------------------------
+
+static queue_t fair_queue = {.head = NULL, .tail = NULL};
+static uint32_t fair_waiting = 0;
+static uint64_t min_vruntime = 0;
+
+static uint32_t fair_weight(const pcb_t *task) {
+    int n = task->nice < -20 ? -20 : task->nice > 19 ? 19 : task->nice;
+    return FAIR_WEIGHTS[n + 20];
+}
+
+static void fair_enqueue(pcb_t *task, int head) {
+    // Uma tarefa nova começa no vruntime mínimo: não herda crédito nem dívida
+    if (!head && task->vruntime < min_vruntime) task->vruntime = min_vruntime;
+    queue_elem_t *prev = NULL;
+    for (queue_elem_t *it = fair_queue.head; it && it->pcb->vruntime <= task->vruntime; it = it->next) {
+        prev = it;
+    }
+    insert_after(&fair_queue, prev, task);
+    fair_waiting++;
+    class_mask |= 1u << CLASS_FAIR;
+}
+
+// Junta duas listas ordenadas pelo vruntime; nos empates a ganha (estável)
+static queue_elem_t *merge_by_vruntime(queue_elem_t *a, queue_elem_t *b, queue_elem_t **tail_out) {
+    queue_elem_t head = {.pcb = NULL, .next = NULL};
+    queue_elem_t *tail = &head;
+    while (a && b) {
+        if (b->pcb->vruntime < a->pcb->vruntime) {
+            tail->next = b;
+            b = b->next;
+        } else {
+            tail->next = a;
+            a = a->next;
+        }
+        tail = tail->next;
+    }
+    tail->next = a ? a : b;
+    if (tail_out) {
+        while (tail->next) tail = tail->next;
+        *tail_out = tail;
+    }
+    return head.next;
+}
+
+// Merge sort estável de uma lista pelo vruntime (só religa os elementos)
+static queue_elem_t *sort_by_vruntime(queue_elem_t *list) {
+    if (!list || !list->next) return list;
+    queue_elem_t *slow = list;
+    for (queue_elem_t *fast = list->next; fast && fast->next; fast = fast->next->next) {
+        slow = slow->next;
+    }
+    queue_elem_t *right = slow->next;
+    slow->next = NULL;
+    return merge_by_vruntime(sort_by_vruntime(list), sort_by_vruntime(right), NULL);
+}
+
+// k chegadas em O(n + k log k), em vez de uma inserção ordenada O(n) por tarefa.
+// Nos empates as que já estavam ficam à frente e as novas mantêm a sua ordem,
+// como com fair_enqueue() uma a uma.
+static void fair_enqueue_batch(queue_t *batch) {
+    for (queue_elem_t *it = batch->head; it != NULL; it = it->next) {
+        if (it->pcb->vruntime < min_vruntime) it->pcb->vruntime = min_vruntime;
+        fair_waiting++;
+    }
+    queue_elem_t *sorted = sort_by_vruntime(batch->head);
+    fair_queue.head = merge_by_vruntime(fair_queue.head, sorted, &fair_queue.tail);
+    batch->head = NULL;
+    batch->tail = NULL;
+    class_mask |= 1u << CLASS_FAIR;
+}
+
+static pcb_t *fair_pick(void) {
+    pcb_t *task = dequeue_pcb(&fair_queue);
+    fair_waiting--;
+    if (!fair_queue.head) class_mask &= ~(1u << CLASS_FAIR);
+    if (task->vruntime > min_vruntime) min_vruntime = task->vruntime;
+    return task;
+}
+
+static void fair_tick(pcb_t *task) {
+    task->vruntime += (uint64_t)TICKS_MS * 1000 * FAIR_WEIGHTS[20] / fair_weight(task);
+}
+
+static int fair_preempt(const pcb_t *curr, uint32_t now_ms) {
+    if (!fair_queue.head) return PREEMPT_NONE;
+    uint64_t left = fair_queue.head->pcb->vruntime;
+    if (curr->vruntime > left + FAIR_WAKEUP_GRAN_US) return PREEMPT_TAIL;
+    uint32_t slice = FAIR_LATENCY_MS / (fair_waiting + 1);
+    if (slice < FAIR_MIN_GRAN_MS) slice = FAIR_MIN_GRAN_MS;
+    return now_ms - curr->slice_start_ms >= slice && left < curr->vruntime ? PREEMPT_TAIL : PREEMPT_NONE;
+}
+
+// ---------------------------------------------------------
+// Classes batch e idle: FIFO com fatia fixa
+// ---------------------------------------------------------
+
+static queue_t batch_queue = {.head = NULL, .tail = NULL};
+static queue_t idle_queue = {.head = NULL, .tail = NULL};
+
+static void batch_enqueue(pcb_t *task, int head) {
+    if (head) {
+        push_head(&batch_queue, task);
+    } else {
+        enqueue_pcb(&batch_queue, task);
+    }
+    class_mask |= 1u << CLASS_BATCH;
+}
+
+static void batch_enqueue_batch(queue_t *batch) {
+    enqueue_batch(&batch_queue, batch);
+    class_mask |= 1u << CLASS_BATCH;
+}
+
+static pcb_t *batch_pick(void) {
+    pcb_t *task = dequeue_pcb(&batch_queue);
+    if (!batch_queue.head) class_mask &= ~(1u << CLASS_BATCH);
+    return task;
+}
+
+static int batch_preempt(const pcb_t *curr, uint32_t now_ms) {
+    return batch_queue.head && now_ms - curr->slice_start_ms >= BATCH_CLASS_SLICE_MS ?
+           PREEMPT_TAIL : PREEMPT_NONE;
+}
+
+static void idle_enqueue(pcb_t *task, int head) {
+    if (head) {
+        push_head(&idle_queue, task);
+    } else {
+        enqueue_pcb(&idle_queue, task);
+    }
+    class_mask |= 1u << CLASS_IDLE;
+}
+
+static void idle_enqueue_batch(queue_t *batch) {
+    enqueue_batch(&idle_queue, batch);
+    class_mask |= 1u << CLASS_IDLE;
+}
+
+static pcb_t *idle_pick(void) {
+    pcb_t *task = dequeue_pcb(&idle_queue);
+    if (!idle_queue.head) class_mask &= ~(1u << CLASS_IDLE);
+    return task;
+}
+
+static int idle_preempt(const pcb_t *curr, uint32_t now_ms) {
+    return idle_queue.head && now_ms - curr->slice_start_ms >= IDLE_CLASS_SLICE_MS ?
+           PREEMPT_TAIL : PREEMPT_NONE;
+}
+
+// Pilha de classes, da mais prioritária para a menos prioritária
+static const sched_class_ops_t CLASSES[NUM_CLASSES] = {
+    [CLASS_RT]    = {"rt",    rt_enqueue,    rt_enqueue_batch,    rt_pick,    no_tick,   rt_preempt},
+    [CLASS_FAIR]  = {"fair",  fair_enqueue,  fair_enqueue_batch,  fair_pick,  fair_tick, fair_preempt},
+    [CLASS_BATCH] = {"batch", batch_enqueue, batch_enqueue_batch, batch_pick, no_tick,   batch_preempt},
+    [CLASS_IDLE]  = {"idle",  idle_enqueue,  idle_enqueue_batch,  idle_pick,  no_tick,   idle_preempt},
+};
+
+static class_idx_en class_of(const pcb_t *task) {
+    switch (task->sched_class) {
+        case SCHED_CLASS_RT_FIFO:
+        case SCHED_CLASS_RT_RR:
+            return CLASS_RT;
+        case SCHED_CLASS_BATCH:
+            return CLASS_BATCH;
+        case SCHED_CLASS_IDLE:
+            return CLASS_IDLE;
+        default:
+            return CLASS_FAIR;
+    }
+}
+
+// Contabilidade por classe pedida
+typedef struct {
+    uint32_t done;
+    uint64_t latency_sum_ms;
+    uint32_t latency_max_ms;
+    uint64_t cpu_ms;
+    uint32_t preemptions;
+} class_stats_t;
+
+static class_stats_t class_stats[SCHED_CLASS_COUNT];
+
+void enqueue_classes(pcb_t *task) {
+    if (task->sched_class >= SCHED_CLASS_COUNT) task->sched_class = SCHED_CLASS_FAIR;
+    CLASSES[class_of(task)].enqueue(task, 0);
+}
+
+void enqueue_batch_classes(queue_t *batch) {
+    // Separa as chegadas por classe (religando os elementos) e entrega-as juntas
+    queue_t per_class[NUM_CLASSES] = {{NULL, NULL}};
+    while (batch->head) {
+        pcb_t *task = batch->head->pcb;
+        if (task->sched_class >= SCHED_CLASS_COUNT) task->sched_class = SCHED_CLASS_FAIR;
+        move_queue_head(&per_class[class_of(task)], batch);
+    }
+    for (int c = 0; c < NUM_CLASSES; c++) {
+        if (per_class[c].head) CLASSES[c].enqueue_batch(&per_class[c]);
+    }
+}
+
+void requeue_classes(pcb_t *task) {
+    CLASSES[class_of(task)].enqueue(task, 1);
+}
+
+/**
+ * Escalonador da pilha de classes (um CPU)
+ *
+ *  - A tarefa no CPU corre um tick; se terminou, envia DONE.
+ *  - Perde o CPU se uma classe acima da sua tiver trabalho, ou se a sua
+ *    classe o decidir (prioridade rt maior, fatia esgotada, vruntime).
+ *  - Um CPU livre recebe a próxima tarefa da classe não vazia mais
+ *    prioritária (bit menos significativo de class_mask).
+ */
+void classes_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_task) {
+    (void)rq;
+    pcb_t *curr = *cpu_task;
+    if (curr) {
+        class_idx_en c = class_of(curr);
+        curr->ellapsed_time_ms += TICKS_MS;
+        CLASSES[c].tick(curr);
+        class_stats[curr->sched_class].cpu_ms += TICKS_MS;
+
+        if (curr->ellapsed_time_ms >= curr->time_ms) {
+            msg_t msg = {
+                .pid = curr->pid,
+                .tid = curr->tid,
+                .request = PROCESS_REQUEST_DONE,
+                .time_ms = current_time_ms
+            };
+            if (channel_send(curr->sockfd, &msg) < 0) {
+                perror("write");
+            }
+            class_stats_t *cs = &class_stats[curr->sched_class];
+            uint32_t latency = current_time_ms - curr->arrival_time_ms;
+            cs->done++;
+            cs->latency_sum_ms += latency;
+            if (latency > cs->latency_max_ms) cs->latency_max_ms = latency;
+            stats_burst_done(curr, current_time_ms);
+            free_pcb(curr);
+            curr = NULL;
+        } else {
+            // Uma classe acima com trabalho ganha sempre; senão decide a classe
+            int how = (class_mask & ((1u << c) - 1)) ? PREEMPT_HEAD : CLASSES[c].preempt(curr, current_time_ms);
+            if (how != PREEMPT_NONE) {
+                class_stats[curr->sched_class].preemptions++;
+                CLASSES[c].enqueue(curr, how == PREEMPT_HEAD);
+                curr = NULL;
+            } else if (!(class_mask & (1u << c))) {
+                // Ninguém à espera na classe: a fatia recomeça
+                curr->slice_start_ms = current_time_ms;
+            }
+        }
+    }
+
+    if (!curr && class_mask) {
+        curr = CLASSES[__builtin_ctz(class_mask)].pick();
+        curr->slice_start_ms = current_time_ms;
+    }
+    *cpu_task = curr;
+}
+
+void classes_report(FILE *out) {
+    fprintf(out, "---- Scheduling classes (");
+    for (int c = 0; c < NUM_CLASSES; c++) fprintf(out, "%s%s", c ? " > " : "", CLASSES[c].name);
+    fprintf(out, ") ----\n");
+    fprintf(out, "%-8s %7s %10s %10s %9s %8s\n",
+            "class", "bursts", "mean.lat", "max.lat", "cpu.ms", "preempt");
+    for (int k = 0; k < SCHED_CLASS_COUNT; k++) {
+        const class_stats_t *cs = &class_stats[k];
+        if (cs->done == 0 && cs->cpu_ms == 0) continue;
+        fprintf(out, "%-8s %7u %10.1f %10u %9llu %8u\n",
+                SCHED_CLASS_STRINGS[k], cs->done,
+                cs->done ? (double)cs->latency_sum_ms / cs->done : 0.0, cs->latency_max_ms,
+                (unsigned long long)cs->cpu_ms, cs->preemptions);
+    }
+    fflush(out);
+}
+
+void classes_free(void) {
+    for (int l = 0; l < RT_PRIO_LEVELS; l++) free_queue(&rt_queues[l]);
+    free_queue(&fair_queue);
+    free_queue(&batch_queue);
+    free_queue(&idle_queue);
+    rt_bitmap = 0;
+    class_mask = 0;
+    fair_waiting = 0;
+}
@@ -0,0 +1,72 @@
+#ifndef CLASSES_H
+#define CLASSES_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "queue.h"
+
+/*
+ * Pilha de classes de escalonamento (política CLASSES), como no Linux.
+ *
+ * Cada pedido RUN escolhe a sua classe (msg.sched_class, ver msg.h) e cada
+ * classe tem a sua própria fila de prontos:
+ *
+ *   rt     SCHED_CLASS_RT_FIFO e SCHED_CLASS_RT_RR partilham um vetor de
+ *          RT_PRIO_LEVELS filas indexado pelo nice (0 é o mais prioritário)
+ *          com um bitmap dos níveis ocupados; RT_RR roda a cada RT_RR_SLICE_MS
+ *          entre tarefas do mesmo nível, RT_FIFO só larga o CPU para um nível
+ *          mais prioritário.
+ *   fair   ordenada pelo vruntime (tempo de CPU pesado pelo nice, com os
+ *          pesos do CFS); a tarefa com menor vruntime corre durante
+ *          FAIR_LATENCY_MS repartidos pelas que esperam.
+ *   batch  FIFO com fatias longas (BATCH_CLASS_SLICE_MS) entre si.
+ *   idle   FIFO; só corre quando nenhuma outra classe tem trabalho.
+ *
+ * Entre classes a prioridade é estrita: em cada tick, uma tarefa perde o CPU
+ * se houver trabalho numa classe acima da sua. A classe a servir é o bit
+ * menos significativo do bitmap das classes não vazias, em O(1).
+ */
+
+#define RT_PRIO_LEVELS 32           // níveis de prioridade da classe rt
+#define RT_RR_SLICE_MS 100          // fatia do RT_RR (RR_TIMESLICE do Linux)
+#define FAIR_LATENCY_MS 60          // período em que todas as tarefas fair correm
+#define FAIR_MIN_GRAN_MS 10         // fatia mínima de uma tarefa fair (um tick)
+#define FAIR_WAKEUP_GRAN_US 10000   // avanço de vruntime que justifica preempção
+#define BATCH_CLASS_SLICE_MS 500
+#define IDLE_CLASS_SLICE_MS 100
+
+/**
+ * @brief Um pedido RUN entra na fila da sua classe (pcb->sched_class)
+ */
+void enqueue_classes(pcb_t *task);
+
+/**
+ * @brief Os pedidos RUN de um tick entram nas filas das suas classes (batch fica vazia)
+ *
+ * Mesmo resultado que enqueue_classes() para cada tarefa, pela ordem da
+ * lista, mas cada classe recebe as suas de uma vez: a fair ordena-as e
+ * junta-as à sua fila numa só passagem.
+ */
+void enqueue_batch_classes(queue_t *batch);
+
+/**
+ * @brief Devolve à fila da sua classe, à cabeça, uma tarefa desalojada
+ */
+void requeue_classes(pcb_t *task);
+
+/**
+ * @brief Escalonador de um CPU (rq não é usada: as filas são das classes)
+ */
+void classes_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_task);
+
+/**
+ * @brief Imprime, por classe, os bursts terminados, a latência e o CPU usado
+ */
+void classes_report(FILE *out);
+
+/**
+ * @brief Liberta as tarefas que ficaram nas filas das classes
+ */
+void classes_free(void);
+
+#endif //CLASSES_H
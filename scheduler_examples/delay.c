@@ -0,0 +1,351 @@
+#include "delay.h"
+#include "msg.h"
+#include "workload.h"
+#include <stdlib.h>
+
+/**
+ * Tabelas da atribuição
+ *
+ * procs: PID → posição na lista dos processos com threads executáveis
+ * (active), para que cada tick só percorra esses. pairs: (vítima,
+ * bloqueador) → ms de espera. As duas são tabelas de dispersão com
+ * endereçamento aberto, como a contabilidade por processo do stats.c.
+ */
+
+typedef struct {
+    int32_t pid;
+    int used;
+    int32_t active;             // índice em active[] (-1 sem threads executáveis)
+} delay_proc_t;
+
+typedef struct {
+    int32_t pid;
+    uint32_t runnable;          // threads prontas + no CPU
+} delay_active_t;
+
+typedef struct {
+    int32_t victim;
+    int32_t blocker;
+    int used;
+    double ms;
+} delay_pair_t;
+
+static int enabled = 0;
+static uint32_t top_n = 0;
+
+static delay_proc_t *procs = NULL;
+static uint32_t procs_cap = 0;
+static uint32_t procs_used = 0;
+
+static delay_active_t *active = NULL;
+static uint32_t nactive = 0;
+static uint32_t active_cap = 0;
+
+static delay_pair_t *pairs = NULL;
+static uint32_t pairs_cap = 0;
+static uint32_t pairs_used = 0;
+
+void delay_enable(uint32_t n) {
+    enabled = 1;
+    top_n = n;
+}
+
+static delay_proc_t *proc_slot(delay_proc_t *table, uint32_t cap, int32_t pid) {
+    uint32_t i = ((uint32_t)pid * 2654435761u) & (cap - 1);
+    while (table[i].used && table[i].pid != pid) i = (i + 1) & (cap - 1);
+    return &table[i];
+}
+
+static delay_proc_t *proc_lookup(int32_t pid) {
+    if ((procs_used + 1) * 10 > procs_cap * 7) {
+        // Duplica a tabela quando passa 70% de ocupação
+        uint32_t cap = procs_cap ? procs_cap * 2 : 64;
+        delay_proc_t *table = calloc(cap, sizeof(delay_proc_t));
+        if (!table) return NULL;
+        for (uint32_t i = 0; i < procs_cap; i++) {
+            if (procs[i].used) *proc_slot(table, cap, procs[i].pid) = procs[i];
+        }
+        free(procs);
+        procs = table;
+        procs_cap = cap;
+    }
+    delay_proc_t *p = proc_slot(procs, procs_cap, pid);
+    if (!p->used) {
+        p->used = 1;
+        p->pid = pid;
+        p->active = -1;
+        procs_used++;
+    }
+    return p;
+}
+
+static delay_pair_t *pair_slot(delay_pair_t *table, uint32_t cap, int32_t victim, int32_t blocker) {
+    uint32_t i = ((uint32_t)victim * 2654435761u ^ (uint32_t)blocker * 40503u) & (cap - 1);
+    while (table[i].used && (table[i].victim != victim || table[i].blocker != blocker)) {
+        i = (i + 1) & (cap - 1);
+    }
+    return &table[i];
+}
+
+static void charge(int32_t victim, int32_t blocker, double ms) {
+    if ((pairs_used + 1) * 10 > pairs_cap * 7) {
+        uint32_t cap = pairs_cap ? pairs_cap * 2 : 256;
+        delay_pair_t *table = calloc(cap, sizeof(delay_pair_t));
+        if (!table) return;
+        for (uint32_t i = 0; i < pairs_cap; i++) {
+            if (pairs[i].used) *pair_slot(table, cap, pairs[i].victim, pairs[i].blocker) = pairs[i];
+        }
+        free(pairs);
+        pairs = table;
+        pairs_cap = cap;
+    }
+    delay_pair_t *p = pair_slot(pairs, pairs_cap, victim, blocker);
+    if (!p->used) {
+        p->used = 1;
+        p->victim = victim;
+        p->blocker = blocker;
+        pairs_used++;
+    }
+    p->ms += ms;
+}
+
+void delay_task_admitted(const pcb_t *task) {
+    if (!enabled) return;
+    delay_proc_t *p = proc_lookup(task->pid);
+    if (!p) return;
+    if (p->active < 0) {
+        if (nactive == active_cap) {
+            uint32_t cap = active_cap ? active_cap * 2 : 64;
+            delay_active_t *a = realloc(active, cap * sizeof(delay_active_t));
+            if (!a) return;
+            active = a;
+            active_cap = cap;
+        }
+        p->active = (int32_t)nactive;
+        active[nactive++] = (delay_active_t){.pid = task->pid, .runnable = 0};
+    }
+    active[p->active].runnable++;
+}
+
+void delay_burst_done(const pcb_t *task) {
+    if (!enabled || procs_cap == 0) return;
+    delay_proc_t *p = proc_slot(procs, procs_cap, task->pid);
+    if (!p->used || p->active < 0) return;
+    delay_active_t *a = &active[p->active];
+    if (a->runnable > 0) a->runnable--;
+    if (a->runnable > 0) return;
+    // Sai da lista: o último ocupa o seu lugar
+    active[p->active] = active[--nactive];
+    if ((uint32_t)p->active < nactive) proc_slot(procs, procs_cap, active[p->active].pid)->active = p->active;
+    p->active = -1;
+}
+
+void delay_tick(pcb_t *const *cpu_tasks, int ncpus) {
+    if (!enabled || nactive == 0 || ncpus == 0) return;
+
+    // Ocupantes dos CPUs agrupados por processo: CPUs que ocupam e threads
+    // distintas que lá têm (um job batch ocupa vários CPUs com uma só)
+    int32_t occ_pid[MAX_CPUS];
+    uint32_t occ_cpus[MAX_CPUS];
+    uint32_t occ_tasks[MAX_CPUS];
+    int nocc = 0;
+    uint32_t idle = 0;
+    for (int c = 0; c < ncpus; c++) {
+        const pcb_t *t = cpu_tasks[c];
+        if (!t) {
+            idle++;
+            continue;
+        }
+        int seen = 0;
+        for (int d = 0; d < c && !seen; d++) seen = cpu_tasks[d] == t;
+        int k = 0;
+        while (k < nocc && occ_pid[k] != t->pid) k++;
+        if (k == nocc) {
+            occ_pid[k] = t->pid;
+            occ_cpus[k] = 0;
+            occ_tasks[k] = 0;
+            nocc++;
+        }
+        occ_cpus[k]++;
+        if (!seen) occ_tasks[k]++;
+    }
+
+    for (uint32_t i = 0; i < nactive; i++) {
+        int32_t pid = active[i].pid;
+        uint32_t running = 0;
+        for (int k = 0; k < nocc; k++) {
+            if (occ_pid[k] == pid) running = occ_tasks[k];
+        }
+        if (active[i].runnable <= running) continue;
+        // Cada thread em espera perde TICKS_MS, repartidos pelos CPUs
+        double share = (double)(active[i].runnable - running) * TICKS_MS / ncpus;
+        for (int k = 0; k < nocc; k++) charge(pid, occ_pid[k], share * occ_cpus[k]);
+        if (idle) charge(pid, DELAY_IDLE_PID, share * idle);
+    }
+}
+
+// ---------------------------------------------------------
+// Relatório
+// ---------------------------------------------------------
+
+static const char *label(int32_t pid, char *buf, size_t len) {
+    if (pid == DELAY_IDLE_PID) return "(idle)";
+    const char *name = workload_name(pid);
+    if (name) return name;
+    snprintf(buf, len, "%d", (int)pid);
+    return buf;
+}
+
+// Por vítima e, dentro de cada uma, do maior atraso para o menor
+static int by_victim_ms(const void *a, const void *b) {
+    const delay_pair_t *pa = a, *pb = b;
+    if (pa->victim != pb->victim) return (pa->victim > pb->victim) - (pa->victim < pb->victim);
+    return (pa->ms < pb->ms) - (pa->ms > pb->ms);
+}
+
+static int by_pid(const void *a, const void *b) {
+    int32_t pa = *(const int32_t *)a, pb = *(const int32_t *)b;
+    return (pa > pb) - (pa < pb);
+}
+
+// Procura pid numa lista ordenada
+static int index_of(const int32_t *list, uint32_t n, int32_t pid) {
+    const int32_t *p = bsearch(&pid, list, n, sizeof(int32_t), by_pid);
+    return p ? (int)(p - list) : -1;
+}
+
+void delay_report(FILE *out) {
+    if (!enabled) return;
+
+    // Compacta os pares e ordena-os por vítima (a tabela deixa de servir)
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < pairs_cap; i++) {
+        if (pairs[i].used) pairs[n++] = pairs[i];
+    }
+    // Sem espera nenhuma a tabela pode nem existir (pairs == NULL)
+    if (n == 0) {
+        fprintf(out, "---- Delay attribution (0 ms of ready wait, charged to the tasks on the CPUs) ----\n");
+        fprintf(out, "No task waited in the ready queue\n");
+        fflush(out);
+        return;
+    }
+    qsort(pairs, n, sizeof(delay_pair_t), by_victim_ms);
+
+    // Processos envolvidos (vítimas e bloqueadores, sem o idle) e espera total de cada vítima
+    int32_t *pids = malloc((2 * n + 1) * sizeof(int32_t));
+    double *wait = calloc(2 * n + 1, sizeof(double));
+    double *caused = calloc(2 * n + 1, sizeof(double));
+    if (!pids || !wait || !caused) {
+        free(pids);
+        free(wait);
+        free(caused);
+        return;
+    }
+    uint32_t np = 0;
+    int has_idle = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        pids[np++] = pairs[i].victim;
+        if (pairs[i].blocker == DELAY_IDLE_PID) {
+            has_idle = 1;
+        } else {
+            pids[np++] = pairs[i].blocker;
+        }
+    }
+    qsort(pids, np, sizeof(int32_t), by_pid);
+    uint32_t u = 0;
+    for (uint32_t i = 0; i < np; i++) {
+        if (u == 0 || pids[u - 1] != pids[i]) pids[u++] = pids[i];
+    }
+    np = u;
+
+    double total = 0.0;
+    for (uint32_t i = 0; i < n; i++) {
+        int v = index_of(pids, np, pairs[i].victim);
+        wait[v] += pairs[i].ms;
+        total += pairs[i].ms;
+        if (pairs[i].blocker != DELAY_IDLE_PID) caused[index_of(pids, np, pairs[i].blocker)] += pairs[i].ms;
+    }
+
+    char a[16], b[16];
+    fprintf(out, "---- Delay attribution (%.0f ms of ready wait, charged to the tasks on the CPUs) ----\n", total);
+
+    // Matriz: linhas esperaram, colunas estavam no CPU
+    if (np <= DELAY_MATRIX_MAX) {
+        fprintf(out, "%-12s", "waited\\held");
+        for (uint32_t j = 0; j < np; j++) fprintf(out, " %9.9s", label(pids[j], a, sizeof(a)));
+        if (has_idle) fprintf(out, " %9s", "(idle)");
+        fprintf(out, "\n");
+        double *row = calloc(np + 1, sizeof(double));
+        for (uint32_t i = 0; row && i < np; i++) {
+            if (wait[i] <= 0.0) continue;
+            for (uint32_t j = 0; j <= np; j++) row[j] = 0.0;
+            for (uint32_t k = 0; k < n; k++) {
+                if (pairs[k].victim != pids[i]) continue;
+                int j = pairs[k].blocker == DELAY_IDLE_PID ? (int)np : index_of(pids, np, pairs[k].blocker);
+                row[j] += pairs[k].ms;
+            }
+            fprintf(out, "%-12.12s", label(pids[i], a, sizeof(a)));
+            for (uint32_t j = 0; j < np; j++) fprintf(out, " %9.0f", row[j]);
+            if (has_idle) fprintf(out, " %9.0f", row[np]);
+            fprintf(out, "\n");
+        }
+        free(row);
+    } else {
+        fprintf(out, "(%u processes: matrix omitted, see the top blockers)\n", np);
+    }
+
+    // N maiores bloqueadores de cada processo (os pares já vêm ordenados)
+    fprintf(out, "%-12s %10s  %s\n", "process", "wait.ms", "top blockers (ms, % of its wait)");
+    for (uint32_t i = 0; i < n;) {
+        int32_t victim = pairs[i].victim;
+        double w = wait[index_of(pids, np, victim)];
+        fprintf(out, "%-12.12s %10.0f ", label(victim, a, sizeof(a)), w);
+        uint32_t shown = 0;
+        for (; i < n && pairs[i].victim == victim; i++) {
+            if (shown++ >= top_n) continue;
+            const char *who = pairs[i].blocker == victim ? "(self)" : label(pairs[i].blocker, b, sizeof(b));
+            fprintf(out, " %s %.0f (%.0f%%)", who, pairs[i].ms, w > 0 ? 100.0 * pairs[i].ms / w : 0.0);
+        }
+        fprintf(out, "\n");
+    }
+
+    // Comboios: quem causou a maior parte da espera de vários outros processos
+    // e da espera total
+    for (uint32_t j = 0; j < np; j++) {
+        uint32_t victims = 0;
+        double ms = 0.0;
+        for (uint32_t k = 0; k < n; k++) {
+            if (pairs[k].blocker != pids[j] || pairs[k].victim == pids[j]) continue;
+            double w = wait[index_of(pids, np, pairs[k].victim)];
+            if (pairs[k].ms * 100.0 >= w * DELAY_CONVOY_SHARE) {
+                victims++;
+                ms += pairs[k].ms;
+            }
+        }
+        if (victims >= DELAY_CONVOY_VICTIMS && caused[j] * 100.0 >= total * DELAY_CONVOY_TOTAL) {
+            fprintf(out, "Convoy: %s caused %d %% or more of the wait of %u processes (%.0f ms), %.1f %% of all wait\n",
+                    label(pids[j], a, sizeof(a)), DELAY_CONVOY_SHARE, victims, ms,
+                    total > 0 ? 100.0 * caused[j] / total : 0.0);
+        }
+    }
+    fflush(out);
+    free(pids);
+    free(wait);
+    free(caused);
+
+    // A tabela deixou de estar organizada por dispersão
+    free(pairs);
+    pairs = NULL;
+    pairs_cap = 0;
+    pairs_used = 0;
+}
+
+void delay_free(void) {
+    free(procs);
+    free(active);
+    free(pairs);
+    procs = NULL;
+    active = NULL;
+    pairs = NULL;
+    procs_cap = procs_used = nactive = active_cap = pairs_cap = pairs_used = 0;
+}
@@ -0,0 +1,64 @@
+#ifndef DELAY_H
+#define DELAY_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "queue.h"
+
+/*
+ * Atribuição do atraso (--delay-report N): quem atrasou quem.
+ *
+ * Em cada tick, cada thread executável que não está num CPU espera
+ * TICKS_MS ms. Essa espera é dividida pelos CPUs online e cada parte é
+ * atribuída ao processo que ocupa esse CPU (um job batch em k CPUs leva k
+ * partes; um CPU livre conta como "(idle)", o atraso que é da política).
+ * Tudo é calculado incrementalmente, com os pedidos admitidos e os bursts
+ * terminados (ver stats.c) e os CPUs no fim de cada tick.
+ *
+ * O relatório mostra a matriz "quem atrasou quem" (linhas: processo que
+ * esperou; colunas: processo no CPU), os N maiores bloqueadores de cada
+ * processo e os comboios: um processo que causou pelo menos
+ * DELAY_CONVOY_SHARE % da espera de DELAY_CONVOY_VICTIMS ou mais outros
+ * processos e DELAY_CONVOY_TOTAL % de toda a espera (como o C-5.csv com
+ * FIFO, à frente de A e B; com RR a espera reparte-se e não há comboio).
+ */
+
+#define DELAY_IDLE_PID INT32_MIN       // "bloqueador" dos CPUs livres
+#define DELAY_MATRIX_MAX 12            // processos até aos quais se mostra a matriz
+#define DELAY_CONVOY_SHARE 60          // % da espera de uma vítima causada pelo bloqueador
+#define DELAY_CONVOY_VICTIMS 2         // vítimas para ser considerado um comboio
+#define DELAY_CONVOY_TOTAL 50          // % de toda a espera causada pelo bloqueador
+
+/**
+ * @brief Liga a atribuição, com os top_n maiores bloqueadores por processo no relatório
+ */
+void delay_enable(uint32_t top_n);
+
+/**
+ * @brief Um pedido RUN passou a executável (chamada por stats_task_admitted())
+ */
+void delay_task_admitted(const pcb_t *task);
+
+/**
+ * @brief Um burst terminou (chamada por stats_burst_done())
+ */
+void delay_burst_done(const pcb_t *task);
+
+/**
+ * @brief Atribui a espera deste tick aos ocupantes dos CPUs online
+ *
+ * Deve ser chamada uma vez por tick, depois do escalonador.
+ */
+void delay_tick(pcb_t *const *cpu_tasks, int ncpus);
+
+/**
+ * @brief Imprime a matriz, os maiores bloqueadores e os comboios
+ */
+void delay_report(FILE *out);
+
+/**
+ * @brief Liberta as tabelas da atribuição
+ */
+void delay_free(void);
+
+#endif //DELAY_H
@@ -0,0 +1,385 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "trace.h"
+
+/*
+ * sched-diff: compares two traces of the same workload (ossim --trace FILE).
+ *
+ * Both traces are read in lockstep, one tick at a time. The events of a tick
+ * are compared as a set (sorted by type, pid, tid and CPU), so the order in
+ * which the simulator wrote them does not matter. The first tick with a
+ * difference is reported together with the ready queue of each run at that
+ * moment, rebuilt from the ARRIVE/PREEMPT/DISPATCH/DONE events. The rest of
+ * the traces is then only used for the per-pid turnaround deltas.
+ *
+ * Memory is proportional to the number of live threads and pids, not to the
+ * length of the traces, and each record is handled once.
+ *
+ * Run like: ./sched-diff [--by-order] [--ignore-cpu] [--top N] A.bin B.bin
+ */
+
+#define MAX_QUEUE_PRINT 16
+
+static const char *TYPE_NAMES[] = {"ARRIVE", "DISPATCH", "PREEMPT", "DONE", "BLOCK", "UNBLOCK"};
+
+// Ready queue entry (doubly linked list over a growable array)
+typedef struct {
+    int32_t pid;
+    uint32_t tid;
+    int prev, next;
+} qnode_t;
+
+typedef struct {
+    int32_t pid;
+    uint32_t first_ms;         // first request
+    uint32_t last_ms;          // last DONE or end of BLOCK
+} pid_stat_t;
+
+typedef struct {
+    const char *path;
+    trace_reader_t rd;
+
+    // Ready queue rebuilt from the events
+    qnode_t *nodes;
+    int nodes_cap, nnodes, free_node;
+    int head, tail, qlen;
+    trace_map_t where;         // (pid, tid) -> node
+
+    // Per-pid turnaround
+    pid_stat_t *pids;
+    int npids, pids_cap;
+    trace_map_t pid_index;     // pid -> pids[]
+
+    trace_map_t order;         // --by-order: pid -> order of first appearance
+    int norder;
+
+    // Events of the current tick
+    trace_rec_t *group;
+    int ngroup, group_cap;
+} run_t;
+
+static int by_order = 0;
+static int ignore_cpu = 0;
+
+static int oom(void) {
+    fprintf(stderr, "sched-diff: out of memory\n");
+    exit(EXIT_FAILURE);
+}
+
+static void queue_push(run_t *r, int32_t pid, uint32_t tid) {
+    int *w = trace_map_get(&r->where, trace_key(pid, tid));
+    if (!w) oom();
+    if (*w >= 0) return;                   // already queued
+    int n = r->free_node;
+    if (n >= 0) {
+        r->free_node = r->nodes[n].next;
+    } else {
+        if (r->nnodes == r->nodes_cap) {
+            r->nodes_cap = r->nodes_cap ? r->nodes_cap * 2 : 256;
+            r->nodes = realloc(r->nodes, (size_t)r->nodes_cap * sizeof(qnode_t));
+            if (!r->nodes) oom();
+        }
+        n = r->nnodes++;
+    }
+    r->nodes[n] = (qnode_t){.pid = pid, .tid = tid, .prev = r->tail, .next = -1};
+    if (r->tail >= 0) r->nodes[r->tail].next = n; else r->head = n;
+    r->tail = n;
+    r->qlen++;
+    *w = n;
+}
+
+static void queue_remove(run_t *r, int32_t pid, uint32_t tid) {
+    int *w = trace_map_get(&r->where, trace_key(pid, tid));
+    if (!w) oom();
+    int n = *w;
+    if (n < 0) return;
+    qnode_t *q = &r->nodes[n];
+    if (q->prev >= 0) r->nodes[q->prev].next = q->next; else r->head = q->next;
+    if (q->next >= 0) r->nodes[q->next].prev = q->prev; else r->tail = q->prev;
+    q->next = r->free_node;
+    r->free_node = n;
+    r->qlen--;
+    *w = -1;
+}
+
+static pid_stat_t *pid_stat(run_t *r, int32_t pid, uint32_t now_ms) {
+    int *i = trace_map_get(&r->pid_index, trace_key(pid, 0));
+    if (!i) oom();
+    if (*i < 0) {
+        if (r->npids == r->pids_cap) {
+            r->pids_cap = r->pids_cap ? r->pids_cap * 2 : 256;
+            r->pids = realloc(r->pids, (size_t)r->pids_cap * sizeof(pid_stat_t));
+            if (!r->pids) oom();
+        }
+        *i = r->npids++;
+        r->pids[*i] = (pid_stat_t){.pid = pid, .first_ms = now_ms, .last_ms = now_ms};
+    }
+    return &r->pids[*i];
+}
+
+// Applies one event to the rebuilt state of the run
+static void apply(run_t *r, const trace_rec_t *e) {
+    switch (e->type) {
+        case TRACE_ARRIVE:
+            pid_stat(r, e->pid, e->time_ms);
+            queue_push(r, e->pid, e->tid);
+            break;
+        case TRACE_PREEMPT:
+            queue_push(r, e->pid, e->tid);
+            break;
+        case TRACE_DISPATCH:
+            queue_remove(r, e->pid, e->tid);
+            break;
+        case TRACE_DONE:
+        case TRACE_UNBLOCK:
+            if (e->type == TRACE_DONE) queue_remove(r, e->pid, e->tid);
+            pid_stat(r, e->pid, e->time_ms)->last_ms = e->time_ms;
+            break;
+        case TRACE_BLOCK:
+            pid_stat(r, e->pid, e->time_ms);
+            break;
+        default:
+            break;
+    }
+}
+
+static int is_decision(const trace_rec_t *e) {
+    return e->type == TRACE_DISPATCH || e->type == TRACE_PREEMPT;
+}
+
+static int rec_cmp(const void *a, const void *b) {
+    const trace_rec_t *x = a, *y = b;
+    if (x->type != y->type) return x->type < y->type ? -1 : 1;
+    if (x->pid != y->pid) return x->pid < y->pid ? -1 : 1;
+    if (x->tid != y->tid) return x->tid < y->tid ? -1 : 1;
+    if (x->cpu != y->cpu) return x->cpu < y->cpu ? -1 : 1;
+    return 0;
+}
+
+/**
+ * Reads all the events of tick t (the next time in the trace must be >= t),
+ * with pids replaced by their order of appearance under --by-order.
+ */
+static void read_tick(run_t *r, uint32_t t) {
+    r->ngroup = 0;
+    const trace_rec_t *e;
+    while ((e = trace_reader_peek(&r->rd)) != NULL && e->time_ms == t) {
+        if (r->ngroup == r->group_cap) {
+            r->group_cap = r->group_cap ? r->group_cap * 2 : 64;
+            r->group = realloc(r->group, (size_t)r->group_cap * sizeof(trace_rec_t));
+            if (!r->group) oom();
+        }
+        trace_rec_t *g = &r->group[r->ngroup++];
+        *g = *trace_reader_next(&r->rd);
+        if (by_order) {
+            int *o = trace_map_get(&r->order, trace_key(g->pid, 0));
+            if (!o) oom();
+            if (*o < 0) *o = r->norder++;
+            g->pid = *o;
+        }
+        if (ignore_cpu) g->cpu = 0;
+    }
+    qsort(r->group, (size_t)r->ngroup, sizeof(trace_rec_t), rec_cmp);
+}
+
+static void print_queue(const run_t *r, const char *label) {
+    printf("  ready queue %s (%d):", label, r->qlen);
+    int k = 0;
+    for (int n = r->head; n >= 0 && k < MAX_QUEUE_PRINT; n = r->nodes[n].next, k++) {
+        printf(" %d.%u", r->nodes[n].pid, r->nodes[n].tid);
+    }
+    if (r->qlen > MAX_QUEUE_PRINT) printf(" ...");
+    printf("\n");
+}
+
+// Prints the events of the tick that are only in one of the runs
+static void print_difference(const run_t *a, const run_t *b) {
+    int i = 0, j = 0;
+    while (i < a->ngroup || j < b->ngroup) {
+        int c = (i == a->ngroup) ? 1 : (j == b->ngroup) ? -1 : rec_cmp(&a->group[i], &b->group[j]);
+        if (c == 0) {
+            i++;
+            j++;
+            continue;
+        }
+        const trace_rec_t *e = c < 0 ? &a->group[i++] : &b->group[j++];
+        printf("  only in %s: %-8s %d.%u", c < 0 ? "A" : "B", TYPE_NAMES[e->type], e->pid, e->tid);
+        if (is_decision(e)) printf(" on CPU %u", e->cpu);
+        printf("\n");
+    }
+}
+
+static int groups_equal(const run_t *a, const run_t *b, int decisions) {
+    int na = 0, nb = 0;
+    for (int i = 0; i < a->ngroup; i++) na += is_decision(&a->group[i]) == decisions;
+    for (int i = 0; i < b->ngroup; i++) nb += is_decision(&b->group[i]) == decisions;
+    if (na != nb) return 0;
+    int i = 0, j = 0;
+    while (i < a->ngroup && j < b->ngroup) {
+        if (is_decision(&a->group[i]) != decisions) { i++; continue; }
+        if (is_decision(&b->group[j]) != decisions) { j++; continue; }
+        if (rec_cmp(&a->group[i], &b->group[j]) != 0) return 0;
+        i++;
+        j++;
+    }
+    return 1;
+}
+
+static int run_open(run_t *r, const char *path) {
+    memset(r, 0, sizeof(*r));
+    r->path = path;
+    r->head = r->tail = r->free_node = -1;
+    return trace_reader_open(&r->rd, path);
+}
+
+static void run_free(run_t *r) {
+    trace_reader_close(&r->rd);
+    trace_map_free(&r->where);
+    trace_map_free(&r->pid_index);
+    trace_map_free(&r->order);
+    free(r->nodes);
+    free(r->pids);
+    free(r->group);
+}
+
+typedef struct {
+    int32_t pid;
+    int64_t a_ms, b_ms;        // turnaround in each run (-1 if missing)
+} delta_t;
+
+static int by_delta(const void *x, const void *y) {
+    const delta_t *p = x, *q = y;
+    int64_t dp = (p->a_ms < 0 || p->b_ms < 0) ? -1 : llabs(p->b_ms - p->a_ms);
+    int64_t dq = (q->a_ms < 0 || q->b_ms < 0) ? -1 : llabs(q->b_ms - q->a_ms);
+    if (dp != dq) return dp > dq ? -1 : 1;
+    return (p->pid > q->pid) - (p->pid < q->pid);
+}
+
+static void print_turnaround(run_t *a, run_t *b, int top) {
+    delta_t *d = malloc((size_t)(a->npids + b->npids + 1) * sizeof(delta_t));
+    if (!d) oom();
+    int n = 0;
+    for (int i = 0; i < a->npids; i++) {
+        pid_stat_t *pa = &a->pids[i];
+        int *j = trace_map_get(&b->pid_index, trace_key(pa->pid, 0));
+        if (!j) oom();
+        d[n++] = (delta_t){pa->pid, pa->last_ms - pa->first_ms,
+                           *j >= 0 ? (int64_t)(b->pids[*j].last_ms - b->pids[*j].first_ms) : -1};
+    }
+    for (int i = 0; i < b->npids; i++) {
+        int *j = trace_map_get(&a->pid_index, trace_key(b->pids[i].pid, 0));
+        if (!j) oom();
+        if (*j < 0) d[n++] = (delta_t){b->pids[i].pid, -1, b->pids[i].last_ms - b->pids[i].first_ms};
+    }
+
+    double sum_a = 0.0, sum_b = 0.0;
+    int both = 0, better = 0, worse = 0;
+    for (int i = 0; i < n; i++) {
+        if (d[i].a_ms < 0 || d[i].b_ms < 0) continue;
+        both++;
+        sum_a += (double)d[i].a_ms;
+        sum_b += (double)d[i].b_ms;
+        if (d[i].b_ms < d[i].a_ms) better++;
+        if (d[i].b_ms > d[i].a_ms) worse++;
+    }
+    qsort(d, (size_t)n, sizeof(delta_t), by_delta);
+
+    printf("Per-pid turnaround (first request to last DONE or end of BLOCK), %d pids:\n", n);
+    printf("%10s %10s %10s %10s\n", "pid", "A(ms)", "B(ms)", "delta");
+    for (int i = 0; i < n && i < top; i++) {
+        printf("%10d ", d[i].pid);
+        if (d[i].a_ms >= 0) printf("%10lld ", (long long)d[i].a_ms); else printf("%10s ", "-");
+        if (d[i].b_ms >= 0) printf("%10lld ", (long long)d[i].b_ms); else printf("%10s ", "-");
+        if (d[i].a_ms >= 0 && d[i].b_ms >= 0) printf("%+10lld\n", (long long)(d[i].b_ms - d[i].a_ms));
+        else printf("%10s\n", "-");
+    }
+    if (n > top) printf("%10s (%d more)\n", "...", n - top);
+    if (both > 0) {
+        printf("Mean turnaround: A %.1f ms, B %.1f ms (%+.1f ms); B faster for %d pids, slower for %d\n",
+               sum_a / both, sum_b / both, (sum_b - sum_a) / both, better, worse);
+    }
+    free(d);
+}
+
+int main(int argc, char *argv[]) {
+    int top = 20;
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (!strcmp(argv[i], "--by-order")) {
+            by_order = 1;
+        } else if (!strcmp(argv[i], "--ignore-cpu")) {
+            ignore_cpu = 1;
+        } else if (!strcmp(argv[i], "--top") && i + 1 < argc) {
+            char *end;
+            errno = 0;
+            long v = strtol(argv[++i], &end, 10);
+            if (errno != 0 || *end != '\0' || v < 0 || v > 1000000) {
+                fprintf(stderr, "Invalid value for --top: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            top = (int)v;
+        } else {
+            break;
+        }
+    }
+    if (argc - i != 2) {
+        printf("Usage: %s [--by-order] [--ignore-cpu] [--top N] <A.bin> <B.bin>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    run_t a, b;
+    if (run_open(&a, argv[i]) < 0) return EXIT_FAILURE;
+    if (run_open(&b, argv[i + 1]) < 0) {
+        run_free(&a);
+        return EXIT_FAILURE;
+    }
+    printf("A: %s (%s, %u CPUs)\nB: %s (%s, %u CPUs)\n",
+           a.path, a.rd.header.policy, a.rd.header.ncpus,
+           b.path, b.rd.header.policy, b.rd.header.ncpus);
+
+    uint64_t same = 0;
+    int diverged = 0;
+    for (;;) {
+        const trace_rec_t *ea = trace_reader_peek(&a.rd);
+        const trace_rec_t *eb = trace_reader_peek(&b.rd);
+        if (!ea && !eb) break;
+        uint32_t t = !ea ? eb->time_ms : !eb ? ea->time_ms
+                   : (ea->time_ms < eb->time_ms ? ea->time_ms : eb->time_ms);
+        read_tick(&a, t);
+        read_tick(&b, t);
+
+        // Arrivals, DONE and I/O first: the queues are then as the schedulers saw them
+        for (int k = 0; k < a.ngroup; k++) if (!is_decision(&a.group[k])) apply(&a, &a.group[k]);
+        for (int k = 0; k < b.ngroup; k++) if (!is_decision(&b.group[k])) apply(&b, &b.group[k]);
+
+        if (!diverged) {
+            int events = groups_equal(&a, &b, 0);
+            int decisions = groups_equal(&a, &b, 1);
+            if (events && decisions) {
+                same += (uint64_t)a.ngroup;
+            } else {
+                diverged = 1;
+                printf("First divergence at %u ms (%s), after %llu identical events\n", t,
+                       decisions ? "different events" : "different scheduling decision",
+                       (unsigned long long)same);
+                print_queue(&a, "A");
+                print_queue(&b, "B");
+                print_difference(&a, &b);
+            }
+        }
+
+        for (int k = 0; k < a.ngroup; k++) if (is_decision(&a.group[k])) apply(&a, &a.group[k]);
+        for (int k = 0; k < b.ngroup; k++) if (is_decision(&b.group[k])) apply(&b, &b.group[k]);
+    }
+    if (!diverged) {
+        printf("No divergence: %llu identical events\n", (unsigned long long)same);
+    }
+
+    print_turnaround(&a, &b, top);
+    run_free(&a);
+    run_free(&b);
+    return EXIT_SUCCESS;
+}
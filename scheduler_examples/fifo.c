@@ -2,6 +2,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "msg.h"
+#include "stats.h"
+#include "channel.h"
 #include <unistd.h>
 
 /**
@@ -34,17 +36,20 @@ void fifo_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_task) {
             // Cria uma mensagem para avisar a aplicação de que o processo acabou
             msg_t msg = {
                 .pid = (*cpu_task)->pid,
+                .tid = (*cpu_task)->tid,
                 .request = PROCESS_REQUEST_DONE,
                 .time_ms = current_time_ms
             };
 
             // Envia a mensagem pelo socket associado ao processo
-            if (write((*cpu_task)->sockfd, &msg, sizeof(msg_t)) != sizeof(msg_t)) {
+            if (channel_send((*cpu_task)->sockfd, &msg) < 0) {
                 perror("write");
             }
 
+            stats_burst_done(*cpu_task, current_time_ms);
+
             // Liberta a memória usada pelo processo (já terminou)
-            free((*cpu_task));
+            free_pcb(*cpu_task);
 
             // Indica que o CPU está livre novamente
             (*cpu_task) = NULL;
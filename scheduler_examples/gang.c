@@ -0,0 +1,266 @@
+#include "gang.h"
+#include "msg.h"
+#include "stats.h"
+#include "channel.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+/**
+ * Escalonador GANG com matriz de Ousterhout
+ *
+ * A matriz só guarda, para cada gang, a linha onde está e a sua largura
+ * (threads executáveis, no máximo ncpus). Em cada fronteira de slot a
+ * matriz é atualizada com as threads que estão na fila de prontos:
+ *  - gangs sem threads executáveis saem da matriz;
+ *  - um gang mantém a sua linha enquanto lá couber; senão muda para a
+ *    primeira linha com colunas livres (first fit) ou para uma linha nova;
+ *  - as linhas vazias desaparecem e passa-se à linha seguinte.
+ *
+ * Um gang que chega a meio de um slot só corre por preenchimento até à
+ * próxima fronteira, onde recebe uma linha.
+ */
+
+// Entrada da matriz: um processo e a linha que ocupa
+typedef struct {
+    int32_t pid;
+    int row;       // linha da matriz (-1 enquanto não tem lugar)
+    int width;     // colunas ocupadas (threads executáveis, até ncpus)
+} gang_t;
+
+static int fill_enabled = 1;
+
+static gang_t *gangs = NULL;       // por ordem de chegada à matriz
+static int ngangs = 0;
+static int gangs_cap = 0;
+
+static int *row_used = NULL;       // colunas ocupadas em cada linha
+static int nrows = 0;
+static int rows_cap = 0;
+
+static int cur_row = -1;           // linha servida no slot atual
+static uint32_t slot_start_ms = 0;
+
+// Estatísticas
+static uint64_t slots = 0;
+static uint64_t rows_sum = 0;
+static uint64_t gang_dispatches = 0;   // threads despachadas na sua linha
+static uint64_t fill_dispatches = 0;   // threads despachadas por preenchimento
+
+void gang_set_fill(int enabled) {
+    fill_enabled = enabled;
+}
+
+static gang_t *gang_find(int32_t pid) {
+    for (int i = 0; i < ngangs; i++) {
+        if (gangs[i].pid == pid) return &gangs[i];
+    }
+    return NULL;
+}
+
+static gang_t *gang_add(int32_t pid) {
+    if (ngangs == gangs_cap) {
+        int cap = gangs_cap ? gangs_cap * 2 : 16;
+        gang_t *g = realloc(gangs, (size_t)cap * sizeof(gang_t));
+        if (!g) return NULL;
+        gangs = g;
+        gangs_cap = cap;
+    }
+    gang_t *g = &gangs[ngangs++];
+    g->pid = pid;
+    g->row = -1;
+    g->width = 0;
+    return g;
+}
+
+// Primeira linha com width colunas livres (cria uma nova se necessário)
+static int row_first_fit(int width, int ncpus) {
+    for (int r = 0; r < nrows; r++) {
+        if (row_used[r] + width <= ncpus) return r;
+    }
+    if (nrows == rows_cap) {
+        int cap = rows_cap ? rows_cap * 2 : 8;
+        int *rows = realloc(row_used, (size_t)cap * sizeof(int));
+        if (!rows) return -1;
+        row_used = rows;
+        rows_cap = cap;
+    }
+    row_used[nrows] = 0;
+    return nrows++;
+}
+
+// Número de threads do processo pid na fila de prontos
+static int ready_threads(const queue_t *rq, int32_t pid) {
+    int n = 0;
+    for (queue_elem_t *it = rq->head; it != NULL; it = it->next) {
+        if (it->pcb->pid == pid) n++;
+    }
+    return n;
+}
+
+// Atualiza a matriz com as threads da fila de prontos (ver comentário acima)
+static void matrix_rebuild(const queue_t *rq, int ncpus) {
+    for (int i = 0; i < ngangs; i++) gangs[i].width = 0;
+    for (queue_elem_t *it = rq->head; it != NULL; it = it->next) {
+        gang_t *g = gang_find(it->pcb->pid);
+        if (!g) g = gang_add(it->pcb->pid);
+        if (g && g->width < ncpus) g->width++;
+    }
+
+    // Remove os gangs vazios, mantendo a ordem dos restantes
+    int n = 0;
+    for (int i = 0; i < ngangs; i++) {
+        if (gangs[i].width > 0) gangs[n++] = gangs[i];
+    }
+    ngangs = n;
+
+    // Primeiro os gangs que continuam a caber na sua linha...
+    for (int r = 0; r < nrows; r++) row_used[r] = 0;
+    for (int i = 0; i < ngangs; i++) {
+        gang_t *g = &gangs[i];
+        if (g->row >= 0 && g->row < nrows && row_used[g->row] + g->width <= ncpus) {
+            row_used[g->row] += g->width;
+        } else {
+            g->row = -1;
+        }
+    }
+    // ...depois os novos ou os que cresceram (first fit)
+    for (int i = 0; i < ngangs; i++) {
+        gang_t *g = &gangs[i];
+        if (g->row >= 0) continue;
+        g->row = row_first_fit(g->width, ncpus);
+        if (g->row >= 0) row_used[g->row] += g->width;
+    }
+
+    // Compacta as linhas vazias, mantendo a linha atual quando possível
+    int map[nrows > 0 ? nrows : 1];
+    int rows = 0;
+    int next_row = -1;
+    for (int r = 0; r < nrows; r++) {
+        if (row_used[r] == 0) {
+            map[r] = -1;
+            continue;
+        }
+        if (next_row < 0 && r > cur_row) next_row = rows;
+        map[r] = rows;
+        row_used[rows++] = row_used[r];
+    }
+    for (int i = 0; i < ngangs; i++) {
+        if (gangs[i].row >= 0) gangs[i].row = map[gangs[i].row];
+    }
+    nrows = rows;
+
+    // Passa à linha seguinte (round-robin)
+    cur_row = (next_row >= 0) ? next_row : 0;
+}
+
+// Move para um CPU livre as primeiras (até max) threads do processo pid
+static int dispatch_pid(queue_t *rq, pcb_t **cpu_tasks, int ncpus, int32_t pid, int max) {
+    int n = 0;
+    int c = 0;
+    queue_elem_t *it = rq->head;
+    while (it && n < max) {
+        queue_elem_t *next = it->next;
+        if (it->pcb->pid == pid) {
+            while (c < ncpus && cpu_tasks[c]) c++;
+            if (c == ncpus) break;
+            queue_elem_t *removed = remove_queue_elem(rq, it);
+            if (removed) {
+                cpu_tasks[c] = removed->pcb;
+                free_queue_elem(removed);
+                n++;
+            }
+        }
+        it = next;
+    }
+    return n;
+}
+
+void gang_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_tasks, int ncpus) {
+    // 1) Atualiza as threads em execução e envia DONE às que terminaram
+    for (int c = 0; c < ncpus; c++) {
+        pcb_t *t = cpu_tasks[c];
+        if (!t) continue;
+        t->ellapsed_time_ms += TICKS_MS;
+        if (t->ellapsed_time_ms < t->time_ms) continue;
+
+        msg_t msg = {
+            .pid = t->pid,
+            .tid = t->tid,
+            .request = PROCESS_REQUEST_DONE,
+            .time_ms = current_time_ms
+        };
+        if (channel_send(t->sockfd, &msg) < 0) {
+            perror("write");
+        }
+
+        stats_burst_done(t, current_time_ms);
+
+        free_pcb(t);
+        cpu_tasks[c] = NULL;
+    }
+
+    // 2) Fim do slot: preempta todas as threads e passa à linha seguinte
+    if (cur_row < 0 || current_time_ms - slot_start_ms >= GANG_SLICE) {
+        for (int c = 0; c < ncpus; c++) {
+            if (!cpu_tasks[c]) continue;
+            enqueue_pcb(rq, cpu_tasks[c]);
+            cpu_tasks[c] = NULL;
+        }
+        matrix_rebuild(rq, ncpus);
+        slot_start_ms = current_time_ms;
+        if (nrows > 0) {
+            slots++;
+            rows_sum += (uint64_t)nrows;
+        }
+    }
+
+    int idle = 0;
+    for (int c = 0; c < ncpus; c++) {
+        if (!cpu_tasks[c]) idle++;
+    }
+    if (idle == 0 || rq->head == NULL) return;
+
+    // 3) Threads dos gangs da linha atual (também as que voltam a meio do slot)
+    for (int i = 0; i < ngangs && idle > 0; i++) {
+        if (gangs[i].row != cur_row) continue;
+        int n = dispatch_pid(rq, cpu_tasks, ncpus, gangs[i].pid, idle);
+        gang_dispatches += (uint64_t)n;
+        idle -= n;
+    }
+    if (!fill_enabled) return;
+
+    // 4) Preenchimento: gangs inteiros de outras linhas que caibam nos
+    //    CPUs livres (pela ordem das linhas seguintes)...
+    for (int k = 1; k < nrows && idle > 0; k++) {
+        int r = (cur_row + k) % nrows;
+        for (int i = 0; i < ngangs && idle > 0; i++) {
+            if (gangs[i].row != r) continue;
+            int want = ready_threads(rq, gangs[i].pid);
+            if (want == 0 || want > idle) continue;
+            int n = dispatch_pid(rq, cpu_tasks, ncpus, gangs[i].pid, want);
+            fill_dispatches += (uint64_t)n;
+            idle -= n;
+        }
+    }
+
+    // ...e, por fim, threads soltas (fragmentos) por ordem de chegada
+    while (idle > 0 && rq->head) {
+        int32_t pid = rq->head->pcb->pid;
+        int n = dispatch_pid(rq, cpu_tasks, ncpus, pid, 1);
+        if (n == 0) break;
+        fill_dispatches += (uint64_t)n;
+        idle -= n;
+    }
+}
+
+void gang_report(FILE *out) {
+    uint64_t total = gang_dispatches + fill_dispatches;
+    fprintf(out, "---- Gang scheduling (slot %d ms, fill %s) ----\n",
+            GANG_SLICE, fill_enabled ? "on" : "off");
+    fprintf(out, "Time slots:           %llu (mean %.2f rows in the matrix)\n",
+            (unsigned long long)slots, slots ? (double)rows_sum / slots : 0.0);
+    fprintf(out, "Dispatches:           %llu in own row, %llu by filling (%.1f %%)\n",
+            (unsigned long long)gang_dispatches, (unsigned long long)fill_dispatches,
+            total ? 100.0 * fill_dispatches / total : 0.0);
+    fflush(out);
+}
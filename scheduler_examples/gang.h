@@ -0,0 +1,34 @@
+#ifndef GANG_H
+#define GANG_H
+
+#include <stdio.h>
+#include "queue.h"
+
+#define GANG_SLICE 500   // duração de cada time slot (linha da matriz), em ms
+
+/**
+ * @brief Liga/desliga o preenchimento de fragmentos (por omissão ligado)
+ */
+void gang_set_fill(int enabled);
+
+/**
+ * @brief Escalonador GANG (coscheduling) numa máquina SMP simulada
+ *
+ * Todas as threads executáveis de um processo (um "gang", identificado pelo
+ * PID) correm ao mesmo tempo, em CPUs diferentes. Os gangs são arrumados
+ * numa matriz de Ousterhout: cada linha é um time slot de GANG_SLICE ms e
+ * cada coluna um CPU. As linhas são servidas em round-robin e, no fim de
+ * cada slot, todas as threads são preemptadas.
+ *
+ * Os CPUs que a linha atual deixa livres são preenchidos com gangs inteiros
+ * de outras linhas que lá caibam e, por fim, com threads soltas
+ * (fragment filling), a não ser que o preenchimento esteja desligado.
+ */
+void gang_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_tasks, int ncpus);
+
+/**
+ * @brief Imprime as estatísticas da matriz (slots, linhas, preenchimentos)
+ */
+void gang_report(FILE *out);
+
+#endif //GANG_H
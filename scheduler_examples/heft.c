@@ -0,0 +1,65 @@
+#include "queue.h"
+#include "msg.h"
+#include "stats.h"
+#include "channel.h"
+#include "workload.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+/**
+ * Escalonador HEFT (Heterogeneous Earliest Finish Time) para workflows
+ *
+ * Versão para SMP homogéneo: todos os CPUs são iguais e não há custos de
+ * comunicação, por isso o "earliest finish time" é simplesmente o primeiro
+ * CPU livre. O que distingue o HEFT é a ordem da lista: sempre que um CPU
+ * fica livre, escolhe o burst pronto cuja tarefa tem maior upward rank
+ * (caminho mais longo dessa tarefa até ao fim do workflow).
+ * Assim as tarefas do caminho crítico nunca ficam atrás de trabalho que
+ * tem folga. Tal como o SJF, não há preempção.
+ *
+ * Processos que não pertencem ao workflow têm rank 0 (correm por último).
+ */
+void heft_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_task) {
+    // 1) Atualiza o processo que está no CPU (caso exista)
+    if (*cpu_task) {
+        (*cpu_task)->ellapsed_time_ms += TICKS_MS;
+
+        if ((*cpu_task)->ellapsed_time_ms >= (*cpu_task)->time_ms) {
+            // Envia mensagem DONE para a aplicação correspondente
+            msg_t msg = {
+                .pid = (*cpu_task)->pid,
+                .tid = (*cpu_task)->tid,
+                .request = PROCESS_REQUEST_DONE,
+                .time_ms = current_time_ms
+            };
+            if (channel_send((*cpu_task)->sockfd, &msg) < 0) {
+                perror("write");
+            }
+
+            stats_burst_done(*cpu_task, current_time_ms);
+
+            // Liberta o PCB e marca o CPU como livre
+            free_pcb(*cpu_task);
+            *cpu_task = NULL;
+        }
+    }
+
+    // 2) CPU livre → escolhe o burst com maior upward rank
+    if (*cpu_task == NULL && rq->head != NULL) {
+        queue_elem_t *best = rq->head;
+        double best_rank = workload_rank(best->pcb->pid);
+        for (queue_elem_t *it = best->next; it != NULL; it = it->next) {
+            double rank = workload_rank(it->pcb->pid);
+            if (rank > best_rank) {
+                best = it;
+                best_rank = rank;
+            }
+        }
+
+        queue_elem_t *removed = remove_queue_elem(rq, best);
+        if (removed) {
+            *cpu_task = removed->pcb;
+            free_queue_elem(removed);
+        }
+    }
+}
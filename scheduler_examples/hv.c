@@ -0,0 +1,236 @@
+#include "hv.h"
+#include "msg.h"
+#include "locks.h"
+#include "workload.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * VMs e vCPUs
+ *
+ * Os vCPUs de todas as VMs estão num só vetor; cada um tem um PCB (o que a
+ * política do anfitrião vê, com tid = índice do vCPU) e a tarefa do
+ * convidado que lá está. As VMs e os vCPUs são criados ao ler o workflow,
+ * antes do primeiro tick.
+ */
+
+#define HV_NAME_LEN 32
+
+typedef struct {
+    char name[HV_NAME_LEN];
+    char policy_name[16];
+    int policy;                 // scheduler_en do convidado
+    int32_t nice;               // prioridade dos vCPUs no anfitrião
+    int first_vcpu;
+    int nvcpus;
+    queue_t ready;              // fila de prontos do convidado
+
+    uint32_t bursts;
+    uint64_t latency_sum_ms;
+    uint32_t latency_max_ms;
+    uint64_t run_ms;            // vCPU num pCPU com trabalho
+    uint64_t steal_ms;          // vCPU com trabalho sem pCPU
+    uint32_t lhp;               // lock-holder preemptions
+} hv_vm_t;
+
+typedef struct {
+    pcb_t *pcb;                 // o vCPU visto pelo anfitrião
+    pcb_t *task;                // tarefa do convidado neste vCPU
+    int vm;
+    int pcpu;                   // pCPU onde correu no último tick (-1)
+} hv_vcpu_t;
+
+static hv_vm_t *vms = NULL;
+static int nvms = 0;
+static hv_vcpu_t vcpus[HV_MAX_VCPUS];
+static int nvcpus = 0;
+
+static int *placement = NULL;   // VM de cada tarefa do workflow (pid - WORKLOAD_PID_BASE)
+static int nplacement = 0;
+
+static queue_t host_ready = {.head = NULL, .tail = NULL};
+static pcb_t *host_cpu[MAX_CPUS];
+static uint32_t lhp_penalty_ms = 0;
+
+int hv_add_vm(const char *name, int count, const char *policy, int32_t nice) {
+    if (hv_find_vm(name) >= 0 || count < 1 || nvcpus + count > HV_MAX_VCPUS) return -1;
+    hv_vm_t *v = realloc(vms, (size_t)(nvms + 1) * sizeof(hv_vm_t));
+    if (!v) return -1;
+    vms = v;
+    hv_vm_t *vm = &vms[nvms];
+    memset(vm, 0, sizeof(*vm));
+    strncpy(vm->name, name, HV_NAME_LEN - 1);
+    strncpy(vm->policy_name, policy, sizeof(vm->policy_name) - 1);
+    vm->nice = nice;
+    vm->first_vcpu = nvcpus;
+    vm->nvcpus = count;
+    for (int k = 0; k < count; k++) {
+        pcb_t *p = new_pcb(-1, 0, UINT32_MAX);
+        if (!p) return -1;
+        p->tid = (uint32_t)nvcpus;
+        p->nice = nice;
+        p->status = TASK_RUNNING;
+        vcpus[nvcpus++] = (hv_vcpu_t){.pcb = p, .task = NULL, .vm = nvms, .pcpu = -1};
+    }
+    nvms++;
+    return 0;
+}
+
+int hv_find_vm(const char *name) {
+    for (int i = 0; i < nvms; i++) {
+        if (!strcmp(vms[i].name, name)) return i;
+    }
+    return -1;
+}
+
+int hv_place(int32_t pid, int vm) {
+    int i = pid - WORKLOAD_PID_BASE;
+    if (i < 0 || vm < 0 || vm >= nvms) return -1;
+    if (i >= nplacement) {
+        int *v = realloc(placement, (size_t)(i + 1) * sizeof(int));
+        if (!v) return -1;
+        for (int k = nplacement; k <= i; k++) v[k] = 0;
+        placement = v;
+        nplacement = i + 1;
+    }
+    placement[i] = vm;
+    return 0;
+}
+
+static int vm_of(int32_t pid) {
+    int i = pid - WORKLOAD_PID_BASE;
+    return i >= 0 && i < nplacement ? placement[i] : 0;
+}
+
+int hv_active(void) {
+    return nvms > 0;
+}
+
+int hv_vm_count(void) {
+    return nvms;
+}
+
+const char *hv_vm_policy_name(int vm) {
+    return vms[vm].policy_name;
+}
+
+void hv_set_vm_policy(int vm, int policy) {
+    vms[vm].policy = policy;
+}
+
+void hv_set_lhp_penalty(uint32_t penalty_ms) {
+    lhp_penalty_ms = penalty_ms;
+}
+
+void hv_enqueue(pcb_t *task) {
+    enqueue_pcb(&vms[vm_of(task->pid)].ready, task);
+}
+
+void hv_enqueue_batch(queue_t *batch) {
+    while (batch->head) move_queue_head(&vms[vm_of(batch->head->pcb->pid)].ready, batch);
+}
+
+void hv_scheduler(uint32_t now_ms, pcb_t **cpu_tasks, int ncpus,
+                  int host_policy, hv_policy_fn run) {
+    // 1) Convidados: só avançam os vCPUs que tiveram pCPU; os parados
+    //    recebem trabalho; os que esperam pelo anfitrião sofrem steal
+    for (int v = 0; v < nvcpus; v++) {
+        hv_vcpu_t *vc = &vcpus[v];
+        hv_vm_t *vm = &vms[vc->vm];
+        if (vc->pcpu >= 0) vm->run_ms += TICKS_MS;
+        if (vc->pcpu >= 0 || !vc->task) {
+            run(vm->policy, now_ms, &vm->ready, &vc->task);
+        } else {
+            vm->steal_ms += TICKS_MS;
+        }
+    }
+
+    // 2) Anfitrião: vCPUs sem trabalho largam o pCPU, os que acabaram de
+    //    receber trabalho entram na fila do anfitrião
+    for (int c = 0; c < ncpus; c++) {
+        if (host_cpu[c] && !vcpus[host_cpu[c]->tid].task) host_cpu[c] = NULL;
+    }
+    for (int v = 0; v < nvcpus; v++) {
+        hv_vcpu_t *vc = &vcpus[v];
+        // Um vCPU sem pCPU com tarefa já estava na fila (é desalojado com ela)
+        if (vc->task && vc->pcpu < 0 && vc->pcb->status != TASK_BLOCKED) {
+            enqueue_pcb(&host_ready, vc->pcb);
+            vc->pcb->status = TASK_BLOCKED;     // marca: está na fila do anfitrião
+        }
+    }
+    for (int c = 0; c < ncpus; c++) {
+        run(host_policy, now_ms, &host_ready, &host_cpu[c]);
+    }
+
+    // 3) Onde ficou cada vCPU; desalojar a dona de um mutex disputado custa caro
+    int prev[HV_MAX_VCPUS];
+    for (int v = 0; v < nvcpus; v++) {
+        prev[v] = vcpus[v].pcpu;
+        vcpus[v].pcpu = -1;
+    }
+    for (int c = 0; c < ncpus; c++) {
+        cpu_tasks[c] = NULL;
+        if (!host_cpu[c]) continue;
+        hv_vcpu_t *vc = &vcpus[host_cpu[c]->tid];
+        vc->pcpu = c;
+        vc->pcb->status = TASK_RUNNING;
+        cpu_tasks[c] = vc->task;
+    }
+    for (int v = 0; v < nvcpus; v++) {
+        hv_vcpu_t *vc = &vcpus[v];
+        if (prev[v] < 0 || vc->pcpu >= 0 || !vc->task) continue;
+        vc->pcb->status = TASK_BLOCKED;         // o anfitrião devolveu-o à fila
+        if (lhp_penalty_ms > 0 && locks_contended(vc->task->pid, vc->task->tid)) {
+            stall_pcb(vc->task, lhp_penalty_ms);
+            vms[vc->vm].lhp++;
+        }
+    }
+}
+
+void hv_burst_done(const pcb_t *task, uint32_t now_ms) {
+    hv_vm_t *vm = &vms[vm_of(task->pid)];
+    uint32_t latency = now_ms - task->arrival_time_ms;
+    vm->bursts++;
+    vm->latency_sum_ms += latency;
+    if (latency > vm->latency_max_ms) vm->latency_max_ms = latency;
+}
+
+void hv_report(FILE *out, const char *host_policy, int ncpus) {
+    if (!hv_active()) return;
+    fprintf(out, "---- Virtual machines (%d vCPUs, host %s on %d CPU(s)) ----\n",
+            nvcpus, host_policy, ncpus);
+    fprintf(out, "%-12s %5s %-6s %7s %9s %8s %8s %9s %7s %8s %5s\n",
+            "vm", "vcpus", "guest", "bursts", "mean.lat", "max.lat", "run.ms", "steal.ms", "steal%",
+            "lat.infl", "lhp");
+    for (int i = 0; i < nvms; i++) {
+        const hv_vm_t *vm = &vms[i];
+        uint64_t busy = vm->run_ms + vm->steal_ms;
+        // O steal de um vCPU atrasa a tarefa que lá está: sem ele a latência
+        // total seria latency_sum - steal (inflação = razão entre as duas)
+        uint64_t own = vm->latency_sum_ms > vm->steal_ms ? vm->latency_sum_ms - vm->steal_ms : 0;
+        fprintf(out, "%-12s %5d %-6s %7u %9.1f %8u %8llu %9llu %6.1f%% %7.2fx %5u\n",
+                vm->name, vm->nvcpus, vm->policy_name, vm->bursts,
+                vm->bursts ? (double)vm->latency_sum_ms / vm->bursts : 0.0, vm->latency_max_ms,
+                (unsigned long long)vm->run_ms, (unsigned long long)vm->steal_ms,
+                busy ? 100.0 * vm->steal_ms / busy : 0.0,
+                own ? (double)vm->latency_sum_ms / own : 1.0, vm->lhp);
+    }
+    fflush(out);
+}
+
+void hv_free(void) {
+    while (host_ready.head) dequeue_pcb(&host_ready);
+    for (int v = 0; v < nvcpus; v++) {
+        free_pcb(vcpus[v].task);
+        free_pcb(vcpus[v].pcb);
+    }
+    for (int i = 0; i < nvms; i++) {
+        while (vms[i].ready.head) free_pcb(dequeue_pcb(&vms[i].ready));
+    }
+    free(vms);
+    free(placement);
+    vms = NULL;
+    placement = NULL;
+    nvms = nvcpus = nplacement = 0;
+    memset(host_cpu, 0, sizeof(host_cpu));
+}
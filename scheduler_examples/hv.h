@@ -0,0 +1,115 @@
+#ifndef HV_H
+#define HV_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "queue.h"
+
+/*
+ * Escalonamento em dois níveis: máquinas virtuais com vCPUs sobre os CPUs
+ * físicos (pCPUs, --cpus).
+ *
+ * Cada VM tem os seus vCPUs, a sua fila de prontos e uma política de
+ * convidado (FIFO, SJF, RR, PRIO ou HEFT), que escolhe as tarefas da VM para
+ * os seus vCPUs como faria com CPUs reais. Um vCPU com uma tarefa fica
+ * executável no anfitrião; sem tarefa para (halt). Os vCPUs executáveis
+ * são escalonados nos pCPUs pela política do anfitrião (FIFO, RR ou PRIO,
+ * com o nice da VM), que os vê como PCBs que nunca terminam.
+ *
+ * A tarefa de um vCPU só avança nos ticks em que o vCPU está num pCPU. O
+ * tempo em que um vCPU tem trabalho mas não tem pCPU é steal time: o
+ * convidado vê-o como tempo que lhe foi roubado e as suas tarefas como
+ * latência extra.
+ *
+ * Com --lhp-penalty, sempre que o anfitrião desaloja um vCPU cuja tarefa é
+ * dona de um mutex com threads à espera (lock-holder preemption), a secção
+ * crítica dessa tarefa fica mais longa nesse tempo (as esperas rodam em
+ * vão e o mutex demora mais a passar de mão). O atraso passa por
+ * stall_pcb(): o tempo pedido pela tarefa não muda.
+ */
+
+#define HV_MAX_VCPUS 256          // vCPUs no total, em todas as VMs
+
+// Chama a política de um CPU (scheduler_en do ossim) para o CPU cpu_task
+typedef void (*hv_policy_fn)(int policy, uint32_t now_ms, queue_t *rq, pcb_t **cpu_task);
+
+/**
+ * @brief Declara uma VM com count vCPUs, a política de convidado policy
+ *        (nome, validado pelo ossim) e o nice dos seus vCPUs no anfitrião
+ * @return 0 em caso de sucesso, -1 se o nome se repetir ou faltarem vCPUs
+ */
+int hv_add_vm(const char *name, int count, const char *policy, int32_t nice);
+
+/**
+ * @brief Índice da VM com este nome, ou -1
+ */
+int hv_find_vm(const char *name);
+
+/**
+ * @brief As tarefas de pid correm na VM vm (sem colocação: a primeira VM)
+ */
+int hv_place(int32_t pid, int vm);
+
+/**
+ * @brief Indica se há VMs (o ossim passa a escalonar com hv_scheduler())
+ */
+int hv_active(void);
+
+/**
+ * @brief Número de VMs declaradas
+ */
+int hv_vm_count(void);
+
+/**
+ * @brief Nome da política de convidado da VM vm, como foi declarado
+ */
+const char *hv_vm_policy_name(int vm);
+
+/**
+ * @brief Fixa a política de convidado da VM vm (scheduler_en do ossim)
+ */
+void hv_set_vm_policy(int vm, int policy);
+
+/**
+ * @brief Penalização em ms de cada lock-holder preemption (0 = nenhuma)
+ */
+void hv_set_lhp_penalty(uint32_t penalty_ms);
+
+/**
+ * @brief Um pedido RUN entra na fila de prontos da VM do seu pid
+ */
+void hv_enqueue(pcb_t *task);
+
+/**
+ * @brief Os pedidos RUN de um tick entram nas filas das suas VMs (batch fica vazia)
+ */
+void hv_enqueue_batch(queue_t *batch);
+
+/**
+ * @brief Um tick dos dois níveis
+ *
+ * Os convidados avançam as tarefas dos vCPUs que correram no último tick e
+ * dão trabalho aos vCPUs parados; depois a política do anfitrião coloca os
+ * vCPUs executáveis nos pCPUs. cpu_tasks fica com a tarefa do convidado que
+ * corre em cada pCPU (para as estatísticas e o trace), mas os PCBs
+ * continuam a pertencer aos vCPUs.
+ */
+void hv_scheduler(uint32_t now_ms, pcb_t **cpu_tasks, int ncpus,
+                  int host_policy, hv_policy_fn run);
+
+/**
+ * @brief Um burst terminou: regista a latência na sua VM
+ */
+void hv_burst_done(const pcb_t *task, uint32_t now_ms);
+
+/**
+ * @brief Imprime, por VM, o steal time e quanto dele pesou na latência
+ */
+void hv_report(FILE *out, const char *host_policy, int ncpus);
+
+/**
+ * @brief Liberta as VMs, os vCPUs e as tarefas que ficaram nas suas filas
+ */
+void hv_free(void);
+
+#endif //HV_H
@@ -0,0 +1,118 @@
+#include "irq.h"
+#include "msg.h"
+
+/**
+ * Modelo de interrupções com um único dispositivo
+ *
+ * O custo é acumulado em µs (debt_us) e só é cobrado à tarefa em ticks
+ * inteiros, tal como o resto do simulador mede o tempo de CPU.
+ */
+
+static uint32_t irq_cost_us = 0;
+static uint32_t napi_threshold = 0;
+static uint32_t napi_budget = IRQ_DEFAULT_NAPI_BUDGET;
+
+static int polling = 0;                // modo atual do dispositivo
+static uint32_t window_start_ms = 0;
+static uint32_t window_count = 0;      // conclusões na janela atual
+static uint32_t poll_left = 0;         // orçamento do poll deste tick
+static uint32_t debt_us = 0;           // tempo de interrupção ainda por cobrar
+
+static uint64_t irq_completions = 0;
+static uint64_t polled_completions = 0;
+static uint64_t mode_switches = 0;
+static uint64_t polling_ms = 0;        // tempo passado em modo polling
+static uint64_t lost_us = 0;           // tempo total de serviço das conclusões
+static uint64_t stolen_ms = 0;         // parte cobrada a tarefas
+static uint64_t deferred = 0;          // conclusões que ficaram para outro poll
+static uint64_t delay_sum_ms = 0;
+static uint32_t delay_max_ms = 0;
+
+void irq_set_cost(uint32_t cost_us) {
+    irq_cost_us = cost_us;
+}
+
+void irq_set_napi_threshold(uint32_t per_second) {
+    napi_threshold = per_second;
+}
+
+void irq_set_napi_budget(uint32_t budget) {
+    napi_budget = budget;
+}
+
+void irq_tick(uint32_t now_ms) {
+    if (irq_cost_us == 0) return;
+    if (polling) polling_ms += TICKS_MS;
+    if (now_ms - window_start_ms >= IRQ_WINDOW_MS) {
+        uint64_t rate = (uint64_t)window_count * 1000 / (now_ms - window_start_ms);
+        if (!polling && napi_threshold > 0 && rate > napi_threshold) {
+            polling = 1;
+            mode_switches++;
+        } else if (polling && rate < napi_threshold / 2) {
+            polling = 0;
+            mode_switches++;
+        }
+        window_start_ms = now_ms;
+        window_count = 0;
+    }
+    poll_left = napi_budget;
+}
+
+int irq_complete(const pcb_t *task) {
+    if (irq_cost_us == 0) return 1;
+    if (polling) {
+        if (poll_left == 0) return 0;
+        poll_left--;
+        polled_completions++;
+        debt_us += irq_cost_us / IRQ_POLL_COST_DIV;
+        lost_us += irq_cost_us / IRQ_POLL_COST_DIV;
+    } else {
+        irq_completions++;
+        debt_us += irq_cost_us;
+        lost_us += irq_cost_us;
+    }
+    window_count++;
+
+    // O BLOCK conta ticks inteiros: o que passou do fim é espera pelo poll
+    uint32_t due = (task->time_ms + TICKS_MS - 1) / TICKS_MS * TICKS_MS;
+    if (task->ellapsed_time_ms > due) {
+        uint32_t delay = task->ellapsed_time_ms - due;
+        deferred++;
+        delay_sum_ms += delay;
+        if (delay > delay_max_ms) delay_max_ms = delay;
+    }
+    return 1;
+}
+
+void irq_charge(pcb_t **cpu_tasks, int ncpus) {
+    if (irq_cost_us == 0 || IRQ_CPU >= ncpus) return;
+    uint32_t tick_us = TICKS_MS * 1000;
+    pcb_t *task = cpu_tasks[IRQ_CPU];
+    while (debt_us >= tick_us) {
+        debt_us -= tick_us;
+        // CPU livre: o serviço da interrupção não atrasa ninguém
+        if (!task) continue;
+        stall_pcb(task, TICKS_MS);
+        stolen_ms += TICKS_MS;
+    }
+}
+
+void irq_report(FILE *out, uint32_t now_ms, int ncpus) {
+    if (irq_cost_us == 0) return;
+    uint64_t total = irq_completions + polled_completions;
+    double capacity_us = (double)now_ms * 1000.0 * ncpus;
+    fprintf(out, "---- Interrupts (%u us each, NAPI above %u/s, budget %u) ----\n",
+            irq_cost_us, napi_threshold, napi_budget);
+    fprintf(out, "Completions:          %llu (%llu by interrupt, %llu polled), %llu mode switches\n",
+            (unsigned long long)total, (unsigned long long)irq_completions,
+            (unsigned long long)polled_completions, (unsigned long long)mode_switches);
+    fprintf(out, "Polling mode:         %.1f %% of the time\n",
+            now_ms ? 100.0 * polling_ms / now_ms : 0.0);
+    fprintf(out, "CPU lost to IRQs:     %.1f ms (%.2f %% of CPU capacity), %llu ms taken from running tasks\n",
+            lost_us / 1000.0, capacity_us > 0 ? 100.0 * lost_us / capacity_us : 0.0,
+            (unsigned long long)stolen_ms);
+    fprintf(out, "Poll delay:           %llu completions waited, mean %.1f ms, max %u ms\n",
+            (unsigned long long)deferred,
+            deferred ? (double)delay_sum_ms / deferred : 0.0, delay_max_ms);
+    fflush(out);
+}
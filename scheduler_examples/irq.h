@@ -0,0 +1,73 @@
+#ifndef IRQ_H
+#define IRQ_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "queue.h"
+
+/*
+ * Custo de CPU das conclusões de I/O (interrupções e polling tipo NAPI).
+ *
+ * Cada fim de BLOCK é uma conclusão do dispositivo. Com --irq-cost, cada
+ * conclusão custa esse tempo (em µs) de serviço de interrupção ao CPU
+ * IRQ_CPU, que o rouba à tarefa que lá está a correr: quando o tempo
+ * roubado soma um tick, essa tarefa perde um tick de progresso (se o CPU
+ * estiver livre, o custo é absorvido sem atrasar ninguém). O tempo pedido
+ * não muda: o atraso conta no slowdown e não como CPU da tarefa.
+ *
+ * Acima de --napi-threshold conclusões por segundo (medidas em janelas de
+ * IRQ_WINDOW_MS) o dispositivo desliga as interrupções e passa a ser lido
+ * por polling: em cada tick um poll trata até --napi-budget conclusões, cada
+ * uma com um quarto do custo de uma interrupção; as restantes ficam para o
+ * poll seguinte (latência extra). Volta às interrupções quando a taxa
+ * desce abaixo de metade do limiar.
+ */
+
+#define IRQ_CPU 0                  // afinidade da interrupção do dispositivo
+#define IRQ_WINDOW_MS 100          // janela para medir a taxa de conclusões
+#define IRQ_POLL_COST_DIV 4        // custo de uma conclusão por polling = irq_cost / 4
+#define IRQ_DEFAULT_NAPI_BUDGET 64 // conclusões por poll (peso do NAPI)
+
+/**
+ * @brief Custo de cada interrupção em µs (0 = modelo desligado, por omissão)
+ */
+void irq_set_cost(uint32_t cost_us);
+
+/**
+ * @brief Taxa (conclusões/s) a partir da qual se usa polling (0 = nunca)
+ */
+void irq_set_napi_threshold(uint32_t per_second);
+
+/**
+ * @brief Conclusões tratadas por cada poll
+ */
+void irq_set_napi_budget(uint32_t budget);
+
+/**
+ * @brief Início da verificação das conclusões de um tick
+ *
+ * Fecha a janela de medição da taxa (e muda de modo se for caso disso) e
+ * repõe o orçamento do poll.
+ */
+void irq_tick(uint32_t now_ms);
+
+/**
+ * @brief O I/O de task terminou: decide se a conclusão é entregue já
+ * @return 1 se deve ser entregue neste tick, 0 se fica para o próximo poll
+ */
+int irq_complete(const pcb_t *task);
+
+/**
+ * @brief Cobra o tempo de interrupção acumulado à tarefa no CPU IRQ_CPU
+ *
+ * Deve ser chamada depois de irq_complete() e antes do escalonador, com
+ * as tarefas que ocuparam os CPUs durante o último tick.
+ */
+void irq_charge(pcb_t **cpu_tasks, int ncpus);
+
+/**
+ * @brief Imprime o tempo de CPU perdido para interrupções e a latência extra
+ */
+void irq_report(FILE *out, uint32_t now_ms, int ncpus);
+
+#endif //IRQ_H
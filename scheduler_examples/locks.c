@@ -0,0 +1,284 @@
+#include "locks.h"
+#include "msg.h"
+#include "channel.h"
+#include "debug.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#define LOCK_MAX_CHAIN 8   // profundidade máxima da herança transitiva
+
+// Thread à espera de um mutex
+typedef struct waiter_st {
+    pcb_t *pcb;                 // pedido LOCK (pid, tid, sockfd, nice, chegada)
+    uint32_t inversion_ms;      // tempo à espera de uma dona com menor prioridade
+    struct waiter_st *next;
+} waiter_t;
+
+// Mutex simulado
+typedef struct {
+    uint32_t id;
+    int held;
+    int32_t holder_pid;         // dona atual (pid, tid) e a sua ligação
+    uint32_t holder_tid;
+    uint32_t holder_fd;
+    int32_t holder_nice;        // nice da dona (sem herança)
+    int32_t ceiling;            // menor nice de quem usa o mutex
+    waiter_t *waiters;          // por ordem de chegada
+    uint32_t last_event_ms;     // último instante contabilizado nas esperas
+} sim_mutex_t;
+
+static lock_protocol_en protocol = LOCK_PROTO_NONE;
+static const char *PROTOCOL_NAMES[] = {"none", "inherit", "ceiling"};
+
+static sim_mutex_t *mutexes = NULL;
+static int nmutexes = 0;
+static int mutexes_cap = 0;
+static waiter_t *free_waiters = NULL;   // reutilizados, para não alocar em cada espera
+
+// Estatísticas
+static uint64_t acquisitions = 0;
+static uint64_t contended = 0;          // pedidos que tiveram de esperar
+static uint64_t wait_sum_ms = 0;
+static uint32_t wait_max_ms = 0;
+static uint64_t inversion_waits = 0;    // esperas atrás de uma dona de menor prioridade
+static uint64_t inversion_sum_ms = 0;
+static uint32_t inversion_max_ms = 0;
+
+void locks_set_protocol(lock_protocol_en p) {
+    protocol = p;
+}
+
+static sim_mutex_t *mutex_find(uint32_t id) {
+    for (int i = 0; i < nmutexes; i++) {
+        if (mutexes[i].id == id) return &mutexes[i];
+    }
+    return NULL;
+}
+
+static sim_mutex_t *mutex_get(uint32_t id) {
+    sim_mutex_t *m = mutex_find(id);
+    if (m) return m;
+    if (nmutexes == mutexes_cap) {
+        int cap = mutexes_cap ? mutexes_cap * 2 : 8;
+        sim_mutex_t *v = realloc(mutexes, (size_t)cap * sizeof(sim_mutex_t));
+        if (!v) return NULL;
+        mutexes = v;
+        mutexes_cap = cap;
+    }
+    m = &mutexes[nmutexes++];
+    m->id = id;
+    m->held = 0;
+    m->ceiling = INT32_MAX;
+    m->waiters = NULL;
+    m->last_event_ms = 0;
+    return m;
+}
+
+void locks_declare(uint32_t lock, int32_t nice) {
+    sim_mutex_t *m = mutex_get(lock);
+    if (m && nice < m->ceiling) m->ceiling = nice;
+}
+
+static void send_done(int32_t pid, uint32_t tid, uint32_t sockfd, uint32_t now_ms) {
+    msg_t msg = {
+        .pid = pid,
+        .tid = tid,
+        .request = PROCESS_REQUEST_DONE,
+        .time_ms = now_ms
+    };
+    if (channel_send(sockfd, &msg) < 0) {
+        perror("write(DONE:LOCK)");
+    }
+}
+
+// Liberta o pedido em espera e guarda o waiter para o próximo
+static void waiter_release(waiter_t *w) {
+    free_pcb(w->pcb);
+    w->next = free_waiters;
+    free_waiters = w;
+}
+
+static int32_t effective_nice(int32_t pid, uint32_t tid, int32_t nice, int depth);
+
+// Soma às esperas o tempo desde o último evento em que a dona tinha menor
+// prioridade. Conta a prioridade efetiva da dona (herdada ou do teto), que
+// é a dos waiters atuais, os mesmos de todo o intervalo
+static void mutex_account(sim_mutex_t *m, uint32_t now_ms) {
+    if (m->held) {
+        uint32_t dt = now_ms - m->last_event_ms;
+        int32_t holder = effective_nice(m->holder_pid, m->holder_tid, m->holder_nice, 0);
+        for (waiter_t *w = m->waiters; w != NULL; w = w->next) {
+            if (holder > w->pcb->nice) w->inversion_ms += dt;
+        }
+    }
+    m->last_event_ms = now_ms;
+}
+
+static void mutex_grant(sim_mutex_t *m, const pcb_t *p, uint32_t now_ms) {
+    m->held = 1;
+    m->holder_pid = p->pid;
+    m->holder_tid = p->tid;
+    m->holder_fd = p->sockfd;
+    m->holder_nice = p->nice;
+    acquisitions++;
+    send_done(p->pid, p->tid, p->sockfd, now_ms);
+    DBG("Lock %u acquired by %d.%u at %u ms", m->id, p->pid, p->tid, now_ms);
+}
+
+// Entrega o mutex livre à thread em espera de maior prioridade
+static void mutex_handoff(sim_mutex_t *m, uint32_t now_ms) {
+    waiter_t **best = NULL;
+    for (waiter_t **it = &m->waiters; *it != NULL; it = &(*it)->next) {
+        if (!best || (*it)->pcb->nice < (*best)->pcb->nice) best = it;
+    }
+    if (!best) return;
+
+    waiter_t *w = *best;
+    *best = w->next;
+
+    uint32_t wait = now_ms - w->pcb->arrival_time_ms;
+    wait_sum_ms += wait;
+    if (wait > wait_max_ms) wait_max_ms = wait;
+    if (w->inversion_ms > 0) {
+        inversion_waits++;
+        inversion_sum_ms += w->inversion_ms;
+        if (w->inversion_ms > inversion_max_ms) inversion_max_ms = w->inversion_ms;
+    }
+
+    mutex_grant(m, w->pcb, now_ms);
+    waiter_release(w);
+}
+
+void locks_request(uint32_t lock, pcb_t *req, uint32_t now_ms) {
+    sim_mutex_t *m = mutex_get(lock);
+    if (!m) {
+        free_pcb(req);
+        return;
+    }
+    if (req->nice < m->ceiling) m->ceiling = req->nice;
+    mutex_account(m, now_ms);
+
+    if (!m->held) {
+        mutex_grant(m, req, now_ms);
+        free_pcb(req);
+        return;
+    }
+
+    waiter_t *w = free_waiters;
+    if (w) {
+        free_waiters = w->next;
+    } else {
+        w = malloc(sizeof(waiter_t));
+    }
+    if (!w) {
+        free_pcb(req);
+        return;
+    }
+    w->pcb = req;
+    w->inversion_ms = 0;
+    w->next = NULL;
+    waiter_t **tail = &m->waiters;
+    while (*tail) tail = &(*tail)->next;
+    *tail = w;
+    contended++;
+    DBG("Lock %u: %d.%u waits for %d.%u", lock, req->pid, req->tid, m->holder_pid, m->holder_tid);
+}
+
+void locks_release(uint32_t lock, const pcb_t *req, uint32_t now_ms) {
+    send_done(req->pid, req->tid, req->sockfd, now_ms);
+
+    sim_mutex_t *m = mutex_find(lock);
+    if (!m || !m->held || m->holder_pid != req->pid || m->holder_tid != req->tid) {
+        DBG("Lock %u released by %d.%u, which does not hold it", lock, req->pid, req->tid);
+        return;
+    }
+    mutex_account(m, now_ms);
+    m->held = 0;
+    mutex_handoff(m, now_ms);
+}
+
+void locks_drop(uint32_t sockfd, uint32_t now_ms) {
+    for (int i = 0; i < nmutexes; i++) {
+        sim_mutex_t *m = &mutexes[i];
+        mutex_account(m, now_ms);
+
+        waiter_t **it = &m->waiters;
+        while (*it) {
+            waiter_t *w = *it;
+            if (w->pcb->sockfd == sockfd) {
+                *it = w->next;
+                waiter_release(w);
+            } else {
+                it = &w->next;
+            }
+        }
+        if (m->held && m->holder_fd == sockfd) {
+            m->held = 0;
+            mutex_handoff(m, now_ms);
+        }
+    }
+}
+
+static int32_t effective_nice(int32_t pid, uint32_t tid, int32_t nice, int depth) {
+    if (protocol == LOCK_PROTO_NONE || depth > LOCK_MAX_CHAIN) return nice;
+    for (int i = 0; i < nmutexes; i++) {
+        sim_mutex_t *m = &mutexes[i];
+        if (!m->held || m->holder_pid != pid || m->holder_tid != tid) continue;
+        if (protocol == LOCK_PROTO_CEILING) {
+            if (m->ceiling < nice) nice = m->ceiling;
+            continue;
+        }
+        // Herança (transitiva): quem espera pode ser dona de outro mutex
+        for (waiter_t *w = m->waiters; w != NULL; w = w->next) {
+            int32_t n = effective_nice(w->pcb->pid, w->pcb->tid, w->pcb->nice, depth + 1);
+            if (n < nice) nice = n;
+        }
+    }
+    return nice;
+}
+
+int32_t locks_nice(const pcb_t *task) {
+    return effective_nice(task->pid, task->tid, task->nice, 0);
+}
+
+int locks_contended(int32_t pid, uint32_t tid) {
+    for (int i = 0; i < nmutexes; i++) {
+        const sim_mutex_t *m = &mutexes[i];
+        if (m->held && m->holder_pid == pid && m->holder_tid == tid && m->waiters) return 1;
+    }
+    return 0;
+}
+
+void locks_report(FILE *out) {
+    if (nmutexes == 0) return;
+    fprintf(out, "---- Locks (%d mutexes, protocol %s) ----\n", nmutexes, PROTOCOL_NAMES[protocol]);
+    fprintf(out, "Acquisitions:         %llu (%llu contended)\n",
+            (unsigned long long)acquisitions, (unsigned long long)contended);
+    fprintf(out, "Lock wait:            mean %.1f ms, max %u ms\n",
+            contended ? (double)wait_sum_ms / contended : 0.0, wait_max_ms);
+    fprintf(out, "Inversion blocking:   total %llu ms, max %u ms (%llu waits behind a lower-priority holder)\n",
+            (unsigned long long)inversion_sum_ms, inversion_max_ms,
+            (unsigned long long)inversion_waits);
+    fflush(out);
+}
+
+void locks_free(void) {
+    for (int i = 0; i < nmutexes; i++) {
+        waiter_t *w = mutexes[i].waiters;
+        while (w) {
+            waiter_t *next = w->next;
+            free_pcb(w->pcb);
+            free(w);
+            w = next;
+        }
+    }
+    while (free_waiters) {
+        waiter_t *next = free_waiters->next;
+        free(free_waiters);
+        free_waiters = next;
+    }
+    free(mutexes);
+    mutexes = NULL;
+    nmutexes = 0;
+    mutexes_cap = 0;
+}
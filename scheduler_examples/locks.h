@@ -0,0 +1,79 @@
+#ifndef LOCKS_H
+#define LOCKS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "queue.h"
+
+/*
+ * Mutexes simulados.
+ *
+ * Uma thread pede um mutex com LOCK e recebe ACK de imediato e DONE quando
+ * passa a ser a dona do mutex. UNLOCK liberta o mutex (ACK + DONE) e
+ * entrega-o à thread em espera com maior prioridade (menor nice; por ordem
+ * de chegada entre iguais). Não há deteção de deadlocks.
+ *
+ * O tempo em que uma thread espera por um mutex cuja dona tem menor
+ * prioridade (nice maior) é contado como bloqueio por inversão de prioridade.
+ */
+
+// Protocolos contra a inversão de prioridade
+typedef enum {
+    LOCK_PROTO_NONE = 0,    // a dona mantém a sua prioridade
+    LOCK_PROTO_INHERIT,     // a dona herda a prioridade das threads em espera
+    LOCK_PROTO_CEILING      // a dona sobe ao teto do mutex (menor nice de quem o usa)
+} lock_protocol_en;
+
+/**
+ * @brief Escolhe o protocolo (por omissão nenhum)
+ */
+void locks_set_protocol(lock_protocol_en protocol);
+
+/**
+ * @brief Declara que uma thread com este nice usa o mutex (teto de prioridade)
+ *
+ * O teto é também atualizado com cada pedido LOCK, mas só fica correto desde
+ * o início se todos os utilizadores forem declarados antes (ver workload.c).
+ */
+void locks_declare(uint32_t lock, int32_t nice);
+
+/**
+ * @brief Trata um pedido LOCK (o ACK já foi enviado)
+ *
+ * O PCB (pid, tid, sockfd, nice, arrival_time_ms) passa a pertencer a este
+ * módulo: se o mutex estiver livre envia DONE e liberta-o, senão fica na
+ * lista de espera do mutex.
+ */
+void locks_request(uint32_t lock, pcb_t *req, uint32_t now_ms);
+
+/**
+ * @brief Trata um pedido UNLOCK: envia DONE e entrega o mutex à próxima thread
+ */
+void locks_release(uint32_t lock, const pcb_t *req, uint32_t now_ms);
+
+/**
+ * @brief Uma ligação fechou: liberta os mutexes que tinha e as suas esperas
+ */
+void locks_drop(uint32_t sockfd, uint32_t now_ms);
+
+/**
+ * @brief Prioridade efetiva (nice) de uma thread, tendo em conta o protocolo
+ */
+int32_t locks_nice(const pcb_t *task);
+
+/**
+ * @brief Indica se a thread (pid, tid) é dona de um mutex com threads à espera
+ */
+int locks_contended(int32_t pid, uint32_t tid);
+
+/**
+ * @brief Imprime aquisições, esperas e bloqueio por threads de menor prioridade
+ */
+void locks_report(FILE *out);
+
+/**
+ * @brief Liberta a memória dos mutexes (e das esperas pendentes)
+ */
+void locks_free(void);
+
+#endif //LOCKS_H
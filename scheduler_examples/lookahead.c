@@ -0,0 +1,229 @@
+#include "lookahead.h"
+#include "msg.h"
+#include "stats.h"
+#include "channel.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * Escalonador LOOKAHEAD
+ *
+ * A fotografia é uma tabela compacta (só números, sem ponteiros), guardada
+ * em vetores estáticos: a tarefa i tem chegada, duração pedida e tempo em
+ * falta. Cada candidato é simulado sobre uma cópia do vetor "CPU livre a
+ * partir de", que é reposta (memcpy) antes do candidato seguinte; a tabela
+ * das tarefas nunca é alterada, por isso não há mais nada a desfazer.
+ *
+ * A simulação é por eventos e não por ticks: o CPU que fica livre primeiro
+ * recebe a próxima tarefa da lista. Cada tarefa conta com o instante em que
+ * termina, ou com o fim do horizonte se não terminar antes.
+ *
+ * Candidatos: a tarefa mais antiga (a escolha do FIFO) e as restantes com
+ * menos tempo em falta, até ao número configurado.
+ */
+
+// Entrada da tabela compacta
+typedef struct {
+    uint32_t arrival_ms;
+    uint32_t time_ms;        // duração pedida (para o bounded slowdown)
+    uint32_t remaining_ms;
+} la_task_t;
+
+static uint32_t horizon_ms = 2000;
+static int max_candidates = 8;
+static lookahead_metric_en metric = LOOKAHEAD_FLOW;
+
+// Fotografia: tarefas em execução (uma por CPU ocupado) e tarefas prontas
+static la_task_t running[MAX_CPUS];
+static la_task_t ready[LOOKAHEAD_MAX_TASKS];
+static queue_elem_t *ready_elem[LOOKAHEAD_MAX_TASKS];
+static uint32_t free_at[MAX_CPUS];       // estado base
+static uint32_t scratch[MAX_CPUS];       // cópia de trabalho de cada candidato
+
+// Estatísticas da decisão
+static uint64_t decisions = 0;
+static uint64_t evaluated = 0;
+static uint64_t decision_ns_sum = 0;
+static uint64_t decision_ns_max = 0;
+
+void lookahead_set_horizon(uint32_t h) {
+    horizon_ms = h;
+}
+
+void lookahead_set_candidates(int k) {
+    if (k < 1) k = 1;
+    if (k > LOOKAHEAD_MAX_CANDIDATES) k = LOOKAHEAD_MAX_CANDIDATES;
+    max_candidates = k;
+}
+
+void lookahead_set_metric(lookahead_metric_en m) {
+    metric = m;
+}
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Custo de uma tarefa que termina (ou é cortada pelo horizonte) em end_ms
+static double task_cost(const la_task_t *t, uint32_t end_ms) {
+    double flow = (double)(end_ms - t->arrival_ms);
+    if (metric == LOOKAHEAD_FLOW) return flow;
+    uint32_t run = t->time_ms > STATS_BSLD_TAU_MS ? t->time_ms : STATS_BSLD_TAU_MS;
+    double bsld = flow / run;
+    return bsld < 1.0 ? 1.0 : bsld;
+}
+
+// CPU que fica livre primeiro no estado de trabalho
+static int earliest_cpu(int ncpus) {
+    int best = 0;
+    for (int c = 1; c < ncpus; c++) {
+        if (scratch[c] < scratch[best]) best = c;
+    }
+    return best;
+}
+
+/**
+ * Simula o despacho de ready[cand] no CPU cpu, no instante now, seguido das
+ * restantes prontas por ordem de chegada. Devolve o custo total.
+ */
+static double rollout(int cand, int cpu, int nready, int ncpus, uint32_t now_ms) {
+    uint32_t end_ms = now_ms + horizon_ms;
+    double cost = 0.0;
+
+    // Reposição do estado base (rollback do candidato anterior)
+    memcpy(scratch, free_at, (size_t)ncpus * sizeof(uint32_t));
+    for (int c = 0; c < ncpus; c++) {
+        if (scratch[c] > now_ms) {
+            cost += task_cost(&running[c], scratch[c] < end_ms ? scratch[c] : end_ms);
+        }
+    }
+
+    uint32_t finish = now_ms + ready[cand].remaining_ms;
+    scratch[cpu] = finish;
+    cost += task_cost(&ready[cand], finish < end_ms ? finish : end_ms);
+
+    for (int i = 0; i < nready; i++) {
+        if (i == cand) continue;
+        int c = earliest_cpu(ncpus);
+        uint32_t start = scratch[c] > now_ms ? scratch[c] : now_ms;
+        if (start >= end_ms) {
+            cost += task_cost(&ready[i], end_ms);
+            continue;
+        }
+        finish = start + ready[i].remaining_ms;
+        scratch[c] = finish;
+        cost += task_cost(&ready[i], finish < end_ms ? finish : end_ms);
+    }
+    return cost;
+}
+
+// Escolhe os candidatos: o mais antigo e os que têm menos tempo em falta
+static int pick_candidates(int *cands, int nready) {
+    int n = 0;
+    cands[n++] = 0;
+    while (n < max_candidates && n < nready) {
+        int best = -1;
+        for (int i = 1; i < nready; i++) {
+            int taken = 0;
+            for (int k = 0; k < n; k++) {
+                if (cands[k] == i) { taken = 1; break; }
+            }
+            if (taken) continue;
+            if (best < 0 || ready[i].remaining_ms < ready[best].remaining_ms) best = i;
+        }
+        if (best < 0) break;
+        cands[n++] = best;
+    }
+    return n;
+}
+
+static void task_snapshot(la_task_t *t, const pcb_t *p) {
+    t->arrival_ms = p->arrival_time_ms;
+    t->time_ms = p->requested_ms;
+    t->remaining_ms = p->time_ms > p->ellapsed_time_ms ? p->time_ms - p->ellapsed_time_ms : 0;
+}
+
+void lookahead_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_tasks, int ncpus) {
+    // 1) Atualiza as tarefas em execução e envia DONE às que terminaram
+    for (int c = 0; c < ncpus; c++) {
+        pcb_t *t = cpu_tasks[c];
+        if (!t) continue;
+        t->ellapsed_time_ms += TICKS_MS;
+        if (t->ellapsed_time_ms < t->time_ms) continue;
+
+        msg_t msg = {
+            .pid = t->pid,
+            .tid = t->tid,
+            .request = PROCESS_REQUEST_DONE,
+            .time_ms = current_time_ms
+        };
+        if (channel_send(t->sockfd, &msg) < 0) {
+            perror("write");
+        }
+
+        stats_burst_done(t, current_time_ms);
+
+        free_pcb(t);
+        cpu_tasks[c] = NULL;
+    }
+
+    // 2) Uma decisão por cada CPU livre
+    for (int cpu = 0; cpu < ncpus && rq->head != NULL; cpu++) {
+        if (cpu_tasks[cpu]) continue;
+        uint64_t t0 = monotonic_ns();
+
+        // Fotografia compacta do estado atual
+        for (int c = 0; c < ncpus; c++) {
+            if (cpu_tasks[c]) {
+                task_snapshot(&running[c], cpu_tasks[c]);
+                free_at[c] = current_time_ms + running[c].remaining_ms;
+            } else {
+                free_at[c] = current_time_ms;
+            }
+        }
+        int nready = 0;
+        for (queue_elem_t *it = rq->head; it != NULL && nready < LOOKAHEAD_MAX_TASKS; it = it->next) {
+            task_snapshot(&ready[nready], it->pcb);
+            ready_elem[nready++] = it;
+        }
+
+        // Avalia cada candidato e fica com o de menor custo
+        int cands[LOOKAHEAD_MAX_CANDIDATES];
+        int ncands = pick_candidates(cands, nready);
+        int best = cands[0];
+        double best_cost = 0.0;
+        for (int k = 0; k < ncands; k++) {
+            double cost = rollout(cands[k], cpu, nready, ncpus, current_time_ms);
+            if (k == 0 || cost < best_cost) {
+                best = cands[k];
+                best_cost = cost;
+            }
+        }
+        evaluated += (uint64_t)ncands;
+
+        queue_elem_t *removed = remove_queue_elem(rq, ready_elem[best]);
+        if (removed) {
+            cpu_tasks[cpu] = removed->pcb;
+            free_queue_elem(removed);
+        }
+
+        uint64_t dt = monotonic_ns() - t0;
+        decisions++;
+        decision_ns_sum += dt;
+        if (dt > decision_ns_max) decision_ns_max = dt;
+    }
+}
+
+void lookahead_report(FILE *out) {
+    fprintf(out, "---- Lookahead (horizon %u ms, %d candidates, metric %s) ----\n",
+            horizon_ms, max_candidates, metric == LOOKAHEAD_FLOW ? "flow" : "bsld");
+    fprintf(out, "Decisions:            %llu (%.2f candidates each)\n",
+            (unsigned long long)decisions, decisions ? (double)evaluated / decisions : 0.0);
+    fprintf(out, "Decision time:        mean %.1f us, max %.1f us\n",
+            decisions ? decision_ns_sum / 1000.0 / decisions : 0.0, decision_ns_max / 1000.0);
+    fflush(out);
+}
@@ -0,0 +1,47 @@
+#ifndef LOOKAHEAD_H
+#define LOOKAHEAD_H
+
+#include <stdio.h>
+#include "queue.h"
+
+#define LOOKAHEAD_MAX_CANDIDATES 32   // limite de --la-candidates
+#define LOOKAHEAD_MAX_TASKS 256       // tarefas prontas consideradas em cada decisão
+
+// Métrica usada para comparar as decisões candidatas
+typedef enum {
+    LOOKAHEAD_FLOW = 0,   // soma dos tempos de resposta (chegada -> fim)
+    LOOKAHEAD_BSLD        // soma dos bounded slowdowns
+} lookahead_metric_en;
+
+/**
+ * @brief Horizonte da simulação de cada candidato, em ms (por omissão 2000)
+ */
+void lookahead_set_horizon(uint32_t horizon_ms);
+
+/**
+ * @brief Número de candidatos avaliados em cada decisão (1..LOOKAHEAD_MAX_CANDIDATES)
+ */
+void lookahead_set_candidates(int candidates);
+
+/**
+ * @brief Métrica usada para escolher o candidato (por omissão LOOKAHEAD_FLOW)
+ */
+void lookahead_set_metric(lookahead_metric_en metric);
+
+/**
+ * @brief Escalonador experimental LOOKAHEAD ("what-if"), não preemptivo
+ *
+ * Sempre que um CPU fica livre, tira uma fotografia compacta do estado
+ * (restante de cada tarefa em execução e das prontas), simula até ao
+ * horizonte o que acontece se cada candidato for despachado agora (e o
+ * resto seguir por ordem de chegada) e despacha o candidato com menor custo.
+ * Serve de referência quase ótima para os escalonadores heurísticos.
+ */
+void lookahead_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_tasks, int ncpus);
+
+/**
+ * @brief Imprime o número de decisões e o custo (tempo real) de decidir
+ */
+void lookahead_report(FILE *out);
+
+#endif //LOOKAHEAD_H
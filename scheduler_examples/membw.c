@@ -0,0 +1,171 @@
+#include "membw.h"
+#include "msg.h"
+#include "stats.h"
+#include "channel.h"
+#include "psi.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+/**
+ * Modelo de contenção
+ *
+ * A procura de cada socket é recalculada em cada tick a partir das tarefas
+ * nos CPUs. O atraso de cada tarefa acumula-se em us no seu PCB
+ * (mem_debt_us) e é cobrado um tick de cada vez com stall_pcb().
+ */
+
+static int socket_cpus = 0;
+static uint32_t capacity = MEMBW_DEFAULT_CAPACITY;
+static uint32_t nr_stalled = 0;        // tarefas atrasadas (contadas no PSI)
+
+// Estatísticas
+static int seen = 0;                   // já correu alguma tarefa com mem_intensity
+static uint64_t socket_ms = 0;         // Σ sockets × tempo
+static uint64_t oversub_ms = 0;        // tempo de socket com procura > capacidade
+static uint32_t peak_demand = 0;
+static uint64_t mem_run_us = 0;        // CPU usado por tarefas com mem_intensity > 0
+static double lost_us = 0.0;           // trabalho perdido para a contenção
+static uint64_t charged_ms = 0;        // atraso já cobrado às tarefas
+static uint64_t memaware_light = 0;    // despachos do MEMAWARE que cabiam no socket
+static uint64_t memaware_forced = 0;   // despachos sem nenhuma tarefa que coubesse
+
+void membw_set_socket_cpus(int cpus) {
+    socket_cpus = cpus;
+}
+
+void membw_set_capacity(uint32_t c) {
+    capacity = c;
+}
+
+static int socket_of(int cpu) {
+    return socket_cpus > 0 ? cpu / socket_cpus : 0;
+}
+
+static int nsockets(int ncpus) {
+    return socket_cpus > 0 ? (ncpus + socket_cpus - 1) / socket_cpus : 1;
+}
+
+// Procura de cada socket com as tarefas que estão agora nos CPUs
+static void socket_demand(pcb_t **cpu_tasks, int ncpus, uint32_t *demand) {
+    for (int s = 0; s < nsockets(ncpus); s++) demand[s] = 0;
+    for (int c = 0; c < ncpus; c++) {
+        if (cpu_tasks[c]) demand[socket_of(c)] += cpu_tasks[c]->mem_intensity;
+    }
+}
+
+void membw_charge(pcb_t **cpu_tasks, int ncpus) {
+    uint32_t demand[MAX_CPUS];
+    socket_demand(cpu_tasks, ncpus, demand);
+    int sockets = nsockets(ncpus);
+    socket_ms += (uint64_t)sockets * TICKS_MS;
+    for (int s = 0; s < sockets; s++) {
+        if (demand[s] > capacity) oversub_ms += TICKS_MS;
+        if (demand[s] > peak_demand) peak_demand = demand[s];
+    }
+
+    uint32_t tick_us = TICKS_MS * 1000;
+    uint32_t stalled = 0;
+    for (int c = 0; c < ncpus; c++) {
+        pcb_t *t = cpu_tasks[c];
+        if (!t || t->mem_intensity == 0) continue;
+        // Um job batch aparece em vários CPUs: atrasa-o uma só vez
+        int dup = 0;
+        for (int d = 0; d < c && !dup; d++) dup = cpu_tasks[d] == t;
+        if (dup) continue;
+        seen = 1;
+        mem_run_us += tick_us;
+
+        uint32_t d = demand[socket_of(c)];
+        if (d <= capacity) continue;
+        double f = t->mem_intensity > 100 ? 1.0 : t->mem_intensity / 100.0;
+        double stretch = (1.0 - f) + f * d / capacity;
+        uint32_t lost = (uint32_t)(tick_us * (1.0 - 1.0 / stretch));
+        lost_us += lost;
+        t->mem_debt_us += lost;
+        while (t->mem_debt_us >= tick_us) {
+            t->mem_debt_us -= tick_us;
+            stall_pcb(t, TICKS_MS);
+            charged_ms += TICKS_MS;
+        }
+        stalled++;
+    }
+    psi_memstall((int)stalled - (int)nr_stalled);
+    nr_stalled = stalled;
+}
+
+// Avança a tarefa de um CPU (mesmo tratamento do rr.c)
+static void advance(uint32_t now_ms, queue_t *rq, pcb_t **cpu_task) {
+    (*cpu_task)->ellapsed_time_ms += TICKS_MS;
+    if ((*cpu_task)->ellapsed_time_ms >= (*cpu_task)->time_ms) {
+        msg_t msg = {
+            .pid = (*cpu_task)->pid,
+            .tid = (*cpu_task)->tid,
+            .request = PROCESS_REQUEST_DONE,
+            .time_ms = now_ms
+        };
+        if (channel_send((*cpu_task)->sockfd, &msg) < 0) {
+            perror("write");
+        }
+        stats_burst_done(*cpu_task, now_ms);
+        free_pcb(*cpu_task);
+        *cpu_task = NULL;
+    } else if (now_ms - (*cpu_task)->slice_start_ms >= MEMBW_SLICE_MS) {
+        if (rq->head == NULL) {
+            (*cpu_task)->slice_start_ms = now_ms;
+        } else {
+            enqueue_pcb(rq, *cpu_task);
+            *cpu_task = NULL;
+        }
+    }
+}
+
+void memaware_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_tasks, int ncpus) {
+    for (int c = 0; c < ncpus; c++) {
+        if (cpu_tasks[c]) advance(current_time_ms, rq, &cpu_tasks[c]);
+    }
+
+    uint32_t demand[MAX_CPUS];
+    socket_demand(cpu_tasks, ncpus, demand);
+    for (int c = 0; c < ncpus && rq->head; c++) {
+        if (cpu_tasks[c]) continue;
+        uint32_t *d = &demand[socket_of(c)];
+        // A primeira que cabe na largura de banda livre; senão a mais leve
+        queue_elem_t *pick = NULL;
+        queue_elem_t *lightest = NULL;
+        for (queue_elem_t *it = rq->head; it != NULL; it = it->next) {
+            if (*d + it->pcb->mem_intensity <= capacity) {
+                pick = it;
+                break;
+            }
+            if (!lightest || it->pcb->mem_intensity < lightest->pcb->mem_intensity) lightest = it;
+        }
+        if (pick) {
+            memaware_light++;
+        } else {
+            pick = lightest;
+            memaware_forced++;
+        }
+        queue_elem_t *removed = remove_queue_elem(rq, pick);
+        if (!removed) continue;
+        cpu_tasks[c] = removed->pcb;
+        cpu_tasks[c]->slice_start_ms = current_time_ms;
+        free_queue_elem(removed);
+        *d += cpu_tasks[c]->mem_intensity;
+    }
+}
+
+void membw_report(FILE *out, int ncpus) {
+    if (!seen) return;
+    fprintf(out, "---- Memory bandwidth (%d socket(s) of %d CPU(s), capacity %u) ----\n",
+            nsockets(ncpus), socket_cpus > 0 ? socket_cpus : ncpus, capacity);
+    fprintf(out, "Oversubscribed:       %.1f %% of socket time (peak demand %u)\n",
+            socket_ms ? 100.0 * oversub_ms / socket_ms : 0.0, peak_demand);
+    fprintf(out, "Lost to contention:   %.1f ms (%.1f %% of the CPU time of memory-bound tasks), %llu ms added to bursts\n",
+            lost_us / 1000.0, mem_run_us ? 100.0 * lost_us / mem_run_us : 0.0,
+            (unsigned long long)charged_ms);
+    if (memaware_light + memaware_forced > 0) {
+        fprintf(out, "MEMAWARE dispatches:  %llu within the free bandwidth, %llu lightest-fit\n",
+                (unsigned long long)memaware_light, (unsigned long long)memaware_forced);
+    }
+    fflush(out);
+}
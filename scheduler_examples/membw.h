@@ -0,0 +1,61 @@
+#ifndef MEMBW_H
+#define MEMBW_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "queue.h"
+
+/*
+ * Contenção na largura de banda de memória, partilhada pelos CPUs de cada
+ * socket (--socket-cpus, por omissão um só socket com todos os CPUs).
+ *
+ * Cada pedido RUN traz a intensidade de memória da tarefa (msg.mem_intensity):
+ * a percentagem da largura de banda de um socket que ela usa quando corre
+ * sozinha, que é também a fração do seu tempo limitada pela memória. Em cada
+ * tick a procura de um socket é a soma das intensidades das tarefas nos seus
+ * CPUs. Se passar a capacidade C (--mem-bw, 100 por omissão), a parte de
+ * memória de cada tarefa estica na razão D/C e o burst avança à taxa
+ *
+ *     1 / ((1 - f) + f * D / C),    f = mem_intensity / 100
+ *
+ * O progresso perdido atrasa o fim do burst com stall_pcb(), como no irq.c,
+ * sem mudar o tempo pedido (o atraso conta no slowdown e não como CPU da
+ * tarefa), e cada tarefa atrasada conta como stall de memória no PSI.
+ *
+ * A política MEMAWARE é um round-robin para a máquina inteira que evita
+ * juntar tarefas pesadas: um CPU livre fica com a primeira tarefa da fila
+ * que ainda cabe na largura de banda livre do seu socket e, se nenhuma
+ * couber, com a menos intensa.
+ */
+
+#define MEMBW_DEFAULT_CAPACITY 100  // largura de banda de um socket (unidades de mem_intensity)
+#define MEMBW_SLICE_MS 500          // quantum do MEMAWARE
+
+/**
+ * @brief CPUs por socket (0 = todos os CPUs num só socket)
+ */
+void membw_set_socket_cpus(int cpus);
+
+/**
+ * @brief Largura de banda de cada socket, nas unidades de mem_intensity
+ */
+void membw_set_capacity(uint32_t capacity);
+
+/**
+ * @brief Atrasa as tarefas nos CPUs pela contenção do último tick
+ *
+ * Deve ser chamada uma vez por tick, antes do escalonador avançar as tarefas.
+ */
+void membw_charge(pcb_t **cpu_tasks, int ncpus);
+
+/**
+ * @brief Escalonador MEMAWARE (round-robin que espalha a procura de memória)
+ */
+void memaware_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_tasks, int ncpus);
+
+/**
+ * @brief Imprime a contenção: tempo sobrecarregado e CPU perdido
+ */
+void membw_report(FILE *out, int ncpus);
+
+#endif //MEMBW_H
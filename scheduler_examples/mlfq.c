@@ -1,5 +1,7 @@
 #include "queue.h"
 #include "msg.h"
+#include "stats.h"
+#include "channel.h"
 #include <unistd.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -42,6 +44,56 @@ void enqueue_mlfq(pcb_t *pcb) {
     enqueue_pcb(&levels[0].queue, pcb);
 }
 
+/**
+ * Adiciona ao nível 0 as chegadas de um tick, com o mesmo tratamento de
+ * enqueue_mlfq(), ligando a lista inteira de uma vez (batch fica vazia).
+ */
+void enqueue_batch_mlfq(queue_t *batch) {
+    for (queue_elem_t *it = batch->head; it != NULL; it = it->next) {
+        it->pcb->priority_level = 0;
+        it->pcb->ellapsed_time_ms = 0;
+        it->pcb->slice_start_ms = 0;
+    }
+    enqueue_batch(&levels[0].queue, batch);
+}
+
+/**
+ * Devolve ao seu nível um processo desalojado antes do fim do slice
+ * (por exemplo por uma reserva), mantendo o nível e o tempo já executado.
+ */
+void requeue_mlfq(pcb_t *pcb) {
+    enqueue_pcb(&levels[pcb->priority_level].queue, pcb);
+}
+
+// Junta a fila src ao fim de dst (O(1), sem copiar elementos)
+static void splice(queue_t *dst, queue_t *src) {
+    if (!src->head) return;
+    if (dst->tail) {
+        dst->tail->next = src->head;
+    } else {
+        dst->head = src->head;
+    }
+    dst->tail = src->tail;
+    src->head = src->tail = NULL;
+}
+
+/**
+ * Passa todos os processos das filas do MLFQ para rq, por ordem de nível
+ * (usado quando o ADAPTIVE troca o MLFQ por outra política).
+ */
+void mlfq_drain(queue_t *rq) {
+    for (int i = 0; i < NUM_QUEUES; i++) splice(rq, &levels[i].queue);
+}
+
+/**
+ * Passa os processos de rq para o nível 0, sem perder o tempo já executado
+ * (usado quando o ADAPTIVE troca outra política pelo MLFQ).
+ */
+void mlfq_absorb(queue_t *rq) {
+    for (queue_elem_t *it = rq->head; it != NULL; it = it->next) it->pcb->priority_level = 0;
+    splice(&levels[0].queue, rq);
+}
+
 /**
  * Escalonador MLFQ (Multi-Level Feedback Queue)
  *
@@ -61,13 +113,15 @@ void mlfq_scheduler(uint32_t current_time_ms, queue_t *rq /*unused*/, pcb_t **cp
         if ((*cpu_task)->ellapsed_time_ms >= (*cpu_task)->time_ms) {
             msg_t msg = {
                 .pid = (*cpu_task)->pid,
+                .tid = (*cpu_task)->tid,
                 .request = PROCESS_REQUEST_DONE,
                 .time_ms = current_time_ms
             };
-            if (write((*cpu_task)->sockfd, &msg, sizeof(msg_t)) != sizeof(msg_t)) {
+            if (channel_send((*cpu_task)->sockfd, &msg) < 0) {
                 perror("write");
             }
-            free(*cpu_task);
+            stats_burst_done(*cpu_task, current_time_ms);
+            free_pcb(*cpu_task);
             *cpu_task = NULL;
         }
         // 1.b) Caso o processo ainda não tenha terminado, verifica o time-slice
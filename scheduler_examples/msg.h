@@ -5,6 +5,7 @@
 // and it did not feel like making a new file just for this was justified.
 
 #define TICKS_MS 10
+#define MAX_CPUS 64   // Maximum number of simulated CPUs (--cpus)
 
 #include <stdint.h>
 #include <sys/types.h>
@@ -18,7 +19,12 @@ static const char PROCESS_REQUEST_STRINGS[][10] = {
     "RUN",
     "BLOCK",
     "ACK",
-    "DONE"
+    "DONE",
+    "LOCK",
+    "UNLOCK",
+    "PERIODIC",
+    "RESERVE",
+    "NACK"
 };
 
 // Define the types of requests a process can make to the scheduler
@@ -27,8 +33,32 @@ typedef enum  {
     PROCESS_REQUEST_BLOCK,
     PROCESS_REQUEST_ACK,
     PROCESS_REQUEST_DONE,
+    PROCESS_REQUEST_LOCK,       // Acquire a simulated mutex (DONE once it is held)
+    PROCESS_REQUEST_UNLOCK,     // Release a simulated mutex
+    PROCESS_REQUEST_PERIODIC,   // Declare a periodic task (one DONE per job, see periodic.h)
+    PROCESS_REQUEST_RESERVE,    // Ask for a CPU reservation of time_ms every period_ms (see cbs.h)
+    PROCESS_REQUEST_NACK,       // Reply to RESERVE: rejected by admission control
 } process_request_t;
 
+// Scheduling class of a RUN request under the CLASSES policy (see classes.h)
+typedef enum {
+    SCHED_CLASS_FAIR = 0,       // Normal tasks (default)
+    SCHED_CLASS_RT_FIFO,        // Real-time, runs until it blocks or a higher RT priority arrives
+    SCHED_CLASS_RT_RR,          // Real-time, round-robin among tasks of the same RT priority
+    SCHED_CLASS_BATCH,          // Throughput jobs, run when no fair task is waiting
+    SCHED_CLASS_IDLE,           // Run only when the CPU would otherwise be idle
+    SCHED_CLASS_COUNT
+} sched_class_en;
+
+// Names of the scheduling classes (workflow manifests and reports)
+static const char SCHED_CLASS_STRINGS[][8] = {
+    "fair",
+    "rt-fifo",
+    "rt-rr",
+    "batch",
+    "idle"
+};
+
 // Define the structure for page information
 // Note: Not used until we get to memory management, but defined here for completeness
 typedef struct {
@@ -40,8 +70,19 @@ typedef struct {
 // This structure is sent over the socket
 typedef struct {
     pid_t pid;                      // Process ID
+    uint32_t tid;                   // Thread ID inside the process (0 for single-threaded apps)
     process_request_t request;      // Request type
     uint32_t time_ms;               // Time information
+    uint32_t cpus;                  // Batch jobs: CPUs requested (0 = 1 CPU)
+    uint32_t estimate_ms;           // Batch jobs: declared walltime (0 = use time_ms)
+    int32_t nice;                   // Static priority of the thread (lower is more important)
+    uint32_t lock;                  // LOCK/UNLOCK: id of the simulated mutex
+    uint32_t period_ms;             // PERIODIC: release period (time_ms is the cost of each job)
+                                    // RESERVE: reservation period (time_ms is the runtime)
+    uint32_t deadline_ms;           // PERIODIC: relative deadline (0 = period_ms)
+    uint32_t jobs;                  // PERIODIC: jobs to release (0 = until the connection closes)
+    uint32_t sched_class;           // RUN: scheduling class (sched_class_en, CLASSES policy only)
+    uint32_t mem_intensity;         // RUN: share of a socket's memory bandwidth used alone (0..100)
 } msg_t;
 
 
@@ -3,350 +3,349 @@
 #include <stdint.h>
 #include <string.h>
 #include <unistd.h>
-#include <sys/socket.h>
-#include <sys/un.h>
-#include <fcntl.h>
 #include <errno.h>
 #include <signal.h>
-#include <time.h>
 
-#include "queue.h"
+#include "ossim_core.h"
 #include "msg.h"
-#include "fifo.h"
-#include "debug.h"
-
-// Protótipos dos diferentes escalonadores
-void sjf_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_task);
-void rr_scheduler (uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_task);
-
-// Funções específicas do MLFQ (definidas em mlfq.c)
-void mlfq_init(void);
-void enqueue_mlfq(pcb_t *pcb);
-void mlfq_scheduler(uint32_t current_time_ms, queue_t *rq /*unused*/, pcb_t **cpu_task);
-
-// Enum que representa o escalonador ativo
-typedef enum  {
-    NULL_SCHEDULER = -1,
-    SCHED_FIFO = 0,
-    SCHED_SJF,
-    SCHED_RR,
-    SCHED_MLFQ
-} scheduler_en;
-
-static const char *SCHEDULER_NAMES[] = {"FIFO","SJF","RR","MLFQ",NULL};
-
-// ---------------------------------------------------------
-// Funções utilitárias
-// ---------------------------------------------------------
-
-// Define um descritor de ficheiro como “non-blocking” (não bloqueante)
-// Isto permite que o servidor continue a correr mesmo que não haja mensagens.
-static int set_nonblocking(int fd) {
-    int flags = fcntl(fd, F_GETFL, 0);
-    if (flags < 0) return -1;
-    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
-}
+#include "batch.h"
+#include "gang.h"
+#include "locks.h"
+#include "lookahead.h"
+#include "alloccheck.h"
+#include "stats.h"
+#include "cbs.h"
+#include "irq.h"
+#include "autoscale.h"
+#include "hv.h"
+#include "membw.h"
+#include "adaptive.h"
+#include "delay.h"
+
+/*
+ * Linha de comandos do simulador: lê as opções, passa-as aos módulos e
+ * corre o núcleo (ver ossim_core.h) até ao fim do workflow ou ao Ctrl+C.
+ */
 
 // Variável global que serve para terminar o programa com Ctrl+C
 static volatile sig_atomic_t g_stop = 0;
 static void on_sigint(int sig) { (void)sig; g_stop = 1; }
 
 // ---------------------------------------------------------
-// Criação do socket servidor UNIX
+// Função principal do simulador (main)
 // ---------------------------------------------------------
-static int make_server_socket(const char *path) {
-    // Remove sockets antigos que possam existir
-    unlink(path);
-
-    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
-    if (fd < 0) {
-        perror("socket");
-        return -1;
-    }
-
-    struct sockaddr_un addr = {0};
-    addr.sun_family = AF_UNIX;
-    strncpy(addr.sun_path, path, sizeof(addr.sun_path)-1);
-
-    // Associa o socket ao caminho (bind)
-    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        perror("bind");
-        close(fd);
-        return -1;
-    }
-
-    // Coloca o socket a “escutar” novas ligações
-    if (listen(fd, 32) < 0) {
-        perror("listen");
-        close(fd);
-        return -1;
-    }
-
-    // Define o socket como não bloqueante
-    set_nonblocking(fd);
-    return fd;
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s <FIFO|SJF|RR|MLFQ|BATCH|HEFT|GANG|PRIO|LOOKAHEAD|RM|DM|CLASSES|MEMAWARE|ADAPTIVE> [options]\n", prog);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  --admit-hwm N   defer RUN ACKs while N or more tasks are runnable (0 = off)\n");
+    fprintf(stderr, "  --cpus N        number of simulated CPUs (1..%d, default 1)\n", MAX_CPUS);
+    fprintf(stderr, "  --backfill M    BATCH backfilling mode: easy (default) or conservative\n");
+    fprintf(stderr, "  --workflow F    run the DAG workflow manifest F in virtual time and exit\n");
+    fprintf(stderr, "  --proc-stats    print per-process accounting (sum of its threads) on exit\n");
+    fprintf(stderr, "  --trace F       write a binary event trace to F (see sched-bounds)\n");
+    fprintf(stderr, "  --pressure-log F  write load averages and PSI avg10 to CSV file F every 2 s\n");
+    fprintf(stderr, "  --perf          report hardware counters per simulator operation on exit\n");
+    fprintf(stderr, "  --alloc-check MS  fail if a tick after MS ms uses the heap (scheduler-alloccheck only)\n");
+    fprintf(stderr, "  --cbs-max-util PCT  share of each CPU that RESERVE requests may take (1..100, default %d)\n",
+            CBS_DEFAULT_MAX_UTIL);
+    fprintf(stderr, "  --irq-cost US      CPU cost of each I/O completion interrupt, in us (0 = free, default)\n");
+    fprintf(stderr, "  --napi-threshold N  poll the device above N completions/s (0 = never, default)\n");
+    fprintf(stderr, "  --napi-budget N    completions handled per poll (default %d)\n", IRQ_DEFAULT_NAPI_BUDGET);
+    fprintf(stderr, "  --slo MS           count bursts whose latency (RUN->DONE) exceeds MS\n");
+    fprintf(stderr, "  --autoscale S      bring CPUs online/offline tracking a signal: util or psi\n");
+    fprintf(stderr, "  --as-target PCT    autoscale target (default %d for util, %d for psi)\n",
+            AUTOSCALE_UTIL_TARGET, AUTOSCALE_PSI_TARGET);
+    fprintf(stderr, "  --as-min N         autoscale minimum (and initial) online CPUs (default 1)\n");
+    fprintf(stderr, "  --as-cooldown OUT IN  ms after a scale-out before the next one, and after any change before a scale-in (default %d %d)\n",
+            AUTOSCALE_COOLDOWN_OUT_MS, AUTOSCALE_COOLDOWN_IN_MS);
+    fprintf(stderr, "  --epoch MS         ADAPTIVE: duration of each epoch (default %d)\n", ADAPTIVE_EPOCH_MS);
+    fprintf(stderr, "  --bandit B         ADAPTIVE: ucb (default) or thompson\n");
+    fprintf(stderr, "  --socket-cpus N    CPUs sharing each socket's memory bandwidth (0 = all, default)\n");
+    fprintf(stderr, "  --mem-bw N         memory bandwidth of a socket, in units of mem intensity (default %d)\n",
+            MEMBW_DEFAULT_CAPACITY);
+    fprintf(stderr, "  --lhp-penalty MS   VMs: extra critical-section time when a lock holder's vCPU is preempted\n");
+    fprintf(stderr, "  --delay-report N   charge each ms of ready wait to the tasks on the CPUs; show the top N blockers\n");
+    fprintf(stderr, "  --sync-threads  threads only progress while all runnable threads of their process run\n");
+    fprintf(stderr, "                  (preemptive policies only: RR, MLFQ, PRIO, RM, DM, GANG, MEMAWARE)\n");
+    fprintf(stderr, "  --no-fill       GANG: leave the CPUs unused by the current row idle\n");
+    fprintf(stderr, "  --lock-protocol P  mutexes: none (default), inherit or ceiling\n");
+    fprintf(stderr, "  --la-horizon MS    LOOKAHEAD: how far ahead each candidate is simulated (default 2000)\n");
+    fprintf(stderr, "  --la-candidates K  LOOKAHEAD: candidates evaluated per decision (1..%d, default 8)\n",
+            LOOKAHEAD_MAX_CANDIDATES);
+    fprintf(stderr, "  --la-metric M      LOOKAHEAD: flow (default) or bsld\n");
 }
 
-// ---------------------------------------------------------
-// Leitura de mensagens dos clientes (apps)
-// ---------------------------------------------------------
-static int read_msg_nonblock(int sockfd, msg_t *out) {
-    ssize_t n = recv(sockfd, out, sizeof(*out), MSG_DONTWAIT);
-    if (n == 0) {
-        // O cliente fechou a ligação
-        return 0;
-    }
-    if (n < 0) {
-        if (errno == EAGAIN || errno == EWOULDBLOCK) return -2; // nada para ler agora
-        return -1; // erro real
-    }
-    if ((size_t)n != sizeof(*out)) return -1;
-    return 1; // leitura bem sucedida
+// Converte um argumento numérico positivo (devolve -1 se inválido)
+static long parse_uint_arg(const char *s) {
+    char *end;
+    errno = 0;
+    long v = strtol(s, &end, 10);
+    if (errno != 0 || *end != '\0' || v < 0 || v > INT32_MAX) return -1;
+    return v;
 }
 
-// ---------------------------------------------------------
-// Filas usadas no simulador:
-//   - command_q: sockets ligados (para receber pedidos)
-//   - ready_q:   processos prontos (usado por FIFO/SJF/RR)
-//   - blocked_q: processos bloqueados (I/O em curso)
-//   - cpu_task:  processo em execução no CPU
-// ---------------------------------------------------------
-
-/**
- * Aceita novas ligações e trata mensagens RUN/BLOCK de todas as ligações ativas.
- *
- * RUN  → envia ACK e adiciona o processo à fila certa:
- *          - MLFQ → enqueue_mlfq(p)
- *          - restantes → enqueue_pcb(ready_q, p)
- *
- * BLOCK → envia ACK e coloca o processo em blocked_q.
- *
- * Cada ligação mantém um PCB “de comando” apenas para guardar o socket ativo.
- */
-static void check_new_commands(queue_t *command_q,
-                               queue_t *blocked_q,
-                               queue_t *ready_q,
-                               int server_fd,
-                               uint32_t now_ms,
-                               scheduler_en scheduler)
-{
-    // 1) Aceitar novas ligações (modo não bloqueante)
-    while (1) {
-        int client = accept(server_fd, NULL, NULL);
-        if (client < 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
-            perror("accept");
-            break;
-        }
-        set_nonblocking(client);
-
-        // Cria um PCB apenas para representar esta ligação (comando)
-        pcb_t *cmd = new_pcb(-1, (uint32_t)client, 0);
-        if (!cmd) { close(client); continue; }
-        cmd->status = TASK_COMMAND;
-        enqueue_pcb(command_q, cmd);
-        DBG("New client connected (fd=%d)", client);
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    // O EXTERNAL nunca despacha sozinho: sem um agente a chamar ossim_act()
+    // o workflow não acabava
+    if (!strcmp(argv[1], "EXTERNAL")) {
+        fprintf(stderr, "EXTERNAL needs an agent that dispatches with ossim_act() (see ossim-agent)\n");
+        return EXIT_FAILURE;
     }
 
-    // 2) Lê mensagens de todos os sockets ligados (sem remover da queue)
-    for (queue_elem_t *it = command_q->head; it != NULL; it = it->next) {
-        pcb_t *cmd = it->pcb;
-        if (!cmd) continue;
-
-        msg_t msg;
-        int r = read_msg_nonblock((int)cmd->sockfd, &msg);
-        if (r == -2) continue;     // nada para ler neste tick
-        if (r <= 0) {
-            if (r == 0) {
-                DBG("Client fd=%d closed connection", (int)cmd->sockfd);
+    // Opções adicionais
+    uint32_t admit_hwm = 0;
+    int ncpus = 1;
+    const char *workflow = NULL;
+    int proc_stats = 0;
+    int sync_threads = 0;
+    const char *trace_path = NULL;
+    const char *pressure_log = NULL;
+    int perf = 0;
+    long alloc_warmup_ms = -1;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--admit-hwm") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < 0) {
+                fprintf(stderr, "Invalid value for --admit-hwm: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            admit_hwm = (uint32_t)v;
+        } else if (!strcmp(argv[i], "--cpus") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < 1 || v > MAX_CPUS) {
+                fprintf(stderr, "Invalid value for --cpus: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            ncpus = (int)v;
+        } else if (!strcmp(argv[i], "--proc-stats")) {
+            proc_stats = 1;
+        } else if (!strcmp(argv[i], "--trace") && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (!strcmp(argv[i], "--pressure-log") && i + 1 < argc) {
+            pressure_log = argv[++i];
+        } else if (!strcmp(argv[i], "--perf")) {
+            perf = 1;
+        } else if (!strcmp(argv[i], "--alloc-check") && i + 1 < argc) {
+            alloc_warmup_ms = parse_uint_arg(argv[++i]);
+            if (alloc_warmup_ms < 0) {
+                fprintf(stderr, "Invalid value for --alloc-check: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            if (!ALLOC_CHECK_AVAILABLE) {
+                fprintf(stderr, "--alloc-check needs a build with -DOSSIM_ALLOC_CHECK=ON (scheduler-alloccheck)\n");
+                return EXIT_FAILURE;
+            }
+        } else if (!strcmp(argv[i], "--cbs-max-util") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < 1 || v > 100) {
+                fprintf(stderr, "Invalid value for --cbs-max-util: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            cbs_set_max_util((uint32_t)v);
+        } else if (!strcmp(argv[i], "--irq-cost") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < 0 || v > TICKS_MS * 1000) {
+                fprintf(stderr, "Invalid value for --irq-cost: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            irq_set_cost((uint32_t)v);
+        } else if (!strcmp(argv[i], "--napi-threshold") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < 0) {
+                fprintf(stderr, "Invalid value for --napi-threshold: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            irq_set_napi_threshold((uint32_t)v);
+        } else if (!strcmp(argv[i], "--napi-budget") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < 1) {
+                fprintf(stderr, "Invalid value for --napi-budget: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            irq_set_napi_budget((uint32_t)v);
+        } else if (!strcmp(argv[i], "--slo") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < 1) {
+                fprintf(stderr, "Invalid value for --slo: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            stats_set_latency_slo((uint32_t)v);
+        } else if (!strcmp(argv[i], "--autoscale") && i + 1 < argc) {
+            i++;
+            if (!strcmp(argv[i], "util")) {
+                autoscale_set_signal(AUTOSCALE_UTIL);
+            } else if (!strcmp(argv[i], "psi")) {
+                autoscale_set_signal(AUTOSCALE_PSI);
             } else {
-                perror("read");
+                fprintf(stderr, "Invalid value for --autoscale: %s\n", argv[i]);
+                return EXIT_FAILURE;
             }
-            close((int)cmd->sockfd);
-            cmd->sockfd = (uint32_t)-1;
-            continue;
-        }
-
-        // Envia resposta imediata (ACK) a cada pedido recebido
-        msg_t ack = {
-            .pid = msg.pid,
-            .request = PROCESS_REQUEST_ACK,
-            .time_ms = now_ms
-        };
-        if (write((int)cmd->sockfd, &ack, sizeof(ack)) != sizeof(ack)) {
-            perror("write(ACK)");
-            continue;
-        }
-
-        // Tratamento do pedido recebido
-        if (msg.request == PROCESS_REQUEST_RUN) {
-            // Cria um novo PCB para este burst de execução
-            pcb_t *p = new_pcb(msg.pid, cmd->sockfd, msg.time_ms);
-            if (!p) continue;
-            p->status = TASK_RUNNING;
-            p->ellapsed_time_ms = 0;
-            p->slice_start_ms = 0;
-
-            if (scheduler == SCHED_MLFQ) {
-                enqueue_mlfq(p); // MLFQ gere internamente as suas filas
+        } else if (!strcmp(argv[i], "--as-target") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < 1 || v > 100) {
+                fprintf(stderr, "Invalid value for --as-target: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            autoscale_set_target((uint32_t)v);
+        } else if (!strcmp(argv[i], "--as-min") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < 1 || v > MAX_CPUS) {
+                fprintf(stderr, "Invalid value for --as-min: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            autoscale_set_min((int)v);
+        } else if (!strcmp(argv[i], "--as-cooldown") && i + 2 < argc) {
+            long out = parse_uint_arg(argv[++i]);
+            long in = parse_uint_arg(argv[++i]);
+            if (out < 0 || in < 0) {
+                fprintf(stderr, "Invalid value for --as-cooldown: %s %s\n", argv[i - 1], argv[i]);
+                return EXIT_FAILURE;
+            }
+            autoscale_set_cooldowns((uint32_t)out, (uint32_t)in);
+        } else if (!strcmp(argv[i], "--epoch") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < TICKS_MS) {
+                fprintf(stderr, "Invalid value for --epoch: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            adaptive_set_epoch((uint32_t)v);
+        } else if (!strcmp(argv[i], "--bandit") && i + 1 < argc) {
+            i++;
+            if (!strcmp(argv[i], "ucb")) {
+                adaptive_set_bandit(ADAPTIVE_UCB);
+            } else if (!strcmp(argv[i], "thompson")) {
+                adaptive_set_bandit(ADAPTIVE_THOMPSON);
             } else {
-                enqueue_pcb(ready_q, p);
+                fprintf(stderr, "Invalid value for --bandit: %s\n", argv[i]);
+                return EXIT_FAILURE;
             }
-
-            DBG("Process %d requested RUN for %u ms", p->pid, p->time_ms);
-        }
-        else if (msg.request == PROCESS_REQUEST_BLOCK) {
-            // O processo pediu I/O → vai para a fila de bloqueados
-            pcb_t *p = new_pcb(msg.pid, cmd->sockfd, msg.time_ms);
-            if (!p) continue;
-            p->status = TASK_BLOCKED;
-            p->ellapsed_time_ms = 0;
-            p->last_update_time_ms = now_ms;
-            enqueue_pcb(blocked_q, p);
-
-            DBG("Process %d requested BLOCK for %u ms", p->pid, p->time_ms);
-        }
-        else {
-            // Pedido não reconhecido (segurança extra)
-            DBG("Unexpected request from pid=%d type=%d", (int)msg.pid, (int)msg.request);
-        }
-    }
-}
-
-/**
- * Atualiza os processos bloqueados (I/O).
- * Quando o tempo de bloqueio termina, envia uma mensagem DONE ao processo
- * e remove-o da lista de bloqueados.
- */
-static void check_blocked_queue(queue_t *blocked_q, uint32_t now_ms) {
-    queue_elem_t *it = blocked_q->head;
-    while (it) {
-        pcb_t *p = it->pcb;
-        if (p && p->status == TASK_BLOCKED) {
-            p->ellapsed_time_ms += TICKS_MS;
-
-            if (p->ellapsed_time_ms >= p->time_ms) {
-                // O processo terminou o I/O → envia DONE
-                msg_t done = {
-                    .pid = p->pid,
-                    .request = PROCESS_REQUEST_DONE,
-                    .time_ms = now_ms
-                };
-                if (write((int)p->sockfd, &done, sizeof(done)) != sizeof(done)) {
-                    perror("write(DONE:BLOCK)");
-                }
-
-                // Remove da fila sem quebrar o iterador
-                queue_elem_t *to_remove = it;
-                it = it->next;
-                queue_elem_t *removed = remove_queue_elem(blocked_q, to_remove);
-                if (removed) {
-                    free(removed->pcb);
-                    free(removed);
-                }
-                continue;
+        } else if (!strcmp(argv[i], "--socket-cpus") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < 0 || v > MAX_CPUS) {
+                fprintf(stderr, "Invalid value for --socket-cpus: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            membw_set_socket_cpus((int)v);
+        } else if (!strcmp(argv[i], "--mem-bw") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < 1) {
+                fprintf(stderr, "Invalid value for --mem-bw: %s\n", argv[i]);
+                return EXIT_FAILURE;
             }
+            membw_set_capacity((uint32_t)v);
+        } else if (!strcmp(argv[i], "--lhp-penalty") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < 0) {
+                fprintf(stderr, "Invalid value for --lhp-penalty: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            hv_set_lhp_penalty((uint32_t)v);
+        } else if (!strcmp(argv[i], "--delay-report") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < 1) {
+                fprintf(stderr, "Invalid value for --delay-report: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            delay_enable((uint32_t)v);
+        } else if (!strcmp(argv[i], "--sync-threads")) {
+            sync_threads = 1;
+        } else if (!strcmp(argv[i], "--no-fill")) {
+            gang_set_fill(0);
+        } else if (!strcmp(argv[i], "--la-horizon") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < TICKS_MS) {
+                fprintf(stderr, "Invalid value for --la-horizon: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            lookahead_set_horizon((uint32_t)v);
+        } else if (!strcmp(argv[i], "--la-candidates") && i + 1 < argc) {
+            long v = parse_uint_arg(argv[++i]);
+            if (v < 1 || v > LOOKAHEAD_MAX_CANDIDATES) {
+                fprintf(stderr, "Invalid value for --la-candidates: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            lookahead_set_candidates((int)v);
+        } else if (!strcmp(argv[i], "--la-metric") && i + 1 < argc) {
+            i++;
+            if (!strcmp(argv[i], "flow")) {
+                lookahead_set_metric(LOOKAHEAD_FLOW);
+            } else if (!strcmp(argv[i], "bsld")) {
+                lookahead_set_metric(LOOKAHEAD_BSLD);
+            } else {
+                fprintf(stderr, "Invalid value for --la-metric: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (!strcmp(argv[i], "--lock-protocol") && i + 1 < argc) {
+            i++;
+            if (!strcmp(argv[i], "none")) {
+                locks_set_protocol(LOCK_PROTO_NONE);
+            } else if (!strcmp(argv[i], "inherit")) {
+                locks_set_protocol(LOCK_PROTO_INHERIT);
+            } else if (!strcmp(argv[i], "ceiling")) {
+                locks_set_protocol(LOCK_PROTO_CEILING);
+            } else {
+                fprintf(stderr, "Invalid value for --lock-protocol: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (!strcmp(argv[i], "--workflow") && i + 1 < argc) {
+            workflow = argv[++i];
+        } else if (!strcmp(argv[i], "--backfill") && i + 1 < argc) {
+            i++;
+            if (!strcmp(argv[i], "easy")) {
+                batch_set_backfill(BACKFILL_EASY);
+            } else if (!strcmp(argv[i], "conservative")) {
+                batch_set_backfill(BACKFILL_CONSERVATIVE);
+            } else {
+                fprintf(stderr, "Invalid value for --backfill: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
         }
-        it = it->next;
     }
-}
 
-// ---------------------------------------------------------
-// Identificação do escalonador a usar
-// ---------------------------------------------------------
-static scheduler_en get_scheduler(const char *name) {
-    if (!name) return NULL_SCHEDULER;
-    if (!strcmp(name, "FIFO"))  return SCHED_FIFO;
-    if (!strcmp(name, "SJF"))   return SCHED_SJF;
-    if (!strcmp(name, "RR"))    return SCHED_RR;
-    if (!strcmp(name, "MLFQ"))  return SCHED_MLFQ;
-    return NULL_SCHEDULER;
-}
-
-// ---------------------------------------------------------
-// Função principal do simulador (main)
-// ---------------------------------------------------------
-int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <FIFO|SJF|RR|MLFQ>\n", argv[0]);
-        return EXIT_FAILURE;
-    }
-
-    scheduler_en scheduler_type = get_scheduler(argv[1]);
-    if (scheduler_type == NULL_SCHEDULER) {
-        fprintf(stderr, "Invalid scheduler '%s'. Use FIFO, SJF, RR or MLFQ.\n", argv[1]);
-        return EXIT_FAILURE;
-    }
+    ossim_config_t cfg = {
+        .policy = argv[1],
+        .ncpus = ncpus,
+        .workflow = workflow,
+        .admit_hwm = admit_hwm,
+        .sync_threads = sync_threads,
+        .proc_stats = proc_stats,
+        .trace_path = trace_path,
+        .pressure_log = pressure_log,
+        .perf = perf,
+        .alloc_warmup_ms = alloc_warmup_ms,
+        .log = stdout
+    };
+    ossim_t *sim = ossim_create(&cfg);
+    if (!sim) return EXIT_FAILURE;
 
     signal(SIGINT, on_sigint);
 
-    int server_fd = make_server_socket(SOCKET_PATH);
-    if (server_fd < 0) return EXIT_FAILURE;
-
-    printf("Scheduler server listening on %s...\n", SOCKET_PATH);
-    printf("Active scheduler: %s\n", SCHEDULER_NAMES[scheduler_type]);
-
-    // Estruturas principais
-    queue_t command_queue = {.head=NULL, .tail=NULL};
-    queue_t ready_queue   = {.head=NULL, .tail=NULL};
-    queue_t blocked_queue = {.head=NULL, .tail=NULL};
-    pcb_t *cpu_task = NULL;
-
-    if (scheduler_type == SCHED_MLFQ) {
-        mlfq_init(); // inicializa as filas internas do MLFQ
-    }
-
     // Ciclo principal da simulação
-    uint32_t current_time_ms = 0;
     uint32_t last_print_s = 0;
-
     while (!g_stop) {
-        // 1) Receber pedidos novos das aplicações
-        check_new_commands(&command_queue, &blocked_queue, &ready_queue,
-                           server_fd, current_time_ms, scheduler_type);
-
-        // 2) Atualizar a fila de bloqueados
-        check_blocked_queue(&blocked_queue, current_time_ms);
-
-        // 3) Executar o escalonador ativo
-        switch (scheduler_type) {
-            case SCHED_FIFO:
-                fifo_scheduler(current_time_ms, &ready_queue, &cpu_task);
-                break;
-            case SCHED_SJF:
-                sjf_scheduler(current_time_ms, &ready_queue, &cpu_task);
-                break;
-            case SCHED_RR:
-                rr_scheduler(current_time_ms, &ready_queue, &cpu_task);
-                break;
-            case SCHED_MLFQ:
-                mlfq_scheduler(current_time_ms, &ready_queue, &cpu_task);
-                break;
-            default:
-                break;
-        }
-
-        // 4) Mostrar tempo de simulação uma vez por segundo
-        if ((current_time_ms / 1000) != last_print_s) {
-            last_print_s = current_time_ms / 1000;
-            printf("Current time: %u s\n", last_print_s);
-            fflush(stdout);
+        uint32_t current_time_ms = ossim_now(sim);
+        if (!ossim_tick(sim)) break;
+
+        // Mostrar tempo de simulação uma vez por segundo; sem workflow o
+        // tempo é real (um tick a cada TICKS_MS)
+        if (!workflow) {
+            if ((current_time_ms / 1000) != last_print_s) {
+                last_print_s = current_time_ms / 1000;
+                printf("Current time: %u s\n", last_print_s);
+                fflush(stdout);
+            }
+            usleep(TICKS_MS * 1000);
         }
-
-        // 5) Avançar o tempo da simulação (tick)
-        usleep(TICKS_MS * 1000);
-        current_time_ms += TICKS_MS;
     }
 
     // Encerramento e limpeza final
-    close(server_fd);
-    unlink(SOCKET_PATH);
-
-    // Liberta memória das filas restantes
-    while (command_queue.head) free(dequeue_pcb(&command_queue));
-    while (ready_queue.head)   free(dequeue_pcb(&ready_queue));
-    while (blocked_queue.head) free(dequeue_pcb(&blocked_queue));
-    if (cpu_task) free(cpu_task);
-
-    return EXIT_SUCCESS;
+    ossim_report(sim, stdout);
+    return ossim_destroy(sim) < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
 }
@@ -0,0 +1,1097 @@
+#include "ossim_core.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+#include "queue.h"
+#include "msg.h"
+#include "fifo.h"
+#include "debug.h"
+#include "stats.h"
+#include "admission.h"
+#include "batch.h"
+#include "gang.h"
+#include "locks.h"
+#include "lookahead.h"
+#include "trace.h"
+#include "perf.h"
+#include "alloccheck.h"
+#include "channel.h"
+#include "workload.h"
+#include "periodic.h"
+#include "cbs.h"
+#include "irq.h"
+#include "psi.h"
+#include "autoscale.h"
+#include "classes.h"
+#include "hv.h"
+#include "membw.h"
+#include "adaptive.h"
+#include "delay.h"
+
+// Protótipos dos diferentes escalonadores
+void sjf_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_task);
+void rr_scheduler (uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_task);
+void prio_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_task);
+
+// Funções específicas do MLFQ (definidas em mlfq.c)
+void mlfq_init(void);
+void enqueue_batch_mlfq(queue_t *batch);
+void requeue_mlfq(pcb_t *pcb);
+void mlfq_scheduler(uint32_t current_time_ms, queue_t *rq /*unused*/, pcb_t **cpu_task);
+void mlfq_drain(queue_t *rq);
+void mlfq_absorb(queue_t *rq);
+
+// Escalonador de workflows (definido em heft.c)
+void heft_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_task);
+
+// Enum que representa o escalonador ativo
+typedef enum  {
+    NULL_SCHEDULER = -1,
+    SCHED_FIFO = 0,
+    SCHED_SJF,
+    SCHED_RR,
+    SCHED_MLFQ,
+    SCHED_BATCH,
+    SCHED_HEFT,
+    SCHED_GANG,
+    SCHED_PRIO,
+    SCHED_LOOKAHEAD,
+    SCHED_RM,
+    SCHED_DM,
+    SCHED_CLASSES,
+    SCHED_MEMAWARE,
+    SCHED_ADAPTIVE,
+    SCHED_EXTERNAL
+} scheduler_en;
+
+static const char *SCHEDULER_NAMES[] = {"FIFO","SJF","RR","MLFQ","BATCH","HEFT","GANG","PRIO","LOOKAHEAD","RM","DM","CLASSES","MEMAWARE","ADAPTIVE","EXTERNAL",NULL};
+
+// ---------------------------------------------------------
+// Funções utilitárias
+// ---------------------------------------------------------
+
+// Define um descritor de ficheiro como “non-blocking” (não bloqueante)
+// Isto permite que o servidor continue a correr mesmo que não haja mensagens.
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0) return -1;
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+// ---------------------------------------------------------
+// Criação do socket servidor UNIX
+// ---------------------------------------------------------
+static int make_server_socket(const char *path) {
+    // Remove sockets antigos que possam existir
+    unlink(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path)-1);
+
+    // Associa o socket ao caminho (bind)
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("bind");
+        close(fd);
+        return -1;
+    }
+
+    // Coloca o socket a “escutar” novas ligações
+    if (listen(fd, 32) < 0) {
+        perror("listen");
+        close(fd);
+        return -1;
+    }
+
+    // Define o socket como não bloqueante
+    set_nonblocking(fd);
+    return fd;
+}
+
+// ---------------------------------------------------------
+// Filas usadas no simulador:
+//   - command_q: sockets ligados (para receber pedidos)
+//   - arrivals:  processos admitidos no tick atual (entregues juntos à política)
+//   - ready_q:   processos prontos (usado por FIFO/SJF/RR)
+//   - blocked_q: processos bloqueados (I/O em curso)
+//   - cpu_tasks: processo em execução em cada CPU
+// ---------------------------------------------------------
+
+// Escalonadores que decidem para todos os CPUs numa só chamada
+static int whole_machine(scheduler_en s) {
+    return s == SCHED_BATCH || s == SCHED_GANG || s == SCHED_LOOKAHEAD || s == SCHED_MEMAWARE;
+}
+
+// Com o ADAPTIVE, a política que joga na época atual (ver adaptive.h)
+static scheduler_en active_policy(scheduler_en s) {
+    return s == SCHED_ADAPTIVE ? (scheduler_en)adaptive_policy() : s;
+}
+
+/**
+ * Um processo admitido neste tick: fica na lista das chegadas do tick até
+ * enqueue_ready_batch() as entregar todas juntas à política.
+ */
+static void add_arrival(queue_t *arrivals, pcb_t *p) {
+    enqueue_pcb(arrivals, p);
+    stats_task_admitted(p);
+}
+
+/**
+ * Entrega as chegadas do tick às filas de prontos do escalonador ativo,
+ * pela ordem de chegada (arrivals fica vazia):
+ *   - com VMs → hv_enqueue_batch() (fila da VM de cada processo, ver hv.h)
+ *   - MLFQ → enqueue_batch_mlfq() (nível 0 das suas filas)
+ *   - CLASSES → enqueue_batch_classes() (uma fila por classe, ver classes.h)
+ *   - restantes → enqueue_batch(ready_q, ...) (junta a lista em O(1))
+ */
+static void enqueue_ready_batch(queue_t *ready_q, queue_t *arrivals, scheduler_en scheduler) {
+    if (!arrivals->head) return;
+    scheduler = active_policy(scheduler);
+    if (hv_active()) {
+        hv_enqueue_batch(arrivals);
+    } else if (scheduler == SCHED_MLFQ) {
+        enqueue_batch_mlfq(arrivals);
+    } else if (scheduler == SCHED_CLASSES) {
+        enqueue_batch_classes(arrivals);
+    } else {
+        enqueue_batch(ready_q, arrivals);
+    }
+}
+
+// Fila de prontos para onde voltam as tarefas desalojadas por uma reserva
+typedef struct {
+    queue_t *ready_q;
+    scheduler_en scheduler;
+} ready_target_t;
+
+// Devolve uma tarefa à fila de prontos (já contada como executável)
+static void displace_ready(pcb_t *p, void *ctx) {
+    ready_target_t *target = ctx;
+    scheduler_en scheduler = active_policy(target->scheduler);
+    if (scheduler == SCHED_MLFQ) {
+        requeue_mlfq(p);
+    } else if (scheduler == SCHED_CLASSES) {
+        requeue_classes(p);
+    } else {
+        enqueue_pcb(target->ready_q, p);
+    }
+}
+
+// Envia uma resposta (ACK ou NACK) com o tempo atual da simulação
+static int send_reply(uint32_t sockfd, pid_t pid, uint32_t tid,
+                      process_request_t request, uint32_t now_ms) {
+    msg_t reply = {
+        .pid = pid,
+        .tid = tid,
+        .request = request,
+        .time_ms = now_ms
+    };
+    if (channel_send(sockfd, &reply) < 0) {
+        perror("write(ACK)");
+        return -1;
+    }
+    return 0;
+}
+
+static int send_ack(uint32_t sockfd, pid_t pid, uint32_t tid, uint32_t now_ms) {
+    return send_reply(sockfd, pid, tid, PROCESS_REQUEST_ACK, now_ms);
+}
+
+// Cria um PCB “de comando” para representar uma nova ligação
+static void add_client(uint32_t fd, void *ctx) {
+    queue_t *command_q = ctx;
+    pcb_t *cmd = new_pcb(-1, fd, 0);
+    if (!cmd) { channel_close(fd); return; }
+    cmd->status = TASK_COMMAND;
+    enqueue_pcb(command_q, cmd);
+    DBG("New client connected (fd=%#x)", fd);
+}
+
+/**
+ * Trata um pedido recebido numa ligação:
+ *
+ * RUN  → com uma reserva da thread, envia ACK e entrega o pedido ao seu
+ *        servidor CBS (ver cbs.h). Sem reserva, se houver capacidade (admit_hwm == 0 ou menos de admit_hwm tarefas
+ *        executáveis), envia ACK e junta o processo às chegadas do tick.
+ *        Caso contrário o pedido fica retido na fila de admissão e o ACK
+ *        só é enviado quando for admitido (ver admit_pending()).
+ *
+ * BLOCK → envia ACK e coloca o processo em blocked_q.
+ *
+ * LOCK/UNLOCK → envia ACK; o DONE é enviado pelo módulo de mutexes quando
+ *        a thread fica com o mutex (ver locks.h).
+ *
+ * PERIODIC → envia ACK e regista a tarefa; os jobs são libertados em cada
+ *        período por release_periodic(), sem mais pedidos (ver periodic.h).
+ *
+ * RESERVE → ACK se a reserva passar no teste de utilização, NACK se não
+ *        passar (ou se a política decidir para a máquina inteira).
+ *
+ * Cada pedido tem o seu PCB, identificado por (pid, tid), por isso as
+ * threads de um mesmo processo são tratadas de forma independente.
+ */
+static void handle_request(uint32_t sockfd, const msg_t *msg,
+                           queue_t *blocked_q, queue_t *arrivals, uint32_t now_ms,
+                           scheduler_en scheduler, uint32_t admit_hwm, int ncpus)
+{
+    // Tratamento do pedido recebido
+    if (msg->request == PROCESS_REQUEST_RUN) {
+        // Cria um novo PCB para este burst de execução
+        pcb_t *p = new_pcb(msg->pid, sockfd, msg->time_ms);
+        if (!p) return;
+        p->tid = msg->tid;
+        p->status = TASK_RUNNING;
+        p->ellapsed_time_ms = 0;
+        p->slice_start_ms = 0;
+        p->arrival_time_ms = now_ms;
+        p->cpus = msg->cpus ? msg->cpus : 1;
+        p->estimate_ms = msg->estimate_ms ? msg->estimate_ms : msg->time_ms;
+        p->nice = msg->nice;
+        p->sched_class = msg->sched_class;
+        p->mem_intensity = msg->mem_intensity;
+
+        // Com reserva: já foi admitido pelo teste de utilização do CBS
+        p->reservation = cbs_lookup(msg->pid, msg->tid, sockfd);
+        if (p->reservation >= 0) {
+            if (send_ack(sockfd, msg->pid, msg->tid, now_ms) < 0) {
+                free_pcb(p);
+                return;
+            }
+            cbs_enqueue(p, now_ms);
+            stats_task_admitted(p);
+            trace_event(TRACE_ARRIVE, now_ms, p, 0, p->time_ms);
+            DBG("Process %d requested RUN for %u ms (reserved)", p->pid, p->time_ms);
+            return;
+        }
+        trace_event(TRACE_ARRIVE, now_ms, p, 0, p->time_ms);
+
+        // Sobrecarga → o pedido fica retido e o ACK é adiado
+        if (admit_hwm > 0 &&
+            (stats_runnable() >= admit_hwm || admission_pending() > 0)) {
+            if (admission_park(p)) {
+                DBG("Process %d RUN deferred (%u runnable)", p->pid, stats_runnable());
+            } else {
+                free_pcb(p);
+            }
+            return;
+        }
+
+        if (send_ack(sockfd, msg->pid, msg->tid, now_ms) < 0) {
+            free_pcb(p);
+            return;
+        }
+        add_arrival(arrivals, p);
+
+        DBG("Process %d requested RUN for %u ms", p->pid, p->time_ms);
+    }
+    else if (msg->request == PROCESS_REQUEST_BLOCK) {
+        if (send_ack(sockfd, msg->pid, msg->tid, now_ms) < 0) return;
+
+        // O processo pediu I/O → vai para a fila de bloqueados
+        pcb_t *p = new_pcb(msg->pid, sockfd, msg->time_ms);
+        if (!p) return;
+        p->tid = msg->tid;
+        p->status = TASK_BLOCKED;
+        p->ellapsed_time_ms = 0;
+        p->last_update_time_ms = now_ms;
+        p->arrival_time_ms = now_ms;
+        enqueue_pcb(blocked_q, p);
+        stats_io_started();
+        trace_event(TRACE_BLOCK, now_ms, p, 0, p->time_ms);
+
+        DBG("Process %d requested BLOCK for %u ms", p->pid, p->time_ms);
+    }
+    else if (msg->request == PROCESS_REQUEST_LOCK || msg->request == PROCESS_REQUEST_UNLOCK) {
+        if (send_ack(sockfd, msg->pid, msg->tid, now_ms) < 0) return;
+
+        pcb_t *p = new_pcb(msg->pid, sockfd, 0);
+        if (!p) return;
+        p->tid = msg->tid;
+        p->nice = msg->nice;
+        p->arrival_time_ms = now_ms;
+        if (msg->request == PROCESS_REQUEST_LOCK) {
+            locks_request(msg->lock, p, now_ms);   // fica com o PCB
+        } else {
+            locks_release(msg->lock, p, now_ms);
+            free_pcb(p);
+        }
+    }
+    else if (msg->request == PROCESS_REQUEST_PERIODIC) {
+        if (send_ack(sockfd, msg->pid, msg->tid, now_ms) < 0) return;
+        if (periodic_add(sockfd, msg, now_ms) < 0) {
+            fprintf(stderr, "Invalid PERIODIC task from pid=%d (C=%u T=%u D=%u)\n",
+                    (int)msg->pid, msg->time_ms, msg->period_ms, msg->deadline_ms);
+            return;
+        }
+        DBG("Process %d declared a periodic task (C=%u ms, T=%u ms)",
+            msg->pid, msg->time_ms, msg->period_ms);
+    }
+    else if (msg->request == PROCESS_REQUEST_RESERVE) {
+        // As políticas da máquina inteira não deixam o CBS desalojar CPUs, e
+        // com VMs os pCPUs são do anfitrião: não há capacidade para reservas
+        int ok = cbs_reserve(msg->pid, msg->tid, sockfd, msg->time_ms, msg->period_ms,
+                             whole_machine(scheduler) || hv_active() ? 0 : ncpus) == 0;
+        send_reply(sockfd, msg->pid, msg->tid, ok ? PROCESS_REQUEST_ACK : PROCESS_REQUEST_NACK, now_ms);
+        DBG("Process %d reservation of %u ms every %u ms %s",
+            msg->pid, msg->time_ms, msg->period_ms, ok ? "admitted" : "rejected");
+    }
+    else {
+        // Pedido não reconhecido (segurança extra)
+        send_ack(sockfd, msg->pid, msg->tid, now_ms);
+        DBG("Unexpected request from pid=%d type=%d", (int)msg->pid, (int)msg->request);
+    }
+}
+
+/**
+ * Aceita novas ligações e trata os pedidos RUN/BLOCK de todas as ligações ativas
+ * (ver handle_request()).
+ *
+ * Cada ligação mantém um PCB “de comando” apenas para guardar o socket ativo.
+ * Sem servidor (server_fd < 0) só há ligações virtuais do workload.
+ */
+static void check_new_commands(queue_t *command_q,
+                               queue_t *blocked_q,
+                               queue_t *arrivals,
+                               int server_fd,
+                               uint32_t now_ms,
+                               scheduler_en scheduler,
+                               uint32_t admit_hwm,
+                               int ncpus)
+{
+    // 1) Aceitar novas ligações (modo não bloqueante)
+    while (server_fd >= 0) {
+        int client = accept(server_fd, NULL, NULL);
+        if (client < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            perror("accept");
+            break;
+        }
+        set_nonblocking(client);
+        add_client((uint32_t)client, command_q);
+    }
+
+    // 2) Lê mensagens de todos os sockets ligados (sem remover da queue).
+    //    Uma ligação pode ter vários pedidos pendentes (um por thread).
+    for (queue_elem_t *it = command_q->head; it != NULL; it = it->next) {
+        pcb_t *cmd = it->pcb;
+        if (!cmd || cmd->sockfd == (uint32_t)-1) continue; // ligação já fechada
+
+        msg_t msg;
+        int r;
+        while ((r = channel_recv(cmd->sockfd, &msg)) == 1) {
+            handle_request(cmd->sockfd, &msg, blocked_q, arrivals, now_ms, scheduler, admit_hwm, ncpus);
+        }
+        if (r == -2) continue;     // nada mais para ler neste tick
+        if (r == 0) {
+            DBG("Client fd=%d closed connection", (int)cmd->sockfd);
+        } else {
+            perror("read");
+        }
+        admission_drop(cmd->sockfd);
+        locks_drop(cmd->sockfd, now_ms);
+        periodic_drop(cmd->sockfd);
+        cbs_drop(cmd->sockfd);
+        channel_close(cmd->sockfd);
+        cmd->sockfd = (uint32_t)-1;
+    }
+}
+
+/**
+ * Admite pedidos RUN retidos enquanto houver capacidade abaixo do
+ * high-water mark. Os pedidos saem em round-robin entre ligações e só
+ * agora recebem o ACK (com o tempo atual).
+ */
+static void admit_pending(queue_t *arrivals, uint32_t now_ms, uint32_t admit_hwm) {
+    while (admission_pending() > 0 && stats_runnable() < admit_hwm) {
+        pcb_t *p = admission_next();
+        if (!p) break;
+        if (send_ack(p->sockfd, p->pid, p->tid, now_ms) < 0) {
+            free_pcb(p);
+            continue;
+        }
+        stats_admission_wait(now_ms - p->arrival_time_ms);
+        add_arrival(arrivals, p);
+        DBG("Process %d admitted after %u ms", p->pid, now_ms - p->arrival_time_ms);
+    }
+}
+
+/**
+ * Liberta os jobs das tarefas periódicas que chegaram ao seu período.
+ * Não passam pelo controlo de admissão: a tarefa já foi aceite no PERIODIC.
+ */
+static void release_periodic(queue_t *arrivals, uint32_t now_ms) {
+    pcb_t *job;
+    while ((job = periodic_next_job(now_ms)) != NULL) {
+        trace_event(TRACE_ARRIVE, now_ms, job, 0, job->time_ms);
+        add_arrival(arrivals, job);
+    }
+}
+
+/**
+ * Atualiza os processos bloqueados (I/O).
+ * Quando o tempo de bloqueio termina, envia uma mensagem DONE ao processo
+ * e remove-o da lista de bloqueados. Com o modelo de interrupções a
+ * conclusão pode ficar para o poll do tick seguinte (ver irq.h).
+ */
+static void check_blocked_queue(queue_t *blocked_q, uint32_t now_ms) {
+    irq_tick(now_ms);
+    queue_elem_t *it = blocked_q->head;
+    while (it) {
+        pcb_t *p = it->pcb;
+        if (p && p->status == TASK_BLOCKED) {
+            p->ellapsed_time_ms += TICKS_MS;
+
+            if (p->ellapsed_time_ms >= p->time_ms && irq_complete(p)) {
+                // O processo terminou o I/O → envia DONE
+                msg_t done = {
+                    .pid = p->pid,
+                    .tid = p->tid,
+                    .request = PROCESS_REQUEST_DONE,
+                    .time_ms = now_ms
+                };
+                if (channel_send(p->sockfd, &done) < 0) {
+                    perror("write(DONE:BLOCK)");
+                }
+                stats_io_done(p, now_ms);
+                trace_event(TRACE_UNBLOCK, now_ms, p, 0, p->time_ms);
+
+                // Remove da fila sem quebrar o iterador
+                queue_elem_t *to_remove = it;
+                it = it->next;
+                queue_elem_t *removed = remove_queue_elem(blocked_q, to_remove);
+                if (removed) {
+                    free_pcb(removed->pcb);
+                    free_queue_elem(removed);
+                }
+                continue;
+            }
+        }
+        it = it->next;
+    }
+}
+
+// Um job batch ocupa vários CPUs: indica se a tarefa do CPU c já apareceu antes
+static int cpu_already_seen(pcb_t **cpu_tasks, int c) {
+    for (int d = 0; d < c; d++) {
+        if (cpu_tasks[d] == cpu_tasks[c]) return 1;
+    }
+    return 0;
+}
+
+/**
+ * Modelo de threads que sincronizam entre si (--sync-threads):
+ * uma thread só avança se todas as threads executáveis do seu processo
+ * (até ao número de CPUs) estiverem num CPU. Caso contrário o tick é gasto
+ * à espera delas (spin) e a thread perde esse tick de progresso (stall_pcb()).
+ * Só com políticas preemptivas (ver preemptive_policy()).
+ * Devolve o número de CPUs que passaram este tick em spin.
+ */
+static int sync_spin(pcb_t **cpu_tasks, int ncpus) {
+    int spinning = 0;
+    for (int c = 0; c < ncpus; c++) {
+        pcb_t *t = cpu_tasks[c];
+        if (!t || cpu_already_seen(cpu_tasks, c)) continue;
+
+        uint32_t on_cpu = 0;
+        for (int d = 0; d < ncpus; d++) {
+            if (cpu_tasks[d] && cpu_tasks[d]->pid == t->pid && !cpu_already_seen(cpu_tasks, d)) on_cpu++;
+        }
+        uint32_t needed = stats_proc_runnable(t->pid);
+        if (needed > (uint32_t)ncpus) needed = (uint32_t)ncpus;
+        if (on_cpu < needed) {
+            stall_pcb(t, TICKS_MS);
+            spinning++;
+        }
+    }
+    return spinning;
+}
+
+// ---------------------------------------------------------
+// Identificação do escalonador a usar
+// ---------------------------------------------------------
+static scheduler_en get_scheduler(const char *name) {
+    if (!name) return NULL_SCHEDULER;
+    if (!strcmp(name, "FIFO"))  return SCHED_FIFO;
+    if (!strcmp(name, "SJF"))   return SCHED_SJF;
+    if (!strcmp(name, "RR"))    return SCHED_RR;
+    if (!strcmp(name, "MLFQ"))  return SCHED_MLFQ;
+    if (!strcmp(name, "BATCH")) return SCHED_BATCH;
+    if (!strcmp(name, "HEFT"))  return SCHED_HEFT;
+    if (!strcmp(name, "GANG"))  return SCHED_GANG;
+    if (!strcmp(name, "PRIO"))  return SCHED_PRIO;
+    if (!strcmp(name, "LOOKAHEAD")) return SCHED_LOOKAHEAD;
+    if (!strcmp(name, "RM"))    return SCHED_RM;
+    if (!strcmp(name, "DM"))    return SCHED_DM;
+    if (!strcmp(name, "CLASSES")) return SCHED_CLASSES;
+    if (!strcmp(name, "MEMAWARE")) return SCHED_MEMAWARE;
+    if (!strcmp(name, "ADAPTIVE")) return SCHED_ADAPTIVE;
+    if (!strcmp(name, "EXTERNAL")) return SCHED_EXTERNAL;
+    return NULL_SCHEDULER;
+}
+
+// EXTERNAL: avança a tarefa do CPU como o FIFO, mas os despachos são do agente (ossim_act())
+static void external_scheduler(uint32_t now_ms, pcb_t **cpu_task) {
+    static queue_t none = {.head = NULL, .tail = NULL};
+    fifo_scheduler(now_ms, &none, cpu_task);
+}
+
+// Chama o escalonador de um CPU para o CPU cpu_task
+static void run_policy(scheduler_en scheduler, uint32_t now_ms, queue_t *rq, pcb_t **cpu_task) {
+    pcb_t *before = *cpu_task;
+    perf_begin();
+    switch (active_policy(scheduler)) {
+        case SCHED_FIFO:
+            fifo_scheduler(now_ms, rq, cpu_task);
+            break;
+        case SCHED_SJF:
+            sjf_scheduler(now_ms, rq, cpu_task);
+            break;
+        case SCHED_RR:
+            rr_scheduler(now_ms, rq, cpu_task);
+            break;
+        case SCHED_MLFQ:
+            mlfq_scheduler(now_ms, rq, cpu_task);
+            break;
+        case SCHED_HEFT:
+            heft_scheduler(now_ms, rq, cpu_task);
+            break;
+        case SCHED_PRIO:
+        case SCHED_RM:
+        case SCHED_DM:
+            prio_scheduler(now_ms, rq, cpu_task);
+            break;
+        case SCHED_CLASSES:
+            classes_scheduler(now_ms, rq, cpu_task);
+            break;
+        case SCHED_EXTERNAL:
+            external_scheduler(now_ms, cpu_task);
+            break;
+        default:
+            break;
+    }
+    perf_end(*cpu_task != before ? PERF_OP_DISPATCH : PERF_OP_TICK);
+}
+
+// Braços do ADAPTIVE: políticas de um CPU cujas filas se migram em O(1)
+static const scheduler_en ADAPTIVE_ARMS[] = {SCHED_FIFO, SCHED_SJF, SCHED_RR, SCHED_PRIO, SCHED_MLFQ};
+
+// Troca de braço: só o MLFQ tem filas próprias, as outras partilham ready_q
+static void adaptive_migrate(int from, int to, void *ctx) {
+    queue_t *ready_q = ctx;
+    if (from == SCHED_MLFQ) mlfq_drain(ready_q);
+    if (to == SCHED_MLFQ) mlfq_absorb(ready_q);
+}
+
+// Política de convidado ou do anfitrião, para o hv_scheduler()
+static void hv_run_policy(int policy, uint32_t now_ms, queue_t *rq, pcb_t **cpu_task) {
+    run_policy((scheduler_en)policy, now_ms, rq, cpu_task);
+}
+
+// Políticas que tiram as tarefas do CPU a meio do burst. Com --sync-threads
+// as outras bloqueiam: dois processos com um CPU cada, à espera de um segundo
+// CPU que o outro nunca larga, fazem spin para sempre
+static int preemptive_policy(scheduler_en s) {
+    return s == SCHED_RR || s == SCHED_MLFQ || s == SCHED_PRIO || s == SCHED_RM || s == SCHED_DM ||
+           s == SCHED_GANG || s == SCHED_MEMAWARE;
+}
+
+// Políticas de um CPU sem estado global, que podem correr dentro de uma VM
+static int guest_policy(scheduler_en s) {
+    return s == SCHED_FIFO || s == SCHED_SJF || s == SCHED_RR || s == SCHED_PRIO || s == SCHED_HEFT;
+}
+
+// ---------------------------------------------------------
+// Estado do simulador e ciclo principal
+// ---------------------------------------------------------
+
+#define OBS_INITIAL_CAPACITY 64
+
+struct ossim {
+    ossim_config_t cfg;
+    scheduler_en scheduler;
+    int online;                     // CPUs online (autoscaling)
+    int server_fd;                  // -1 com um workflow
+    uint32_t now_ms;
+    int deciding;                   // parado a meio de um tick (ossim_step())
+    uint64_t decisions;             // despachos do agente (ossim_act())
+
+    queue_t command_queue;
+    queue_t arrivals;               // chegadas do tick (ver enqueue_ready_batch())
+    queue_t ready_queue;
+    queue_t blocked_queue;
+    pcb_t *cpu_tasks[MAX_CPUS];
+
+    // Observação (vetores reutilizados, crescem só quando a fila cresce)
+    ossim_obs_t obs;
+    const pcb_t **ready_buf;
+    queue_elem_t **elem_buf;        // elemento da fila de cada tarefa de ready_buf
+    uint32_t obs_capacity;
+    int obs_valid;
+};
+
+// Os módulos têm estado global: um só simulador por processo
+static ossim_t the_sim;
+static int sim_created = 0;
+
+ossim_t *ossim_create(const ossim_config_t *cfg) {
+    if (sim_created) {
+        fprintf(stderr, "Only one simulator can exist per process\n");
+        return NULL;
+    }
+    scheduler_en scheduler_type = get_scheduler(cfg->policy);
+    if (scheduler_type == NULL_SCHEDULER) {
+        fprintf(stderr, "Invalid scheduler '%s'. Use FIFO, SJF, RR, MLFQ, BATCH, HEFT, GANG, PRIO, LOOKAHEAD, RM, DM, CLASSES, MEMAWARE or ADAPTIVE (EXTERNAL with an agent, see ossim_core.h).\n",
+                cfg->policy ? cfg->policy : "");
+        return NULL;
+    }
+    if (cfg->ncpus < 1 || cfg->ncpus > MAX_CPUS) {
+        fprintf(stderr, "Invalid number of CPUs: %d\n", cfg->ncpus);
+        return NULL;
+    }
+
+    // As políticas da máquina inteira guardam estado por CPU que não migra
+    if (autoscale_enabled() && whole_machine(scheduler_type)) {
+        fprintf(stderr, "--autoscale needs a per-CPU policy (not BATCH, GANG, LOOKAHEAD or MEMAWARE)\n");
+        return NULL;
+    }
+    if (cfg->sync_threads && !preemptive_policy(scheduler_type)) {
+        fprintf(stderr, "--sync-threads needs a preemptive policy (RR, MLFQ, PRIO, RM, DM, GANG or MEMAWARE)\n");
+        return NULL;
+    }
+
+    ossim_t *sim = &the_sim;
+    memset(sim, 0, sizeof(*sim));
+    sim->cfg = *cfg;
+    sim->scheduler = scheduler_type;
+    sim->server_fd = -1;
+    sim_created = 1;
+    FILE *log = cfg->log;
+
+    // Com um workflow o simulador corre em tempo virtual, só com aplicações
+    // simuladas: não há socket, nem espera entre ticks, e termina no fim.
+    if (cfg->workflow) {
+        int n = workload_load(cfg->workflow);
+        if (n < 0) {
+            ossim_destroy(sim);
+            return NULL;
+        }
+        if (log) fprintf(log, "Workflow %s: %d tasks (virtual time)\n", cfg->workflow, n);
+        if (hv_active()) {
+            // Com VMs, a política é a do anfitrião (vê os vCPUs como
+            // tarefas que nunca terminam) e cada VM traz a sua
+            if (scheduler_type != SCHED_FIFO && scheduler_type != SCHED_RR && scheduler_type != SCHED_PRIO) {
+                fprintf(stderr, "With VMs the host policy must be FIFO, RR or PRIO\n");
+                ossim_destroy(sim);
+                return NULL;
+            }
+            if (autoscale_enabled()) {
+                fprintf(stderr, "--autoscale cannot be used with VMs\n");
+                ossim_destroy(sim);
+                return NULL;
+            }
+            for (int v = 0; v < hv_vm_count(); v++) {
+                scheduler_en guest = get_scheduler(hv_vm_policy_name(v));
+                if (!guest_policy(guest)) {
+                    fprintf(stderr, "Invalid guest policy '%s'. Use FIFO, SJF, RR, PRIO or HEFT.\n",
+                            hv_vm_policy_name(v));
+                    ossim_destroy(sim);
+                    return NULL;
+                }
+                hv_set_vm_policy(v, guest);
+            }
+        }
+    } else {
+        sim->server_fd = make_server_socket(SOCKET_PATH);
+        if (sim->server_fd < 0) {
+            ossim_destroy(sim);
+            return NULL;
+        }
+        if (log) fprintf(log, "Scheduler server listening on %s...\n", SOCKET_PATH);
+    }
+    sim->online = autoscale_enabled() ? autoscale_start(cfg->ncpus) : cfg->ncpus;
+
+    if (log) {
+        fprintf(log, "Active scheduler: %s on %d CPU(s)\n", SCHEDULER_NAMES[scheduler_type], cfg->ncpus);
+        if (hv_active()) {
+            fprintf(log, "Virtual machines: %d, host policy %s\n", hv_vm_count(), SCHEDULER_NAMES[scheduler_type]);
+        }
+        if (autoscale_enabled()) {
+            fprintf(log, "Autoscaling: %d of %d CPU(s) online at start\n", sim->online, cfg->ncpus);
+        }
+    }
+    if (cfg->trace_path && trace_open(cfg->trace_path, SCHEDULER_NAMES[scheduler_type], (uint32_t)cfg->ncpus,
+                                      cfg->workflow ? workload_critical_path() : 0) < 0) {
+        ossim_destroy(sim);
+        return NULL;
+    }
+    if (cfg->pressure_log && psi_open_log(cfg->pressure_log) < 0) {
+        perror(cfg->pressure_log);
+        ossim_destroy(sim);
+        return NULL;
+    }
+    if (cfg->perf && perf_init() == 0 && log) {
+        fprintf(log, "Hardware counters enabled\n");
+    }
+    if (cfg->admit_hwm > 0 && log) {
+        fprintf(log, "Admission control: high-water mark of %u runnable tasks\n", cfg->admit_hwm);
+    }
+
+    if (scheduler_type == SCHED_MLFQ || scheduler_type == SCHED_ADAPTIVE) {
+        mlfq_init(); // inicializa as filas internas do MLFQ
+    }
+    if (scheduler_type == SCHED_ADAPTIVE) {
+        for (size_t k = 0; k < sizeof(ADAPTIVE_ARMS) / sizeof(ADAPTIVE_ARMS[0]); k++) {
+            adaptive_add_arm(ADAPTIVE_ARMS[k], SCHEDULER_NAMES[ADAPTIVE_ARMS[k]]);
+        }
+    }
+    if (scheduler_type == SCHED_DM) {
+        periodic_set_assignment(PERIODIC_DM);
+    }
+    if (scheduler_type == SCHED_EXTERNAL) {
+        sim->ready_buf = malloc(OBS_INITIAL_CAPACITY * sizeof(*sim->ready_buf));
+        sim->elem_buf = malloc(OBS_INITIAL_CAPACITY * sizeof(*sim->elem_buf));
+        if (!sim->ready_buf || !sim->elem_buf) {
+            ossim_destroy(sim);
+            return NULL;
+        }
+        sim->obs_capacity = OBS_INITIAL_CAPACITY;
+    }
+    return sim;
+}
+
+/**
+ * Primeira metade de um tick: chegadas, bloqueados e o escalonador ativo.
+ * Devolve 0 se o workflow já terminou.
+ */
+static int tick_begin(ossim_t *sim) {
+    const ossim_config_t *cfg = &sim->cfg;
+    scheduler_en scheduler_type = sim->scheduler;
+    uint32_t current_time_ms = sim->now_ms;
+    pcb_t **cpu_tasks = sim->cpu_tasks;
+    int ncpus = cfg->ncpus;
+
+    sim->obs_valid = 0;
+    if (cfg->alloc_warmup_ms >= 0) {
+        alloc_check_phase(current_time_ms < cfg->alloc_warmup_ms ? ALLOC_PHASE_WARMUP : ALLOC_PHASE_TICK);
+    }
+
+    // 0) Libertar as tarefas do workflow cujas dependências terminaram
+    if (cfg->workflow) {
+        if (workload_finished()) return 0;
+        workload_tick(current_time_ms, add_client, &sim->command_queue);
+    }
+
+    // O ADAPTIVE escolhe a política da época que começa agora
+    if (scheduler_type == SCHED_ADAPTIVE) {
+        adaptive_tick(current_time_ms, adaptive_migrate, &sim->ready_queue);
+    }
+
+    // 1) Receber pedidos novos das aplicações
+    perf_begin();
+    check_new_commands(&sim->command_queue, &sim->blocked_queue, &sim->arrivals,
+                       sim->server_fd, current_time_ms, scheduler_type, cfg->admit_hwm, ncpus);
+    perf_end(PERF_OP_COMMANDS);
+    if (cfg->admit_hwm > 0) {
+        admit_pending(&sim->arrivals, current_time_ms, cfg->admit_hwm);
+    }
+    release_periodic(&sim->arrivals, current_time_ms);
+    enqueue_ready_batch(&sim->ready_queue, &sim->arrivals, scheduler_type);
+
+    // 2) Atualizar a fila de bloqueados
+    perf_begin();
+    check_blocked_queue(&sim->blocked_queue, current_time_ms);
+    perf_end(PERF_OP_BLOCKED);
+    irq_charge(cpu_tasks, ncpus);
+    membw_charge(cpu_tasks, ncpus);
+
+    // 3) Executar o escalonador ativo.
+    //    Os escalonadores de um CPU são chamados para cada CPU, todos
+    //    a partilhar a mesma fila de prontos (SMP com fila global).
+    trace_cpus_begin(cpu_tasks, ncpus);
+    if (hv_active()) {
+        // Dois níveis: os convidados escolhem tarefas para os vCPUs e o
+        // anfitrião escolhe vCPUs para os pCPUs (ver hv.h)
+        hv_scheduler(current_time_ms, cpu_tasks, ncpus, scheduler_type, hv_run_policy);
+    } else if (!whole_machine(scheduler_type)) {
+        // Os CPUs com tarefas com reserva são do CBS (ver cbs.h)
+        int reserved[MAX_CPUS];
+        for (int c = 0; c < sim->online; c++) {
+            reserved[c] = cpu_tasks[c] && cpu_tasks[c]->reservation >= 0;
+            if (!reserved[c]) {
+                run_policy(scheduler_type, current_time_ms, &sim->ready_queue, &cpu_tasks[c]);
+            }
+        }
+        if (cbs_active()) {
+            ready_target_t target = {.ready_q = &sim->ready_queue, .scheduler = scheduler_type};
+            cbs_scheduler(current_time_ms, cpu_tasks, sim->online, displace_ready, &target);
+            // CPUs que as reservas largaram neste tick
+            for (int c = 0; c < sim->online; c++) {
+                if (reserved[c] && !cpu_tasks[c]) {
+                    run_policy(scheduler_type, current_time_ms, &sim->ready_queue, &cpu_tasks[c]);
+                }
+            }
+        }
+        // Autoscaling: os CPUs que saem devolvem as tarefas à fila de prontos
+        // (as tarefas com reserva continuam no seu servidor CBS)
+        if (autoscale_enabled()) {
+            int next = autoscale_tick(current_time_ms, sim->online);
+            ready_target_t target = {.ready_q = &sim->ready_queue, .scheduler = scheduler_type};
+            for (int c = next; c < sim->online; c++) {
+                if (cpu_tasks[c] && cpu_tasks[c]->reservation < 0) displace_ready(cpu_tasks[c], &target);
+                cpu_tasks[c] = NULL;
+            }
+            sim->online = next;
+        }
+    } else {
+        // O BATCH, o GANG, o LOOKAHEAD e o MEMAWARE decidem para a máquina
+        // inteira (um job ocupa vários CPUs, um gang corre todas as threads
+        // juntas, o lookahead simula todos os CPUs, o memaware soma a
+        // procura de memória de cada socket)
+        pcb_t *before[MAX_CPUS];
+        memcpy(before, cpu_tasks, (size_t)ncpus * sizeof(pcb_t *));
+        perf_begin();
+        if (scheduler_type == SCHED_BATCH) {
+            batch_scheduler(current_time_ms, &sim->ready_queue, cpu_tasks, ncpus);
+        } else if (scheduler_type == SCHED_GANG) {
+            gang_scheduler(current_time_ms, &sim->ready_queue, cpu_tasks, ncpus);
+        } else if (scheduler_type == SCHED_MEMAWARE) {
+            memaware_scheduler(current_time_ms, &sim->ready_queue, cpu_tasks, ncpus);
+        } else {
+            lookahead_scheduler(current_time_ms, &sim->ready_queue, cpu_tasks, ncpus);
+        }
+        int changed = memcmp(before, cpu_tasks, (size_t)ncpus * sizeof(pcb_t *)) != 0;
+        perf_end(changed ? PERF_OP_DISPATCH : PERF_OP_TICK);
+    }
+    return 1;
+}
+
+// Segunda metade de um tick: despachos no trace, ocupação dos CPUs e avanço do tempo
+static void tick_end(ossim_t *sim) {
+    uint32_t current_time_ms = sim->now_ms;
+    pcb_t **cpu_tasks = sim->cpu_tasks;
+    int online = sim->online;
+
+    trace_cpus_end(current_time_ms, cpu_tasks, sim->cfg.ncpus);
+
+    // Regista o primeiro despacho e a ocupação dos CPUs
+    int busy = 0;
+    uint32_t running = 0;
+    for (int c = 0; c < online; c++) {
+        if (!cpu_tasks[c]) continue;
+        busy++;
+        if (cpu_tasks[c]->start_time_ms == PCB_NOT_STARTED) {
+            cpu_tasks[c]->start_time_ms = current_time_ms;
+        }
+        if (!cpu_already_seen(cpu_tasks, c)) running++;
+    }
+    // Fragmentação: CPUs livres enquanto há tarefas à espera
+    uint32_t waiting = stats_runnable() > running ? stats_runnable() - running : 0;
+    int fragmented = (uint32_t)(online - busy) < waiting ? online - busy : (int)waiting;
+    int spinning = sim->cfg.sync_threads ? sync_spin(cpu_tasks, online) : 0;
+    stats_cpu_tick(current_time_ms, busy, running, online, fragmented, spinning);
+    delay_tick(cpu_tasks, online);
+
+    // Avançar o tempo da simulação (tick)
+    sim->now_ms += TICKS_MS;
+    sim->obs_valid = 0;
+}
+
+// Ponto de decisão do agente: um CPU online livre e tarefas na fila de prontos
+static int decision_point(const ossim_t *sim) {
+    if (sim->scheduler != SCHED_EXTERNAL || !sim->ready_queue.head) return 0;
+    for (int c = 0; c < sim->online; c++) {
+        if (!sim->cpu_tasks[c]) return 1;
+    }
+    return 0;
+}
+
+int ossim_tick(ossim_t *sim) {
+    if (sim->deciding) {
+        tick_end(sim);
+        sim->deciding = 0;
+    }
+    if (!tick_begin(sim)) return 0;
+    tick_end(sim);
+    return 1;
+}
+
+int ossim_step(ossim_t *sim) {
+    if (sim->deciding) {
+        tick_end(sim);
+        sim->deciding = 0;
+    }
+    for (;;) {
+        pcb_t *before[MAX_CPUS];
+        uint32_t runnable = stats_runnable();
+        memcpy(before, sim->cpu_tasks, sizeof(before));
+        if (!tick_begin(sim)) return 0;
+        if (sim->scheduler == SCHED_EXTERNAL ? decision_point(sim)
+                                             : runnable != stats_runnable() ||
+                                               memcmp(before, sim->cpu_tasks, sizeof(before)) != 0) {
+            sim->deciding = 1;
+            return 1;
+        }
+        tick_end(sim);
+    }
+}
+
+const ossim_obs_t *ossim_observe(ossim_t *sim) {
+    ossim_obs_t *obs = &sim->obs;
+    if (sim->obs_valid) return obs;
+
+    uint32_t n = 0;
+    for (queue_elem_t *it = sim->ready_queue.head; it != NULL; it = it->next) n++;
+    if (n > sim->obs_capacity) {
+        uint32_t cap = sim->obs_capacity ? sim->obs_capacity : OBS_INITIAL_CAPACITY;
+        while (cap < n) cap *= 2;
+        const pcb_t **r = realloc(sim->ready_buf, cap * sizeof(*r));
+        if (r) sim->ready_buf = r;
+        queue_elem_t **e = realloc(sim->elem_buf, cap * sizeof(*e));
+        if (e) sim->elem_buf = e;
+        if (r && e) sim->obs_capacity = cap;
+    }
+    n = 0;
+    for (queue_elem_t *it = sim->ready_queue.head; it != NULL && n < sim->obs_capacity; it = it->next) {
+        sim->ready_buf[n] = it->pcb;
+        sim->elem_buf[n] = it;
+        n++;
+    }
+
+    obs->now_ms = sim->now_ms;
+    obs->ncpus = sim->online;
+    obs->decision = sim->deciding && decision_point(sim);
+    obs->cpu_tasks = sim->cpu_tasks;
+    obs->ready = sim->ready_buf;
+    obs->nready = n;
+    sim->obs_valid = 1;
+    return obs;
+}
+
+int ossim_act(ossim_t *sim, int cpu, uint32_t ready_index) {
+    if (sim->scheduler != SCHED_EXTERNAL || !sim->deciding || cpu < 0 || cpu >= sim->online) return -1;
+    const ossim_obs_t *obs = ossim_observe(sim);
+    if (ready_index >= obs->nready) return -1;
+
+    queue_elem_t *removed = remove_queue_elem(&sim->ready_queue, sim->elem_buf[ready_index]);
+    if (!removed) return -1;
+    pcb_t *task = removed->pcb;
+    free_queue_elem(removed);
+    uint32_t n = obs->nready - 1;
+    memmove(&sim->ready_buf[ready_index], &sim->ready_buf[ready_index + 1],
+            (n - ready_index) * sizeof(*sim->ready_buf));
+    memmove(&sim->elem_buf[ready_index], &sim->elem_buf[ready_index + 1],
+            (n - ready_index) * sizeof(*sim->elem_buf));
+
+    // Desalojada para o fim da fila (o trace regista-o no fim do tick)
+    pcb_t *old = sim->cpu_tasks[cpu];
+    if (old) {
+        enqueue_pcb(&sim->ready_queue, old);
+        sim->ready_buf[n] = old;
+        sim->elem_buf[n] = sim->ready_queue.tail;
+        n++;
+    }
+    sim->cpu_tasks[cpu] = task;
+    task->slice_start_ms = sim->now_ms;
+    sim->obs.nready = n;
+    sim->obs.decision = decision_point(sim);
+    sim->decisions++;
+    return 0;
+}
+
+uint32_t ossim_now(const ossim_t *sim) {
+    return sim->now_ms;
+}
+
+void ossim_report(ossim_t *sim, FILE *out) {
+    const ossim_config_t *cfg = &sim->cfg;
+    const char *policy = SCHEDULER_NAMES[sim->scheduler];
+    uint32_t current_time_ms = sim->now_ms;
+    int ncpus = cfg->ncpus;
+
+    alloc_check_phase(ALLOC_PHASE_SHUTDOWN);
+    stats_print(out, current_time_ms);
+    if (cfg->proc_stats) stats_print_processes(out);
+    if (sim->scheduler == SCHED_GANG) gang_report(out);
+    if (sim->scheduler == SCHED_LOOKAHEAD) lookahead_report(out);
+    if (sim->scheduler == SCHED_CLASSES) classes_report(out);
+    if (sim->scheduler == SCHED_EXTERNAL) {
+        fprintf(out, "External dispatches:  %llu\n", (unsigned long long)sim->decisions);
+    }
+    perf_report(out);
+    locks_report(out);
+    periodic_report(out, ncpus);
+    cbs_report(out, current_time_ms, ncpus);
+    irq_report(out, current_time_ms, ncpus);
+    autoscale_report(out, current_time_ms);
+    hv_report(out, policy, ncpus);
+    membw_report(out, ncpus);
+    adaptive_report(out);
+    delay_report(out);
+    if (cfg->workflow) workload_report(out);
+    fflush(out);
+}
+
+int ossim_destroy(ossim_t *sim) {
+    alloc_check_phase(ALLOC_PHASE_SHUTDOWN);
+    trace_close();
+    psi_close_log();
+    if (sim->cfg.workflow) {
+        workload_free();
+    } else if (sim->server_fd >= 0) {
+        close(sim->server_fd);
+        unlink(SOCKET_PATH);
+    }
+
+    // Liberta memória das filas restantes
+    pcb_t **cpu_tasks = sim->cpu_tasks;
+    int ncpus = sim->cfg.ncpus;
+    if (active_policy(sim->scheduler) == SCHED_MLFQ) mlfq_drain(&sim->ready_queue);
+    while (sim->command_queue.head) free_pcb(dequeue_pcb(&sim->command_queue));
+    while (sim->arrivals.head)      free_pcb(dequeue_pcb(&sim->arrivals));
+    while (sim->ready_queue.head)   free_pcb(dequeue_pcb(&sim->ready_queue));
+    while (sim->blocked_queue.head) free_pcb(dequeue_pcb(&sim->blocked_queue));
+    // Com VMs as tarefas nos pCPUs pertencem aos vCPUs (libertadas em hv_free())
+    if (hv_active()) memset(sim->cpu_tasks, 0, sizeof(sim->cpu_tasks));
+    for (int c = 0; c < ncpus; c++) {
+        pcb_t *t = cpu_tasks[c];
+        // Os bursts com reserva pertencem ao CBS (libertados em cbs_free())
+        if (!t || t->reservation >= 0) continue;
+        // Um job batch aparece em vários CPUs: liberta-o uma só vez
+        for (int d = c; d < ncpus; d++) {
+            if (cpu_tasks[d] == t) cpu_tasks[d] = NULL;
+        }
+        free_pcb(t);
+    }
+    admission_free();
+    locks_free();
+    periodic_free();
+    cbs_free();
+    classes_free();
+    hv_free();
+    delay_free();
+    queue_pool_release();
+    perf_close();
+    free(sim->ready_buf);
+    free(sim->elem_buf);
+
+    int status = 0;
+    if (sim->cfg.alloc_warmup_ms >= 0 && alloc_check_report(stdout) > 0) status = -1;
+    memset(sim, 0, sizeof(*sim));
+    sim_created = 0;
+    return status;
+}
@@ -0,0 +1,114 @@
+#ifndef OSSIM_CORE_H
+#define OSSIM_CORE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "queue.h"
+
+/*
+ * Núcleo do simulador como biblioteca (libossim_core), para ser embebido
+ * noutro programa: um agente externo (por exemplo de aprendizagem por
+ * reforço) que observa o estado e decide os despachos.
+ *
+ * O ciclo de vida é ossim_create() → ossim_step() / ossim_tick() →
+ * ossim_report() → ossim_destroy(). As opções dos módulos (--cbs-max-util,
+ * --lock-protocol, --autoscale, ...) continuam a ser dadas pelos setters de
+ * cada módulo, antes de ossim_create(). O executável scheduler é um cliente
+ * desta biblioteca (ver ossim.c).
+ *
+ * Com a política EXTERNAL o simulador avança as tarefas nos CPUs até ao fim
+ * do burst, como o FIFO, mas nunca despacha: cada CPU livre com tarefas na
+ * fila de prontos é um ponto de decisão. ossim_step() simula até ao próximo
+ * e pára a meio desse tick, antes da contabilidade dos CPUs; o agente lê o
+ * estado com ossim_observe() e despacha com ossim_act(). Os despachos contam
+ * assim para o mesmo tick, como os de uma política interna.
+ *
+ * Com as outras políticas ossim_step() pára em cada tick em que um CPU mudou
+ * de tarefa ou o número de tarefas executáveis mudou (só para observar).
+ *
+ * Os módulos guardam o seu estado em variáveis globais: só pode existir um
+ * simulador em cada processo.
+ */
+
+// Configuração do simulador (as mesmas opções da linha de comandos)
+typedef struct {
+    const char *policy;         // nome da política (FIFO, RR, ..., EXTERNAL)
+    int ncpus;                  // 1..MAX_CPUS
+    const char *workflow;       // manifesto em tempo virtual; NULL = servidor no socket UNIX
+    uint32_t admit_hwm;         // high-water mark da admissão (0 = sem controlo)
+    int sync_threads;           // --sync-threads
+    int proc_stats;             // relatório por processo em ossim_report()
+    const char *trace_path;     // trace binário (NULL = sem trace)
+    const char *pressure_log;   // CSV das load averages e do PSI (NULL = sem registo)
+    int perf;                   // contadores de hardware por operação
+    long alloc_warmup_ms;       // --alloc-check (-1 = sem verificação)
+    FILE *log;                  // mensagens de arranque (NULL = silencioso)
+} ossim_config_t;
+
+typedef struct ossim ossim_t;
+
+/*
+ * Observação sem cópias: os ponteiros apontam para os PCBs do simulador
+ * (as características de cada tarefa são os campos de pcb_t) e para vetores
+ * internos reutilizados. Só é válida até à próxima chamada a ossim_step(),
+ * ossim_tick() ou ossim_observe(); ossim_act() atualiza-a no próprio lugar.
+ */
+typedef struct {
+    uint32_t now_ms;            // tempo do tick atual
+    int ncpus;                  // CPUs online
+    int decision;               // 1 = há um CPU livre e tarefas prontas (EXTERNAL)
+    pcb_t *const *cpu_tasks;    // tarefa em cada CPU (NULL = livre)
+    const pcb_t *const *ready;  // fila de prontos global, pela ordem da fila
+    uint32_t nready;            // (vazia nas políticas com filas próprias: MLFQ, CLASSES, VMs)
+} ossim_obs_t;
+
+/**
+ * @brief Cria o simulador (lê o workflow ou abre o socket do servidor)
+ * @return O simulador, ou NULL se a configuração for inválida ou já existir um
+ */
+ossim_t *ossim_create(const ossim_config_t *cfg);
+
+/**
+ * @brief Simula um tick completo (acaba primeiro o tick de um ossim_step() pendente)
+ * @return 1, ou 0 quando o workflow terminou
+ */
+int ossim_tick(ossim_t *sim);
+
+/**
+ * @brief Simula até ao próximo evento (ver acima)
+ * @return 1 parado num evento, 0 quando o workflow terminou
+ */
+int ossim_step(ossim_t *sim);
+
+/**
+ * @brief Estado atual, sem cópias (ver ossim_obs_t)
+ */
+const ossim_obs_t *ossim_observe(ossim_t *sim);
+
+/**
+ * @brief Despacha a tarefa ready[ready_index] da observação no CPU cpu
+ *
+ * Se o CPU estiver ocupado, a tarefa que lá está é desalojada para o fim da
+ * fila de prontos. Só com a política EXTERNAL, parado num ponto de decisão.
+ *
+ * @return 0, ou -1 se o despacho for inválido
+ */
+int ossim_act(ossim_t *sim, int cpu, uint32_t ready_index);
+
+/**
+ * @brief Tempo do próximo tick a simular, em ms
+ */
+uint32_t ossim_now(const ossim_t *sim);
+
+/**
+ * @brief Imprime os relatórios de fim de simulação
+ */
+void ossim_report(ossim_t *sim, FILE *out);
+
+/**
+ * @brief Liberta o simulador e todas as tarefas que ainda tem
+ * @return 0, ou -1 se a verificação --alloc-check encontrou alocações nos ticks
+ */
+int ossim_destroy(ossim_t *sim);
+
+#endif //OSSIM_CORE_H
@@ -0,0 +1,230 @@
+#include "perf.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+// Contadores do grupo; o primeiro que abrir é o líder
+typedef enum {
+    CNT_CYCLES = 0,
+    CNT_INSTRUCTIONS,
+    CNT_CACHE_MISSES,
+    CNT_BRANCH_MISSES,
+    CNT_TASK_CLOCK,       // evento de software (ns), existe mesmo sem PMU
+    CNT_COUNT
+} counter_en;
+
+static const char *COUNTER_NAMES[CNT_COUNT] = {"cycles", "instructions", "cache-misses", "branch-misses",
+                                                  "task-clock"};
+static const char *OP_NAMES[PERF_OP_COUNT] = {"commands", "blocked", "sched tick", "sched dispatch"};
+
+static int enabled = 0;
+static int fds[CNT_COUNT] = {-1, -1, -1, -1, -1};
+static int slot[CNT_COUNT] = {-1, -1, -1, -1, -1};  // posição na leitura do grupo
+static int leader = -1;
+static int nopen = 0;
+
+static uint64_t start[CNT_COUNT];
+static uint64_t start_enabled = 0, start_running = 0;
+static double total[PERF_OP_COUNT][CNT_COUNT];     // já escalados pela multiplexagem
+static uint64_t calls[PERF_OP_COUNT];
+static uint64_t unmeasured[PERF_OP_COUNT];         // chamadas em que o grupo nunca esteve na PMU
+static uint64_t time_enabled = 0, time_running = 0;
+static int read_failed = 0;                         // a leitura falhou a meio: totais parciais
+
+int perf_enabled(void) {
+    return enabled;
+}
+
+#ifdef __linux__
+
+static const uint32_t TYPES[CNT_COUNT] = {
+    PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_SOFTWARE
+};
+
+static const uint64_t CONFIGS[CNT_COUNT] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+    PERF_COUNT_SW_TASK_CLOCK
+};
+
+int perf_init(void) {
+    int first_errno = 0;
+    for (int c = 0; c < CNT_COUNT; c++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = TYPES[c];
+        attr.config = CONFIGS[c];
+        attr.disabled = (leader < 0);      // o grupo arranca todo de uma vez
+        attr.exclude_kernel = 1;           // basta perf_event_paranoid <= 2
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+        int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+        if (fd < 0) {
+            if (!first_errno) first_errno = errno;
+            continue;
+        }
+        if (leader < 0) leader = fd;
+        fds[c] = fd;
+        slot[c] = nopen++;
+    }
+    if (leader < 0) {
+        fprintf(stderr, "Perf events unavailable (%s), --perf ignored\n", strerror(first_errno));
+        return -1;
+    }
+    if (nopen < CNT_COUNT) {
+        fprintf(stderr, "Perf events unavailable (%s):", strerror(first_errno));
+        for (int c = 0; c < CNT_COUNT; c++) {
+            if (fds[c] < 0) fprintf(stderr, " %s", COUNTER_NAMES[c]);
+        }
+        fprintf(stderr, "\n");
+    }
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    enabled = 1;
+    return 0;
+}
+
+// Lê o grupo inteiro com uma só chamada ao sistema
+static int read_group(uint64_t *vals) {
+    struct {
+        uint64_t nr;
+        uint64_t time_enabled;
+        uint64_t time_running;
+        uint64_t values[CNT_COUNT];
+    } buf;
+    ssize_t n = read(leader, &buf, sizeof(buf));
+    if (n < (ssize_t)(3 + nopen) * (ssize_t)sizeof(uint64_t)) {
+        if (n >= 0) errno = EIO;           // leitura curta
+        return -1;
+    }
+    for (int c = 0; c < CNT_COUNT; c++) {
+        vals[c] = slot[c] >= 0 ? buf.values[slot[c]] : 0;
+    }
+    time_enabled = buf.time_enabled;
+    time_running = buf.time_running;
+    return 0;
+}
+
+void perf_close(void) {
+    for (int c = 0; c < CNT_COUNT; c++) {
+        if (fds[c] >= 0) close(fds[c]);
+        fds[c] = -1;
+        slot[c] = -1;
+    }
+    leader = -1;
+    nopen = 0;
+    enabled = 0;
+}
+
+#else
+
+int perf_init(void) {
+    fprintf(stderr, "Hardware counters need Linux perf events, --perf ignored\n");
+    return -1;
+}
+
+static int read_group(uint64_t *vals) {
+    (void)vals;
+    return -1;
+}
+
+void perf_close(void) {
+}
+
+#endif
+
+// Deixa de medir, mas o relatório sai com o que já foi medido
+static void read_error(void) {
+    fprintf(stderr, "Perf counters: read failed (%s), measuring stopped; the report covers the operations before it\n",
+            strerror(errno));
+    enabled = 0;
+    read_failed = 1;
+}
+
+void perf_begin(void) {
+    if (!enabled) return;
+    if (read_group(start) < 0) {
+        read_error();
+        return;
+    }
+    start_enabled = time_enabled;
+    start_running = time_running;
+}
+
+void perf_end(perf_op_en op) {
+    if (!enabled) return;
+    uint64_t now[CNT_COUNT];
+    if (read_group(now) < 0) {
+        read_error();
+        return;
+    }
+    // Com multiplexagem o grupo só conta parte do tempo: escala-se como o
+    // perf stat, por tempo ativo / tempo na PMU, dentro desta operação
+    uint64_t on = time_enabled - start_enabled;
+    uint64_t run = time_running - start_running;
+    if (run == 0 && on > 0) {
+        unmeasured[op]++;
+        return;
+    }
+    double scale = run > 0 && run < on ? (double)on / (double)run : 1.0;
+    for (int c = 0; c < CNT_COUNT; c++) total[op][c] += (double)(now[c] - start[c]) * scale;
+    calls[op]++;
+}
+
+// Eventos por mil instruções, ou "-" se o contador não existe
+static void print_per_kinstr(FILE *out, int c, const double *t) {
+    if (slot[c] < 0 || slot[CNT_INSTRUCTIONS] < 0 || t[CNT_INSTRUCTIONS] == 0) {
+        fprintf(out, " %14s", "-");
+    } else {
+        fprintf(out, " %14.2f", 1000.0 * t[c] / t[CNT_INSTRUCTIONS]);
+    }
+}
+
+void perf_report(FILE *out) {
+    if (!enabled && !read_failed) return;
+    fprintf(out, "---- Perf counters (per operation) ----\n");
+    fprintf(out, "%-15s %10s %10s %12s %12s %6s %14s %14s\n", "operation", "calls", "ns/call",
+            "cycles/call", "instr/call", "IPC", "cache-miss/ki", "branch-miss/ki");
+    for (int op = 0; op < PERF_OP_COUNT; op++) {
+        const double *t = total[op];
+        fprintf(out, "%-15s %10llu", OP_NAMES[op], (unsigned long long)calls[op]);
+        double n = calls[op] ? (double)calls[op] : 1.0;
+        if (slot[CNT_TASK_CLOCK] >= 0) fprintf(out, " %10.0f", t[CNT_TASK_CLOCK] / n);
+        else fprintf(out, " %10s", "-");
+        if (slot[CNT_CYCLES] >= 0) fprintf(out, " %12.0f", t[CNT_CYCLES] / n);
+        else fprintf(out, " %12s", "-");
+        if (slot[CNT_INSTRUCTIONS] >= 0) fprintf(out, " %12.0f", t[CNT_INSTRUCTIONS] / n);
+        else fprintf(out, " %12s", "-");
+        if (slot[CNT_CYCLES] >= 0 && slot[CNT_INSTRUCTIONS] >= 0 && t[CNT_CYCLES] > 0) {
+            fprintf(out, " %6.2f", t[CNT_INSTRUCTIONS] / t[CNT_CYCLES]);
+        } else {
+            fprintf(out, " %6s", "-");
+        }
+        print_per_kinstr(out, CNT_CACHE_MISSES, t);
+        print_per_kinstr(out, CNT_BRANCH_MISSES, t);
+        fprintf(out, "\n");
+    }
+    if (time_running < time_enabled && time_enabled > 0) {
+        uint64_t lost = 0;
+        for (int op = 0; op < PERF_OP_COUNT; op++) lost += unmeasured[op];
+        fprintf(out, "Counters multiplexed: the group ran %.1f %% of the time, values scaled by enabled/running\n",
+                100.0 * (double)time_running / (double)time_enabled);
+        if (lost) fprintf(out, "                      %llu calls ran while the group was off the PMU and are not in the table\n",
+                          (unsigned long long)lost);
+    }
+    if (read_failed) {
+        fprintf(out, "Counters stopped:     a read failed during the run, totals are partial\n");
+    }
+}
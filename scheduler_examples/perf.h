@@ -0,0 +1,58 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdio.h>
+
+/*
+ * Contadores de hardware (perf_event_open) à volta das fases do simulador.
+ *
+ * Com --perf, cada operação do ciclo principal é medida com um grupo de
+ * contadores (ciclos, instruções, cache misses e branch misses, só em modo
+ * utilizador, mais o task-clock de software) e os totais são mostrados por
+ * operação no fim, com IPC e misses por mil instruções. Sem PMU (por exemplo
+ * numa VM ou container) fica só o task-clock; se nenhum evento abrir (ou com
+ * perf_event_paranoid alto), perf_init() avisa e as restantes funções não
+ * fazem nada.
+ */
+
+// Operações medidas
+typedef enum {
+    PERF_OP_COMMANDS = 0,   // check_new_commands (pedidos novos)
+    PERF_OP_BLOCKED,        // check_blocked_queue (fim de I/O)
+    PERF_OP_TICK,           // chamada ao escalonador que não mudou nenhum CPU
+    PERF_OP_DISPATCH,       // chamada ao escalonador que mudou a tarefa de algum CPU
+    PERF_OP_COUNT
+} perf_op_en;
+
+/**
+ * @brief Abre o grupo de contadores
+ * @return 0 se os contadores estão ativos, -1 se não estão disponíveis
+ */
+int perf_init(void);
+
+/**
+ * @brief Indica se os contadores estão ativos
+ */
+int perf_enabled(void);
+
+/**
+ * @brief Início de uma operação (lê os contadores)
+ */
+void perf_begin(void);
+
+/**
+ * @brief Fim de uma operação: acumula a diferença desde perf_begin() em op
+ */
+void perf_end(perf_op_en op);
+
+/**
+ * @brief Imprime os totais e as médias por operação
+ */
+void perf_report(FILE *out);
+
+/**
+ * @brief Fecha os contadores
+ */
+void perf_close(void);
+
+#endif //PERF_H
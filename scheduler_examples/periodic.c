@@ -0,0 +1,188 @@
+#include "periodic.h"
+#include <math.h>
+#include <stdlib.h>
+
+/**
+ * Tarefas periódicas e análise de tempo de resposta
+ *
+ * A tabela só cresce quando chega um pedido PERIODIC; as tarefas cuja
+ * ligação fechou ficam inativas, mas continuam na tabela para o relatório.
+ * Cada job guarda no PCB o índice da sua tarefa (pcb->periodic).
+ */
+
+typedef struct {
+    int32_t pid;
+    uint32_t tid;
+    uint32_t sockfd;
+    uint32_t wcet_ms;           // C
+    uint32_t period_ms;         // T
+    uint32_t deadline_ms;       // D (relativo, <= T)
+    uint32_t jobs;              // jobs a libertar (0 = até desligar)
+    uint32_t next_release_ms;
+    int active;
+
+    uint32_t released;
+    uint32_t completed;
+    uint32_t missed;
+    uint64_t response_sum_ms;
+    uint32_t response_max_ms;
+} periodic_task_t;
+
+static periodic_assign_en assignment = PERIODIC_RM;
+
+static periodic_task_t *ptasks = NULL;
+static int nptasks = 0;
+static int ptasks_cap = 0;
+
+void periodic_set_assignment(periodic_assign_en assign) {
+    assignment = assign;
+}
+
+// Chave da prioridade fixa (menor = mais prioritária)
+static uint32_t prio_key(const periodic_task_t *t) {
+    return assignment == PERIODIC_DM ? t->deadline_ms : t->period_ms;
+}
+
+int periodic_add(uint32_t sockfd, const msg_t *msg, uint32_t now_ms) {
+    uint32_t d = msg->deadline_ms ? msg->deadline_ms : msg->period_ms;
+    if (msg->time_ms == 0 || msg->period_ms == 0 ||
+        msg->period_ms % TICKS_MS != 0 || d % TICKS_MS != 0 || d > msg->period_ms) {
+        return -1;
+    }
+    if (nptasks == ptasks_cap) {
+        int cap = ptasks_cap ? 2 * ptasks_cap : 8;
+        periodic_task_t *v = realloc(ptasks, (size_t)cap * sizeof(periodic_task_t));
+        if (!v) return -1;
+        ptasks = v;
+        ptasks_cap = cap;
+    }
+    ptasks[nptasks++] = (periodic_task_t){
+        .pid = msg->pid,
+        .tid = msg->tid,
+        .sockfd = sockfd,
+        .wcet_ms = msg->time_ms,
+        .period_ms = msg->period_ms,
+        .deadline_ms = d,
+        .jobs = msg->jobs,
+        .next_release_ms = now_ms,
+        .active = 1
+    };
+    return 0;
+}
+
+pcb_t *periodic_next_job(uint32_t now_ms) {
+    for (int i = 0; i < nptasks; i++) {
+        periodic_task_t *t = &ptasks[i];
+        if (!t->active || t->next_release_ms > now_ms) continue;
+        if (t->jobs > 0 && t->released >= t->jobs) {
+            t->active = 0;
+            continue;
+        }
+        pcb_t *job = new_pcb(t->pid, t->sockfd, t->wcet_ms);
+        if (!job) return NULL;
+        job->tid = t->tid;
+        job->status = TASK_RUNNING;
+        job->arrival_time_ms = t->next_release_ms;
+        job->deadline_ms = t->next_release_ms + t->deadline_ms;
+        job->nice = PERIODIC_NICE_BASE + (int32_t)prio_key(t);
+        job->periodic = i;
+        t->released++;
+        t->next_release_ms += t->period_ms;
+        return job;
+    }
+    return NULL;
+}
+
+void periodic_job_done(const pcb_t *job, uint32_t now_ms) {
+    if (job->periodic < 0 || job->periodic >= nptasks) return;
+    periodic_task_t *t = &ptasks[job->periodic];
+    uint32_t response = now_ms - job->arrival_time_ms;
+    t->completed++;
+    t->response_sum_ms += response;
+    if (response > t->response_max_ms) t->response_max_ms = response;
+    if (now_ms > job->deadline_ms) t->missed++;
+}
+
+void periodic_drop(uint32_t sockfd) {
+    for (int i = 0; i < nptasks; i++) {
+        if (ptasks[i].sockfd == sockfd) ptasks[i].active = 0;
+    }
+}
+
+// Os jobs correm em ticks inteiros: o custo efetivo é C arredondado ao tick
+static uint64_t ticks_up(uint32_t ms) {
+    return (ms + TICKS_MS - 1) / TICKS_MS * TICKS_MS;
+}
+
+/*
+ * Análise de tempo de resposta (Joseph & Pandya / Audsley):
+ *     R = C_i + Σ_{j ∈ hp(i)} ⌈R / T_j⌉ C_j
+ * iterada a partir de R = C_i até convergir. Tarefas com a mesma prioridade
+ * contam como interferência (o PRIO faz round-robin entre elas).
+ * Devolve 0 se R ultrapassar D_i (tarefa não escalonável).
+ */
+static uint64_t response_bound(int i) {
+    const periodic_task_t *ti = &ptasks[i];
+    uint64_t r = ticks_up(ti->wcet_ms);
+    for (;;) {
+        uint64_t next = ticks_up(ti->wcet_ms);
+        for (int j = 0; j < nptasks; j++) {
+            if (j == i || prio_key(&ptasks[j]) > prio_key(ti)) continue;
+            uint64_t tj = ptasks[j].period_ms;
+            next += (r + tj - 1) / tj * ticks_up(ptasks[j].wcet_ms);
+        }
+        if (next > ti->deadline_ms) return 0;
+        if (next == r) return r;
+        r = next;
+    }
+}
+
+void periodic_report(FILE *out, int ncpus) {
+    if (nptasks == 0) return;
+    double u = 0.0;
+    for (int i = 0; i < nptasks; i++) {
+        u += (double)ticks_up(ptasks[i].wcet_ms) / ptasks[i].period_ms;
+    }
+    int implicit = 1;   // o limite de Liu-Layland só vale com D = T
+    for (int i = 0; i < nptasks; i++) {
+        if (ptasks[i].deadline_ms != ptasks[i].period_ms) implicit = 0;
+    }
+    double ll = nptasks * (pow(2.0, 1.0 / nptasks) - 1.0);
+
+    fprintf(out, "---- Periodic tasks (%s) ----\n", assignment == PERIODIC_DM ? "deadline-monotonic" : "rate-monotonic");
+    if (implicit) {
+        fprintf(out, "Utilization:          %.3f (Liu-Layland bound %.3f for %d tasks%s)\n",
+                u, ll, nptasks, u <= ll ? ", schedulable" : ", see RTA");
+    } else {
+        fprintf(out, "Utilization:          %.3f (some D < T: Liu-Layland does not apply, see RTA)\n", u);
+    }
+    if (ncpus > 1) {
+        fprintf(out, "Note:                 RTA bounds assume 1 CPU; %d CPUs share the ready queue\n", ncpus);
+    }
+    fprintf(out, "%-8s %4s %6s %6s %6s %6s %6s %9s %9s %9s\n",
+            "pid", "tid", "C", "T", "D", "jobs", "missed", "mean.R", "worst.R", "RTA.R");
+    for (int i = 0; i < nptasks; i++) {
+        const periodic_task_t *t = &ptasks[i];
+        uint64_t bound = response_bound(i);
+        char rta[24];
+        if (bound) {
+            snprintf(rta, sizeof(rta), "%llu", (unsigned long long)bound);
+        } else {
+            snprintf(rta, sizeof(rta), "> D");
+        }
+        fprintf(out, "%-8d %4u %6u %6u %6u %6u %6u %9.1f %9u %9s%s\n",
+                t->pid, t->tid, t->wcet_ms, t->period_ms, t->deadline_ms,
+                t->completed, t->missed,
+                t->completed ? (double)t->response_sum_ms / t->completed : 0.0,
+                t->response_max_ms, rta,
+                bound && t->response_max_ms > bound ? "  (exceeds bound)" : "");
+    }
+    fflush(out);
+}
+
+void periodic_free(void) {
+    free(ptasks);
+    ptasks = NULL;
+    nptasks = 0;
+    ptasks_cap = 0;
+}
@@ -0,0 +1,74 @@
+#ifndef PERIODIC_H
+#define PERIODIC_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "queue.h"
+#include "msg.h"
+
+/*
+ * Tarefas periódicas (modelo de Liu & Layland).
+ *
+ * Um pedido PERIODIC declara uma tarefa com custo C (time_ms), período T
+ * (period_ms), prazo relativo D (deadline_ms, 0 = igual ao período) e um
+ * número de jobs (jobs, 0 = até a ligação fechar). O simulador responde com
+ * ACK e, a partir daí, liberta um job a cada período sem mais pedidos da
+ * aplicação: cada job é um PCB com chegada no instante de libertação e prazo
+ * absoluto libertação + D, e recebe um DONE quando termina.
+ *
+ * A prioridade fixa de cada job é atribuída pela ordem do período
+ * (rate-monotonic, RM) ou do prazo relativo (deadline-monotonic, DM), e fica
+ * sempre acima de qualquer tarefa aperiódica (que corre em segundo plano).
+ */
+
+// Os jobs periódicos têm nice = PERIODIC_NICE_BASE + T (RM) ou + D (DM)
+#define PERIODIC_NICE_BASE (INT32_MIN / 2)
+
+typedef enum {
+    PERIODIC_RM = 0,    // menor período → mais prioritária
+    PERIODIC_DM         // menor prazo relativo → mais prioritária
+} periodic_assign_en;
+
+/**
+ * @brief Escolhe a atribuição de prioridades (por omissão RM)
+ */
+void periodic_set_assignment(periodic_assign_en assign);
+
+/**
+ * @brief Regista uma tarefa periódica; o primeiro job sai já em now_ms
+ *
+ * Os períodos e prazos têm de ser múltiplos de TICKS_MS, com D <= T.
+ * @return 0 em caso de sucesso, -1 se a declaração for inválida
+ */
+int periodic_add(uint32_t sockfd, const msg_t *msg, uint32_t now_ms);
+
+/**
+ * @brief Próximo job a libertar neste tick (NULL quando não há mais)
+ *
+ * O PCB devolvido já tem arrival_time_ms, deadline_ms e nice preenchidos e
+ * deve ser colocado na fila de prontos.
+ */
+pcb_t *periodic_next_job(uint32_t now_ms);
+
+/**
+ * @brief Um job terminou: regista o tempo de resposta e se falhou o prazo
+ */
+void periodic_job_done(const pcb_t *job, uint32_t now_ms);
+
+/**
+ * @brief Uma ligação fechou: as suas tarefas deixam de libertar jobs
+ */
+void periodic_drop(uint32_t sockfd);
+
+/**
+ * @brief Imprime, por tarefa, a resposta observada contra o limite da
+ *        análise de tempo de resposta (RTA) e o teste de utilização
+ */
+void periodic_report(FILE *out, int ncpus);
+
+/**
+ * @brief Liberta a tabela de tarefas periódicas
+ */
+void periodic_free(void);
+
+#endif //PERIODIC_H
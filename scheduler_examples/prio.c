@@ -0,0 +1,80 @@
+#include "queue.h"
+#include "msg.h"
+#include "stats.h"
+#include "channel.h"
+#include "locks.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#define PRIO_TIME_SLICE 500 // quantum entre processos com a mesma prioridade
+
+/**
+ * Escalonador de prioridades fixas (PRIO), preemptivo
+ *
+ * Cada pedido RUN traz o nice da thread (menor nice = mais importante).
+ * O CPU fica sempre com a tarefa pronta de maior prioridade efetiva, que é
+ * o nice eventualmente elevado pelo protocolo de mutexes (ver locks.h):
+ * com herança ou teto de prioridade, a dona de um mutex não é ultrapassada
+ * por tarefas de prioridade intermédia enquanto uma mais importante espera.
+ *
+ * Entre tarefas com a mesma prioridade faz round-robin com PRIO_TIME_SLICE.
+ */
+void prio_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_task) {
+    // 1) Atualiza o processo que está no CPU (caso exista)
+    if (*cpu_task) {
+        (*cpu_task)->ellapsed_time_ms += TICKS_MS;
+
+        if ((*cpu_task)->ellapsed_time_ms >= (*cpu_task)->time_ms) {
+            // Envia mensagem DONE para a aplicação correspondente
+            msg_t msg = {
+                .pid = (*cpu_task)->pid,
+                .tid = (*cpu_task)->tid,
+                .request = PROCESS_REQUEST_DONE,
+                .time_ms = current_time_ms
+            };
+            if (channel_send((*cpu_task)->sockfd, &msg) < 0) {
+                perror("write");
+            }
+
+            stats_burst_done(*cpu_task, current_time_ms);
+
+            // Liberta o PCB e marca o CPU como livre
+            free_pcb(*cpu_task);
+            *cpu_task = NULL;
+        }
+    }
+
+    // 2) Tarefa pronta de maior prioridade efetiva (a primeira entre iguais)
+    queue_elem_t *best = NULL;
+    int32_t best_nice = 0;
+    for (queue_elem_t *it = rq->head; it != NULL; it = it->next) {
+        int32_t nice = locks_nice(it->pcb);
+        if (!best || nice < best_nice) {
+            best = it;
+            best_nice = nice;
+        }
+    }
+
+    // 3) Preempção: há uma tarefa mais importante, ou o slice terminou
+    //    e há outra com a mesma prioridade
+    if (*cpu_task) {
+        int expired = current_time_ms - (*cpu_task)->slice_start_ms >= PRIO_TIME_SLICE;
+        if (!best || best_nice > locks_nice(*cpu_task) ||
+            (best_nice == locks_nice(*cpu_task) && !expired)) {
+            if (expired) (*cpu_task)->slice_start_ms = current_time_ms;
+            return;
+        }
+        enqueue_pcb(rq, *cpu_task);
+        *cpu_task = NULL;
+    }
+
+    // 4) CPU livre → despacha a tarefa escolhida
+    if (best) {
+        queue_elem_t *removed = remove_queue_elem(rq, best);
+        if (removed) {
+            *cpu_task = removed->pcb;
+            (*cpu_task)->slice_start_ms = current_time_ms;
+            free_queue_elem(removed);
+        }
+    }
+}
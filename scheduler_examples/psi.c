@@ -0,0 +1,194 @@
+#include "psi.h"
+
+/**
+ * Load average e PSI calculados a partir das transições de estado
+ *
+ * Os estados de pressão (some/full de cada recurso) formam uma máscara; o
+ * tempo passado com cada máscara só é somado quando ela muda ou numa
+ * fronteira de amostragem. As constantes e os arredondamentos são os do
+ * kernel (calc_load() e psi_show()), para que os valores sejam comparáveis
+ * com /proc/loadavg e /proc/pressure.
+ */
+
+#define FSHIFT 11                  // bits da parte fracionária
+#define FIXED_1 (1 << FSHIFT)
+#define EXP_1 1884                 // 1/exp(5s/1min) em vírgula fixa
+#define EXP_5 2014                 // 1/exp(5s/5min)
+#define EXP_15 2037                // 1/exp(5s/15min)
+#define EXP_10s 1677               // 1/exp(2s/10s)
+#define EXP_60s 1981               // 1/exp(2s/60s)
+#define EXP_300s 2034              // 1/exp(2s/300s)
+
+#define PSI_STATES (2 * PSI_RESOURCES)   // some e full de cada recurso
+
+static const unsigned long LOAD_EXP[3] = {EXP_1, EXP_5, EXP_15};
+static const unsigned long PSI_EXP[3] = {EXP_10s, EXP_60s, EXP_300s};
+static const char *const PSI_NAMES[PSI_RESOURCES] = {"cpu", "io", "memory"};
+
+static uint32_t nr_running = 0;    // prontas + no CPU
+static uint32_t nr_oncpu = 0;
+static uint32_t nr_iowait = 0;
+static uint32_t nr_memstall = 0;
+
+static uint32_t clock_ms = 0;
+static uint32_t state_mask = 0;    // bit res*2 + full
+static uint32_t state_start_ms = 0;
+static uint64_t total_ms[PSI_STATES];
+static uint64_t period_start_total[PSI_STATES];
+static unsigned long avgs[PSI_STATES][3];
+static uint32_t next_avg_ms = PSI_FREQ_MS;
+
+static unsigned long loadavg[3];
+static uint32_t next_load_ms = LOAD_FREQ_MS;
+
+static FILE *log_file = NULL;
+
+static unsigned long calc_load(unsigned long load, unsigned long exp, unsigned long active) {
+    unsigned long newload = load * exp + active * (FIXED_1 - exp);
+    if (active >= load) newload += FIXED_1 - 1;
+    return newload / FIXED_1;
+}
+
+static uint32_t compute_mask(void) {
+    uint32_t m = 0;
+    if (nr_running > nr_oncpu) m |= 1u << (PSI_CPU * 2);
+    if (nr_running > 0 && nr_oncpu == 0) m |= 1u << (PSI_CPU * 2 + 1);
+    if (nr_iowait > 0) m |= 1u << (PSI_IO * 2);
+    if (nr_iowait > 0 && nr_running == 0) m |= 1u << (PSI_IO * 2 + 1);
+    if (nr_memstall > 0) m |= 1u << (PSI_MEM * 2);
+    if (nr_memstall > 0 && nr_memstall >= nr_running) m |= 1u << (PSI_MEM * 2 + 1);
+    return m;
+}
+
+// Soma aos totais o tempo passado com a máscara atual até until_ms
+static void record(uint32_t until_ms) {
+    uint32_t d = until_ms - state_start_ms;
+    for (int s = 0; s < PSI_STATES; s++) {
+        if (state_mask & (1u << s)) total_ms[s] += d;
+    }
+    state_start_ms = until_ms;
+}
+
+static void state_changed(void) {
+    uint32_t m = compute_mask();
+    if (m == state_mask) return;
+    record(clock_ms);
+    state_mask = m;
+}
+
+static void counter_add(uint32_t *counter, int delta) {
+    if (delta < 0 && *counter < (uint32_t)-delta) {
+        *counter = 0;
+    } else {
+        *counter += delta;
+    }
+    state_changed();
+}
+
+void psi_running(int delta) {
+    counter_add(&nr_running, delta);
+}
+
+void psi_iowait(int delta) {
+    counter_add(&nr_iowait, delta);
+}
+
+void psi_memstall(int delta) {
+    counter_add(&nr_memstall, delta);
+}
+
+void psi_set_oncpu(uint32_t n) {
+    if (n == nr_oncpu) return;
+    nr_oncpu = n;
+    state_changed();
+}
+
+// Valor em vírgula fixa truncado a duas casas (LOAD_INT/LOAD_FRAC do kernel)
+static double fixed_to_double(unsigned long x) {
+    return (double)(x >> FSHIFT) + (double)(((x & (FIXED_1 - 1)) * 100) >> FSHIFT) / 100.0;
+}
+
+static void log_sample(uint32_t now_ms) {
+    double load[3];
+    psi_loadavg(load);
+    fprintf(log_file, "%u,%.2f,%.2f,%.2f", now_ms, load[0], load[1], load[2]);
+    for (int s = 0; s < PSI_STATES; s++) {
+        fprintf(log_file, ",%.2f", fixed_to_double(avgs[s][0]));
+    }
+    fputc('\n', log_file);
+}
+
+// Fecha um período de PSI_FREQ_MS: a fração parada entra nas médias
+static void update_avgs(void) {
+    for (int s = 0; s < PSI_STATES; s++) {
+        uint64_t stalled = total_ms[s] - period_start_total[s];
+        period_start_total[s] = total_ms[s];
+        unsigned long pct = (unsigned long)(stalled * 100 / PSI_FREQ_MS) * FIXED_1;
+        for (int w = 0; w < 3; w++) avgs[s][w] = calc_load(avgs[s][w], PSI_EXP[w], pct);
+    }
+}
+
+void psi_advance(uint32_t now_ms) {
+    // As amostras do load average não dependem do tempo dentro do período
+    while (next_load_ms <= now_ms) {
+        unsigned long active = (unsigned long)(nr_running + nr_iowait) * FIXED_1;
+        for (int w = 0; w < 3; w++) loadavg[w] = calc_load(loadavg[w], LOAD_EXP[w], active);
+        next_load_ms += LOAD_FREQ_MS;
+    }
+    while (next_avg_ms <= now_ms) {
+        record(next_avg_ms);
+        update_avgs();
+        if (log_file) log_sample(next_avg_ms);
+        next_avg_ms += PSI_FREQ_MS;
+    }
+    clock_ms = now_ms;
+}
+
+void psi_loadavg(double avg[3]) {
+    // /proc/loadavg arredonda à centésima
+    for (int w = 0; w < 3; w++) avg[w] = fixed_to_double(loadavg[w] + FIXED_1 / 200);
+}
+
+void psi_pressure(psi_res_en res, int full, double avg[3], uint64_t *total_us) {
+    int s = res * 2 + (full ? 1 : 0);
+    for (int w = 0; w < 3; w++) avg[w] = fixed_to_double(avgs[s][w]);
+    // Inclui o intervalo ainda aberto
+    uint64_t t = total_ms[s];
+    if (state_mask & (1u << s)) t += clock_ms - state_start_ms;
+    *total_us = t * 1000;
+}
+
+int psi_open_log(const char *path) {
+    log_file = fopen(path, "w");
+    if (!log_file) return -1;
+    fprintf(log_file, "time_ms,load1,load5,load15");
+    for (int r = 0; r < PSI_RESOURCES; r++) {
+        fprintf(log_file, ",%s_some_avg10,%s_full_avg10", PSI_NAMES[r], PSI_NAMES[r]);
+    }
+    fputc('\n', log_file);
+    return 0;
+}
+
+void psi_close_log(void) {
+    if (log_file) fclose(log_file);
+    log_file = NULL;
+}
+
+void psi_print(FILE *out) {
+    double load[3];
+    psi_loadavg(load);
+    fprintf(out, "Load average:         %.2f %.2f %.2f (%u running, %u in I/O)\n",
+            load[0], load[1], load[2], nr_running, nr_iowait);
+    for (int r = 0; r < PSI_RESOURCES; r++) {
+        for (int full = 0; full <= 1; full++) {
+            double avg[3];
+            uint64_t total_us;
+            psi_pressure((psi_res_en)r, full, avg, &total_us);
+            char label[24];
+            snprintf(label, sizeof(label), "Pressure %s:", PSI_NAMES[r]);
+            fprintf(out, "%-22s%s avg10=%.2f avg60=%.2f avg300=%.2f total=%llu\n",
+                    full ? "" : label, full ? "full" : "some",
+                    avg[0], avg[1], avg[2], (unsigned long long)total_us);
+        }
+    }
+}
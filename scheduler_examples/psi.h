@@ -0,0 +1,96 @@
+#ifndef PSI_H
+#define PSI_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Load average e Pressure Stall Information (PSI), como no Linux.
+ *
+ * O módulo só conhece contadores de tarefas, atualizados nas transições de
+ * estado (ver stats.c): executáveis (prontas + no CPU), no CPU, bloqueadas
+ * em I/O e paradas à espera de memória. Cada alteração que muda os estados
+ * de pressão fecha o intervalo anterior e soma-o aos tempos totais, sem
+ * percorrer filas nem CPUs.
+ *
+ * Load average: a cada LOAD_FREQ_MS, load = load·e + n·(1 − e) em vírgula
+ * fixa (11 bits), com n = executáveis + bloqueadas em I/O e os fatores
+ * de 1, 5 e 15 minutos do kernel.
+ *
+ * PSI: para cada recurso, "some" é o tempo com pelo menos uma tarefa parada
+ * nesse recurso e "full" o tempo em que nenhuma tarefa avança:
+ *   cpu:    some = executáveis > no CPU;   full = executáveis > 0 e nenhuma no CPU
+ *   io:     some = bloqueadas > 0;         full = bloqueadas > 0 e nenhuma executável
+ *   memory: some = paradas > 0;            full = todas as executáveis paradas
+ * A cada PSI_FREQ_MS a fração de tempo parado do período entra nas médias
+ * avg10/avg60/avg300 com o mesmo decaimento exponencial do kernel.
+ *
+ * O simulador tem uma única fila de prontos, por isso a máquina inteira é
+ * tratada como um só grupo (o Linux agrega por CPU e omite cpu full ao
+ * nível do sistema).
+ */
+
+#define LOAD_FREQ_MS 5000            // amostragem do load average
+#define PSI_FREQ_MS 2000             // atualização das médias de pressão
+
+typedef enum {
+    PSI_CPU = 0,
+    PSI_IO,
+    PSI_MEM,
+    PSI_RESOURCES
+} psi_res_en;
+
+/**
+ * @brief Variação do número de tarefas executáveis (prontas + no CPU)
+ */
+void psi_running(int delta);
+
+/**
+ * @brief Variação do número de tarefas bloqueadas em I/O
+ */
+void psi_iowait(int delta);
+
+/**
+ * @brief Variação do número de tarefas paradas à espera de memória
+ *
+ * Para modelos de memória; sem nenhum, a pressão de memória fica a zero.
+ */
+void psi_memstall(int delta);
+
+/**
+ * @brief Número de tarefas que ocuparam CPUs no tick que começa agora
+ */
+void psi_set_oncpu(uint32_t n);
+
+/**
+ * @brief Avança o relógio para now_ms, fazendo as amostragens que passaram
+ */
+void psi_advance(uint32_t now_ms);
+
+/**
+ * @brief Load average de 1, 5 e 15 minutos
+ */
+void psi_loadavg(double avg[3]);
+
+/**
+ * @brief Pressão de um recurso: médias de 10, 60 e 300 s (%) e total em µs
+ */
+void psi_pressure(psi_res_en res, int full, double avg[3], uint64_t *total_us);
+
+/**
+ * @brief Escreve uma linha CSV com o load average e a pressão a cada PSI_FREQ_MS
+ * @return 0 em caso de sucesso, -1 se o ficheiro não abrir
+ */
+int psi_open_log(const char *path);
+
+/**
+ * @brief Fecha o ficheiro aberto por psi_open_log()
+ */
+void psi_close_log(void);
+
+/**
+ * @brief Imprime o load average e a pressão no formato de /proc
+ */
+void psi_print(FILE *out);
+
+#endif //PSI_H
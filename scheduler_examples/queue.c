@@ -3,23 +3,71 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+// PCBs and queue elements are recycled through free lists, so the tick path
+// only calls malloc while the pools are still growing (see queue_pool_release)
+typedef union pcb_slot_un {
+    pcb_t pcb;
+    union pcb_slot_un *next;
+} pcb_slot_t;
+
+static pcb_slot_t *free_pcbs = NULL;
+static queue_elem_t *free_elems = NULL;
+
 pcb_t *new_pcb(pid_t pid, uint32_t sockfd, uint32_t time_ms) {
-    pcb_t * new_task = malloc(sizeof(pcb_t));
-    if (!new_task) return NULL;
+    pcb_t *new_task;
+    if (free_pcbs) {
+        new_task = &free_pcbs->pcb;
+        free_pcbs = free_pcbs->next;
+    } else {
+        pcb_slot_t *slot = malloc(sizeof(pcb_slot_t));
+        if (!slot) return NULL;
+        new_task = &slot->pcb;
+    }
 
     new_task->pid = pid;
+    new_task->tid = 0;
     new_task->status = TASK_COMMAND;
     new_task->slice_start_ms = 0;
     new_task->priority_level = 0;   // <-- NOVO: começa no nível mais alto do MLFQ
     new_task->sockfd = sockfd;
     new_task->time_ms = time_ms;
+    new_task->requested_ms = time_ms;
     new_task->ellapsed_time_ms = 0;
+    new_task->last_update_time_ms = 0;
+    new_task->arrival_time_ms = 0;
+    new_task->start_time_ms = PCB_NOT_STARTED;
+    new_task->cpus = 1;
+    new_task->estimate_ms = time_ms;
+    new_task->nice = 0;
+    new_task->deadline_ms = 0;
+    new_task->periodic = -1;
+    new_task->reservation = -1;
+    new_task->sched_class = 0;
+    new_task->vruntime = 0;
+    new_task->mem_intensity = 0;
+    new_task->mem_debt_us = 0;
     return new_task;
 }
 
+void free_pcb(pcb_t *task) {
+    if (!task) return;
+    pcb_slot_t *slot = (pcb_slot_t *)task;
+    slot->next = free_pcbs;
+    free_pcbs = slot;
+}
+
+void stall_pcb(pcb_t *task, uint32_t ms) {
+    task->time_ms += ms;
+}
+
 int enqueue_pcb(queue_t* q, pcb_t* task) {
-    queue_elem_t* elem = malloc(sizeof(queue_elem_t));
-    if (!elem) return 0;
+    queue_elem_t* elem = free_elems;
+    if (elem) {
+        free_elems = elem->next;
+    } else {
+        elem = malloc(sizeof(queue_elem_t));
+        if (!elem) return 0;
+    }
 
     elem->pcb = task;
     elem->next = NULL;
@@ -43,10 +91,36 @@ pcb_t* dequeue_pcb(queue_t* q) {
     if (!q->head)
         q->tail = NULL;
 
-    free(node);
+    free_queue_elem(node);
     return task;
 }
 
+void enqueue_batch(queue_t *q, queue_t *batch) {
+    if (!batch->head) return;
+    if (q->tail) {
+        q->tail->next = batch->head;
+    } else {
+        q->head = batch->head;
+    }
+    q->tail = batch->tail;
+    batch->head = NULL;
+    batch->tail = NULL;
+}
+
+void move_queue_head(queue_t *dst, queue_t *src) {
+    queue_elem_t *elem = src->head;
+    if (!elem) return;
+    src->head = elem->next;
+    if (!src->head) src->tail = NULL;
+    elem->next = NULL;
+    if (dst->tail) {
+        dst->tail->next = elem;
+    } else {
+        dst->head = elem;
+    }
+    dst->tail = elem;
+}
+
 queue_elem_t *remove_queue_elem(queue_t* q, queue_elem_t* elem) {
     queue_elem_t* it = q->head;
     queue_elem_t* prev = NULL;
@@ -68,4 +142,23 @@ queue_elem_t *remove_queue_elem(queue_t* q, queue_elem_t* elem) {
     }
     printf("Queue element not found in queue\n");
     return NULL;
-}
\ No newline at end of file
+}
+
+void free_queue_elem(queue_elem_t *elem) {
+    if (!elem) return;
+    elem->next = free_elems;
+    free_elems = elem;
+}
+
+void queue_pool_release(void) {
+    while (free_pcbs) {
+        pcb_slot_t *next = free_pcbs->next;
+        free(free_pcbs);
+        free_pcbs = next;
+    }
+    while (free_elems) {
+        queue_elem_t *next = free_elems->next;
+        free(free_elems);
+        free_elems = next;
+    }
+}
@@ -2,6 +2,9 @@
 #define QUEUE_H
 #include <stdint.h>
 
+// Value of start_time_ms while the task has not been dispatched yet
+#define PCB_NOT_STARTED UINT32_MAX
+
 typedef enum  {
     TASK_COMMAND = 0,   // Task has connected and is waiting for instructions
     TASK_BLOCKED,       // Task is blocked (waiting/IO wait)
@@ -13,12 +16,26 @@ typedef enum  {
 // Define the Process Control Block (PCB) structure
 typedef struct pcb_st{
     int32_t pid;                   // Process ID
+    uint32_t tid;                  // Thread ID (several threads of one pid can be runnable)
     task_status_en status;         // Current status of the task defined by the pcb
-    uint32_t time_ms;              // Time requested by application in milliseconds
+    uint32_t time_ms;              // Time the burst takes on the CPU (requested + stalls, see stall_pcb)
+    uint32_t requested_ms;         // Time requested by application in milliseconds
     uint32_t ellapsed_time_ms;     // Time ellapsed since start in milliseconds
     uint32_t slice_start_ms;       // Time when the current time slice started
     uint32_t sockfd;               // Socket file descriptor for communication with the application
     uint32_t last_update_time_ms;  // Last time the PCB was updataed
+    uint32_t arrival_time_ms;      // Time when the request was received by the simulator
+    uint32_t start_time_ms;        // Time of the first dispatch (PCB_NOT_STARTED before that)
+    uint32_t cpus;                 // CPUs needed at the same time (batch jobs, >= 1)
+    uint32_t estimate_ms;          // Declared walltime used for backfilling (batch jobs)
+    int32_t nice;                  // Static priority (lower is more important, see PRIO)
+    uint32_t deadline_ms;          // Absolute deadline (periodic jobs, 0 = none)
+    int32_t periodic;              // Periodic task that released this job (-1 = none)
+    int32_t reservation;           // CBS reservation serving this burst (-1 = none)
+    uint32_t sched_class;          // Scheduling class (sched_class_en, see classes.h)
+    uint64_t vruntime;             // Weighted CPU time of the fair class, in us
+    uint32_t mem_intensity;        // Share of a socket's memory bandwidth used alone (see membw.h)
+    uint32_t mem_debt_us;          // Progress lost to bandwidth contention, not yet charged
     uint8_t  priority_level;     // <-- NOVO: nível de prioridade para MLFQ (0..NUM_QUEUES-1)
 } pcb_t;
 
@@ -39,7 +56,8 @@ typedef struct queue_st  {
 /**
  * @brief Create a new pcb (process control block)
  *
- * This function allocates memory for a new pcb and initializes its fields.
+ * This function takes a pcb from the pool (allocating one only when the pool
+ * is empty) and initializes its fields. Release it with free_pcb().
  *
  * @param pid The process ID of the task
  * @param sockfd The socket file descriptor for communication with the application
@@ -48,6 +66,22 @@ typedef struct queue_st  {
  */
 pcb_t *new_pcb(int32_t pid, uint32_t sockfd, uint32_t time_ms);
 
+/**
+ * @brief Return a pcb to the pool (NULL is ignored)
+ *
+ * Every pcb created by new_pcb() must be released with this function, never
+ * with free(), so that the steady state of the simulator does not allocate.
+ */
+void free_pcb(pcb_t *task);
+
+/**
+ * @brief Withhold ms of progress from a task that is using a CPU
+ *
+ * The burst ends ms later than it would, but requested_ms is kept, so the
+ * stall shows up as slowdown and not as CPU time asked for by the task.
+ */
+void stall_pcb(pcb_t *task, uint32_t ms);
+
 /**
  * @brief Enqueue a pcb into the queue
  *
@@ -69,11 +103,32 @@ int enqueue_pcb(queue_t* q, pcb_t* task);
  */
 pcb_t* dequeue_pcb(queue_t* q);
 
+/**
+ * @brief Append a whole queue to the end of another one
+ *
+ * The elements of batch are linked after the tail of q in O(1), keeping
+ * their order, without taking elements from the pool; batch is left empty.
+ * This is the bulk insert of the policies whose ready queue is a FIFO list.
+ *
+ * @param q The queue that receives the elements
+ * @param batch The queue whose elements are moved (left empty)
+ */
+void enqueue_batch(queue_t *q, queue_t *batch);
+
+/**
+ * @brief Move the element at the front of src to the end of dst
+ *
+ * The element is relinked, not copied, so the pool is not used. Does
+ * nothing if src is empty.
+ */
+void move_queue_head(queue_t *dst, queue_t *src);
+
 /**
  * @brief Remove a specific element from the queue
  *
  * This function removes a specific element from the queue.
- * Neither the element, nor the pcb inside the element, are freed.
+ * Neither the element, nor the pcb inside the element, are freed
+ * (use free_queue_elem() and free_pcb()).
  *
  * @param q The queue from which the element will be removed
  * @param elem The element to be removed from the queue
@@ -81,5 +136,15 @@ pcb_t* dequeue_pcb(queue_t* q);
  */
 queue_elem_t *remove_queue_elem(queue_t* q, queue_elem_t* elem);
 
+/**
+ * @brief Return a queue element to the pool (NULL is ignored)
+ */
+void free_queue_elem(queue_elem_t *elem);
+
+/**
+ * @brief Free the pcbs and queue elements kept in the pools (call on exit)
+ */
+void queue_pool_release(void);
+
 
 #endif //QUEUE_H
@@ -1,8 +1,9 @@
 #include "queue.h"
 #include "msg.h"
+#include "stats.h"
+#include "channel.h"
 #include <stdlib.h>
 #include <stdio.h>    // para perror
-#include <unistd.h>   // para write()
 
 #define TIME_SLICE 500 // quantum fixo de 500 ms para cada processo
 
@@ -31,15 +32,18 @@ void rr_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_task) {
             // Envia mensagem DONE para a aplicação correspondente
             msg_t msg = {
                 .pid = (*cpu_task)->pid,
+                .tid = (*cpu_task)->tid,
                 .request = PROCESS_REQUEST_DONE,
                 .time_ms = current_time_ms
             };
-            if (write((*cpu_task)->sockfd, &msg, sizeof msg) != sizeof msg) {
+            if (channel_send((*cpu_task)->sockfd, &msg) < 0) {
                 perror("write");
             }
 
+            stats_burst_done(*cpu_task, current_time_ms);
+
             // Liberta a memória do PCB e marca o CPU como livre
-            free(*cpu_task);
+            free_pcb(*cpu_task);
             *cpu_task = NULL;
         }
         // 1.b) Caso ainda não tenha terminado, verifica se o slice expirou
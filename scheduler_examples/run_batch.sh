@@ -0,0 +1,17 @@
+#!/bin/bash
+# Batch workload for the BATCH scheduler, e.g. ./scheduler BATCH --cpus 4
+# Each job: ./app <name> <time_s> <cpus> <estimate_s>
+# J2 needs the whole machine; J3..J6 are small jobs that can be backfilled
+# while J2 waits, as long as they do not delay its reservation.
+./app J1 6 2 8 &
+sleep 0.1
+./app J2 4 4 5 &
+sleep 0.1
+./app J3 3 1 4 &
+sleep 0.1
+./app J4 8 2 10 &
+sleep 0.1
+./app J5 2 1 2 &
+sleep 0.1
+./app J6 5 1 6 &
+wait
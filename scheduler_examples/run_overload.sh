@@ -0,0 +1,9 @@
+#!/bin/bash
+# Overload scenario for the admission control (--admit-hwm).
+# Starts N short applications at once (default 40 x 1 s of CPU),
+# far more than the scheduler can serve, and waits for all of them.
+N=${1:-40}
+for i in $(seq 1 "$N"); do
+    ./app "L$i" 1 &
+done
+wait
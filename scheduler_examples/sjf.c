@@ -1,5 +1,7 @@
 #include "queue.h"
 #include "msg.h"
+#include "stats.h"
+#include "channel.h"
 #include <stdlib.h>
 #include <unistd.h>
 #include <stdio.h>
@@ -25,15 +27,18 @@ void sjf_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_task) {
             // Envia mensagem DONE para a aplicação correspondente
             msg_t msg = {
                 .pid = (*cpu_task)->pid,
+                .tid = (*cpu_task)->tid,
                 .request = PROCESS_REQUEST_DONE,
                 .time_ms = current_time_ms
             };
-            if (write((*cpu_task)->sockfd, &msg, sizeof msg) != sizeof msg) {
+            if (channel_send((*cpu_task)->sockfd, &msg) < 0) {
                 perror("write");
             }
 
+            stats_burst_done(*cpu_task, current_time_ms);
+
             // Liberta o PCB e marca o CPU como livre
-            free(*cpu_task);
+            free_pcb(*cpu_task);
             *cpu_task = NULL;
         }
     }
@@ -63,7 +68,7 @@ void sjf_scheduler(uint32_t current_time_ms, queue_t *rq, pcb_t **cpu_task) {
         queue_elem_t *removed = remove_queue_elem(rq, min_elem);
         if (removed) {
             *cpu_task = removed->pcb;
-            free(removed);
+            free_queue_elem(removed);
             first_dispatch_done = 1; // indica que o primeiro despacho foi feito
         }
     }
@@ -0,0 +1,255 @@
+#include "stats.h"
+#include "msg.h"
+#include "trace.h"
+#include "periodic.h"
+#include "cbs.h"
+#include "psi.h"
+#include "hv.h"
+#include "adaptive.h"
+#include "delay.h"
+
+#include <stdlib.h>
+
+// Contadores globais (um único simulador por processo)
+static uint32_t runnable = 0;          // tarefas prontas + em execução
+static uint32_t max_runnable = 0;      // pico de tarefas executáveis
+
+static uint64_t bursts_done = 0;       // bursts de CPU terminados
+static uint64_t latency_sum_ms = 0;    // soma das latências (pedido -> DONE)
+static uint32_t latency_max_ms = 0;
+
+static uint64_t wait_sum_ms = 0;       // espera até ao primeiro despacho
+static uint32_t wait_max_ms = 0;
+static double bsld_sum = 0.0;          // bounded slowdown
+static double bsld_max = 0.0;
+
+static uint64_t cpu_busy_ms = 0;       // tempo de CPU ocupado (somado em todos os CPUs)
+static uint64_t cpu_total_ms = 0;      // tempo de CPU disponível
+static uint64_t cpu_frag_ms = 0;       // CPU livre com tarefas à espera
+static uint64_t cpu_spin_ms = 0;       // CPU gasto à espera de outras threads
+
+static uint32_t latency_slo_ms = 0;    // SLO de latência (0 = sem SLO)
+static uint64_t slo_violations = 0;
+
+static uint64_t admission_waits = 0;   // pedidos que ficaram retidos na admissão
+static uint64_t admission_sum_ms = 0;
+static uint32_t admission_max_ms = 0;
+
+// Contabilidade por processo (soma das threads), indexada pelo PID
+typedef struct {
+    int32_t pid;
+    int used;
+    uint64_t tids;             // máscara das threads vistas (tid 0..63)
+    uint32_t runnable;         // threads prontas + em execução
+    uint32_t bursts;
+    uint64_t cpu_ms;
+    uint64_t io_ms;
+    uint32_t first_ms;         // chegada do primeiro pedido
+    uint32_t last_ms;          // último DONE
+} proc_stats_t;
+
+static proc_stats_t *procs = NULL;      // tabela de dispersão (endereçamento aberto)
+static uint32_t procs_cap = 0;
+static uint32_t procs_used = 0;
+
+static proc_stats_t *proc_slot(proc_stats_t *table, uint32_t cap, int32_t pid) {
+    uint32_t i = ((uint32_t)pid * 2654435761u) & (cap - 1);
+    while (table[i].used && table[i].pid != pid) i = (i + 1) & (cap - 1);
+    return &table[i];
+}
+
+static proc_stats_t *proc_find(int32_t pid) {
+    if (procs_cap == 0) return NULL;
+    proc_stats_t *ps = proc_slot(procs, procs_cap, pid);
+    return ps->used ? ps : NULL;
+}
+
+static proc_stats_t *proc_lookup(int32_t pid, uint32_t now_ms) {
+    if ((procs_used + 1) * 10 > procs_cap * 7) {
+        // Duplica a tabela quando passa 70% de ocupação
+        uint32_t cap = procs_cap ? procs_cap * 2 : 64;
+        proc_stats_t *table = calloc(cap, sizeof(proc_stats_t));
+        if (!table) return NULL;
+        for (uint32_t i = 0; i < procs_cap; i++) {
+            if (procs[i].used) *proc_slot(table, cap, procs[i].pid) = procs[i];
+        }
+        free(procs);
+        procs = table;
+        procs_cap = cap;
+    }
+    proc_stats_t *ps = proc_slot(procs, procs_cap, pid);
+    if (!ps->used) {
+        ps->used = 1;
+        ps->pid = pid;
+        ps->first_ms = now_ms;
+        procs_used++;
+    }
+    return ps;
+}
+
+static void proc_account(const pcb_t *task, uint32_t now_ms, int io) {
+    proc_stats_t *ps = proc_lookup(task->pid, task->arrival_time_ms);
+    if (!ps) return;
+    if (task->tid < 64) ps->tids |= 1ull << task->tid;
+    if (task->arrival_time_ms < ps->first_ms) ps->first_ms = task->arrival_time_ms;
+    if (now_ms > ps->last_ms) ps->last_ms = now_ms;
+    if (io) {
+        ps->io_ms += task->time_ms;
+    } else {
+        if (ps->runnable > 0) ps->runnable--;
+        ps->bursts++;
+        ps->cpu_ms += task->requested_ms;
+    }
+}
+
+void stats_task_admitted(const pcb_t *task) {
+    runnable++;
+    if (runnable > max_runnable) max_runnable = runnable;
+    psi_running(1);
+    proc_stats_t *ps = proc_lookup(task->pid, task->arrival_time_ms);
+    if (ps) ps->runnable++;
+    delay_task_admitted(task);
+}
+
+void stats_burst_done(const pcb_t *task, uint32_t now_ms) {
+    if (runnable > 0) runnable--;
+    psi_running(-1);
+
+    uint32_t latency = now_ms - task->arrival_time_ms;
+    bursts_done++;
+    latency_sum_ms += latency;
+    if (latency > latency_max_ms) latency_max_ms = latency;
+    if (latency_slo_ms > 0 && latency > latency_slo_ms) slo_violations++;
+
+    uint32_t start = task->start_time_ms != PCB_NOT_STARTED ? task->start_time_ms : now_ms;
+    uint32_t wait = start - task->arrival_time_ms;
+    wait_sum_ms += wait;
+    if (wait > wait_max_ms) wait_max_ms = wait;
+
+    uint32_t run = task->requested_ms > STATS_BSLD_TAU_MS ? task->requested_ms : STATS_BSLD_TAU_MS;
+    double bsld = (double)latency / run;
+    if (bsld < 1.0) bsld = 1.0;
+    bsld_sum += bsld;
+    if (bsld > bsld_max) bsld_max = bsld;
+
+    proc_account(task, now_ms, 0);
+    if (task->periodic >= 0) periodic_job_done(task, now_ms);
+    if (task->reservation >= 0) cbs_job_done(task, now_ms);
+    if (hv_active()) hv_burst_done(task, now_ms);
+    adaptive_burst_done(task, now_ms);
+    delay_burst_done(task);
+    trace_event(TRACE_DONE, now_ms, task, 0, task->requested_ms);
+}
+
+void stats_io_started(void) {
+    psi_iowait(1);
+}
+
+void stats_io_done(const pcb_t *task, uint32_t now_ms) {
+    psi_iowait(-1);
+    proc_account(task, now_ms, 1);
+}
+
+void stats_cpu_tick(uint32_t now_ms, int busy, uint32_t running, int ncpus,
+                    int fragmented, int spinning) {
+    // As tarefas no CPU ficam lá até ao tick seguinte
+    psi_set_oncpu(running);
+    psi_advance(now_ms + TICKS_MS);
+    cpu_busy_ms += (uint64_t)busy * TICKS_MS;
+    cpu_total_ms += (uint64_t)ncpus * TICKS_MS;
+    cpu_frag_ms += (uint64_t)fragmented * TICKS_MS;
+    cpu_spin_ms += (uint64_t)spinning * TICKS_MS;
+}
+
+void stats_admission_wait(uint32_t wait_ms) {
+    admission_waits++;
+    admission_sum_ms += wait_ms;
+    if (wait_ms > admission_max_ms) admission_max_ms = wait_ms;
+}
+
+void stats_set_latency_slo(uint32_t slo_ms) {
+    latency_slo_ms = slo_ms;
+}
+
+uint32_t stats_runnable(void) {
+    return runnable;
+}
+
+uint64_t stats_bursts_done(void) {
+    return bursts_done;
+}
+
+uint64_t stats_cpu_busy_ms(void) {
+    return cpu_busy_ms;
+}
+
+uint32_t stats_proc_runnable(int32_t pid) {
+    proc_stats_t *ps = proc_find(pid);
+    return ps ? ps->runnable : 0;
+}
+
+void stats_print(FILE *out, uint32_t now_ms) {
+    double secs = now_ms / 1000.0;
+    fprintf(out, "---- Simulation statistics (%.2f s) ----\n", secs);
+    fprintf(out, "Bursts completed:     %llu\n", (unsigned long long)bursts_done);
+    fprintf(out, "Throughput:           %.2f bursts/s\n", secs > 0 ? bursts_done / secs : 0.0);
+    fprintf(out, "Latency (RUN->DONE):  mean %.1f ms, max %u ms\n",
+            bursts_done ? (double)latency_sum_ms / bursts_done : 0.0, latency_max_ms);
+    if (latency_slo_ms > 0) {
+        fprintf(out, "Latency SLO:          %llu of %llu bursts over %u ms (%.2f %%)\n",
+                (unsigned long long)slo_violations, (unsigned long long)bursts_done, latency_slo_ms,
+                bursts_done ? 100.0 * slo_violations / bursts_done : 0.0);
+    }
+    fprintf(out, "Wait (RUN->dispatch): mean %.1f ms, max %u ms\n",
+            bursts_done ? (double)wait_sum_ms / bursts_done : 0.0, wait_max_ms);
+    fprintf(out, "Bounded slowdown:     mean %.2f, max %.2f\n",
+            bursts_done ? bsld_sum / bursts_done : 0.0, bsld_max);
+    fprintf(out, "CPU utilization:      %.1f %%\n",
+            cpu_total_ms ? 100.0 * cpu_busy_ms / cpu_total_ms : 0.0);
+    fprintf(out, "CPU fragmentation:    %.1f %% (idle while tasks were waiting)\n",
+            cpu_total_ms ? 100.0 * cpu_frag_ms / cpu_total_ms : 0.0);
+    if (cpu_spin_ms > 0) {
+        fprintf(out, "Sync spinning:        %.1f %% of busy CPU time\n",
+                cpu_busy_ms ? 100.0 * cpu_spin_ms / cpu_busy_ms : 0.0);
+    }
+    fprintf(out, "Runnable tasks:       now %u, peak %u\n", runnable, max_runnable);
+    fprintf(out, "Deferred admissions:  %llu (mean wait %.1f ms, max %u ms)\n",
+            (unsigned long long)admission_waits,
+            admission_waits ? (double)admission_sum_ms / admission_waits : 0.0,
+            admission_max_ms);
+    psi_print(out);
+    fflush(out);
+}
+
+static int by_pid(const void *a, const void *b) {
+    const proc_stats_t *pa = a, *pb = b;
+    return (pa->pid > pb->pid) - (pa->pid < pb->pid);
+}
+
+void stats_print_processes(FILE *out) {
+    // Compacta as entradas usadas e ordena por PID
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < procs_cap; i++) {
+        if (procs[i].used) procs[n++] = procs[i];
+    }
+    qsort(procs, n, sizeof(proc_stats_t), by_pid);
+
+    fprintf(out, "---- Per-process accounting (%u processes) ----\n", n);
+    fprintf(out, "%8s %7s %7s %10s %10s %10s %11s\n",
+            "pid", "threads", "bursts", "cpu(ms)", "io(ms)", "life(ms)", "parallelism");
+    for (uint32_t i = 0; i < n; i++) {
+        proc_stats_t *ps = &procs[i];
+        uint32_t life = ps->last_ms - ps->first_ms;
+        fprintf(out, "%8d %7d %7u %10llu %10llu %10u %11.2f\n",
+                ps->pid, __builtin_popcountll(ps->tids), ps->bursts,
+                (unsigned long long)ps->cpu_ms, (unsigned long long)ps->io_ms, life,
+                life ? (double)ps->cpu_ms / life : 0.0);
+    }
+    fflush(out);
+
+    // A tabela deixou de estar organizada por dispersão
+    free(procs);
+    procs = NULL;
+    procs_cap = 0;
+    procs_used = 0;
+}
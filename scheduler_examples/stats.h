@@ -0,0 +1,102 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "queue.h"
+
+#define STATS_BSLD_TAU_MS 10000    // limiar do bounded slowdown (10 s)
+
+/*
+ * Métricas globais do simulador.
+ *
+ * Os escalonadores chamam stats_burst_done() quando enviam DONE, antes de
+ * libertarem o PCB, e o ossim.c regista as entradas na ready queue.
+ * stats_burst_done() também regista o fim do burst no trace (ver trace.h).
+ * Com isto mantém-se, sem percorrer filas, o número de tarefas executáveis
+ * (prontas + em execução) e a latência de cada pedido RUN. As mesmas
+ * transições alimentam o load average e a pressão (PSI) de psi.h.
+ */
+
+/**
+ * @brief Regista a entrada de um pedido RUN no conjunto de tarefas executáveis
+ */
+void stats_task_admitted(const pcb_t *task);
+
+/**
+ * @brief Regista o fim de um burst de CPU (chamar antes de libertar o PCB)
+ *
+ * A latência é medida desde a receção do pedido (arrival_time_ms), pelo que
+ * inclui o tempo passado na fila de admissão. A espera vai até ao primeiro
+ * despacho (start_time_ms) e o bounded slowdown usa um limiar de
+ * STATS_BSLD_TAU_MS para não penalizar demasiado os bursts muito curtos.
+ */
+void stats_burst_done(const pcb_t *task, uint32_t now_ms);
+
+/**
+ * @brief Regista o início de um pedido BLOCK (a tarefa fica em I/O)
+ */
+void stats_io_started(void);
+
+/**
+ * @brief Regista o fim de um pedido BLOCK (I/O) de um processo/thread
+ */
+void stats_io_done(const pcb_t *task, uint32_t now_ms);
+
+/**
+ * @brief Regista a ocupação dos CPUs no tick que começa em now_ms
+ *
+ * busy: CPUs ocupados (de ncpus); running: tarefas distintas nesses CPUs
+ * (um job BATCH ocupa vários); fragmented: CPUs livres enquanto havia
+ * tarefas à espera na fila de prontos; spinning: CPUs ocupados por threads
+ * que não avançaram porque esperavam por outras threads do processo.
+ */
+void stats_cpu_tick(uint32_t now_ms, int busy, uint32_t running, int ncpus,
+                    int fragmented, int spinning);
+
+/**
+ * @brief Regista quanto tempo um pedido esperou na fila de admissão
+ */
+void stats_admission_wait(uint32_t wait_ms);
+
+/**
+ * @brief SLO de latência (RUN->DONE): conta os bursts que o excedem (0 = sem SLO)
+ */
+void stats_set_latency_slo(uint32_t slo_ms);
+
+/**
+ * @brief Número atual de tarefas executáveis (prontas + no CPU)
+ */
+uint32_t stats_runnable(void);
+
+/**
+ * @brief Bursts de CPU terminados até agora
+ */
+uint64_t stats_bursts_done(void);
+
+/**
+ * @brief Tempo de CPU ocupado até agora (somado em todos os CPUs), em ms
+ */
+uint64_t stats_cpu_busy_ms(void);
+
+/**
+ * @brief Número atual de threads executáveis do processo pid
+ */
+uint32_t stats_proc_runnable(int32_t pid);
+
+/**
+ * @brief Imprime o resumo das métricas até ao instante now_ms
+ */
+void stats_print(FILE *out, uint32_t now_ms);
+
+/**
+ * @brief Imprime a contabilidade por processo (soma de todas as threads)
+ *
+ * Para cada PID: threads vistas, bursts, tempo de CPU e de I/O pedidos,
+ * tempo de vida (primeiro pedido até ao último DONE) e paralelismo médio
+ * (CPU / tempo de vida), que indica o speedup obtido com várias threads.
+ * Só deve ser chamada no fim da simulação.
+ */
+void stats_print_processes(FILE *out);
+
+#endif //STATS_H
@@ -0,0 +1,202 @@
+#include "trace.h"
+#include "msg.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Estado de um CPU guardado antes dos escalonadores (o PCB pode ser libertado)
+typedef struct {
+    const pcb_t *task;
+    int32_t pid;
+    uint32_t tid;
+} cpu_slot_t;
+
+static FILE *trace_file = NULL;
+
+static cpu_slot_t before[MAX_CPUS];
+static cpu_slot_t done[MAX_CPUS];     // bursts terminados desde trace_cpus_begin()
+static int ndone = 0;
+
+int trace_open(const char *path, const char *policy, uint32_t ncpus, uint32_t critical_path_ms) {
+    trace_file = fopen(path, "wb");
+    if (!trace_file) {
+        perror("fopen(trace)");
+        return -1;
+    }
+    // Os registos são pequenos: um buffer grande evita uma escrita por evento
+    setvbuf(trace_file, NULL, _IOFBF, 1 << 16);
+
+    trace_header_t h = {0};
+    memcpy(h.magic, TRACE_MAGIC, sizeof(h.magic));
+    h.version = TRACE_VERSION;
+    h.ncpus = ncpus;
+    h.critical_path_ms = critical_path_ms;
+    strncpy(h.policy, policy, sizeof(h.policy) - 1);
+    if (fwrite(&h, sizeof(h), 1, trace_file) != 1) {
+        perror("fwrite(trace)");
+        fclose(trace_file);
+        trace_file = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+int trace_enabled(void) {
+    return trace_file != NULL;
+}
+
+static void trace_write(trace_type_en type, uint32_t now_ms, int32_t pid, uint32_t tid,
+                        uint32_t cpu, uint32_t arg, uint32_t arg2) {
+    trace_rec_t r = {
+        .time_ms = now_ms,
+        .pid = pid,
+        .tid = tid,
+        .type = (uint16_t)type,
+        .cpu = (uint16_t)cpu,
+        .arg = arg,
+        .arg2 = arg2
+    };
+    fwrite(&r, sizeof(r), 1, trace_file);
+}
+
+void trace_event(trace_type_en type, uint32_t now_ms, const pcb_t *task, uint32_t cpu, uint32_t arg) {
+    if (!trace_file) return;
+    if (type == TRACE_DONE && ndone < MAX_CPUS) {
+        done[ndone].pid = task->pid;
+        done[ndone].tid = task->tid;
+        ndone++;
+    }
+    trace_write(type, now_ms, task->pid, task->tid, cpu, arg,
+                type == TRACE_ARRIVE ? task->deadline_ms : 0);
+}
+
+void trace_cpus_begin(pcb_t *const *cpu_tasks, int ncpus) {
+    if (!trace_file) return;
+    for (int c = 0; c < ncpus; c++) {
+        before[c].task = cpu_tasks[c];
+        if (cpu_tasks[c]) {
+            before[c].pid = cpu_tasks[c]->pid;
+            before[c].tid = cpu_tasks[c]->tid;
+        }
+    }
+    ndone = 0;
+}
+
+static int finished(const cpu_slot_t *s) {
+    for (int i = 0; i < ndone; i++) {
+        if (done[i].pid == s->pid && done[i].tid == s->tid) return 1;
+    }
+    return 0;
+}
+
+void trace_cpus_end(uint32_t now_ms, pcb_t *const *cpu_tasks, int ncpus) {
+    if (!trace_file) return;
+    for (int c = 0; c < ncpus; c++) {
+        if (cpu_tasks[c] == before[c].task) continue;
+        if (before[c].task && !finished(&before[c])) {
+            trace_write(TRACE_PREEMPT, now_ms, before[c].pid, before[c].tid, (uint32_t)c, 0, 0);
+        }
+        if (cpu_tasks[c]) {
+            trace_write(TRACE_DISPATCH, now_ms, cpu_tasks[c]->pid, cpu_tasks[c]->tid, (uint32_t)c, 0, 0);
+        }
+    }
+}
+
+void trace_close(void) {
+    if (!trace_file) return;
+    fclose(trace_file);
+    trace_file = NULL;
+}
+
+// ---------------------------------------------------------
+// Leitura de traces
+// ---------------------------------------------------------
+
+int trace_header_check(trace_header_t *h) {
+    if (memcmp(h->magic, TRACE_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != TRACE_VERSION || h->ncpus == 0) {
+        return -1;
+    }
+    h->policy[sizeof(h->policy) - 1] = '\0';
+    return 0;
+}
+
+int trace_reader_open(trace_reader_t *r, const char *path) {
+    memset(r, 0, sizeof(*r));
+    r->f = fopen(path, "rb");
+    if (!r->f) {
+        perror(path);
+        return -1;
+    }
+    if (fread(&r->header, sizeof(r->header), 1, r->f) != 1 || trace_header_check(&r->header) < 0) {
+        fprintf(stderr, "%s: not an ossim trace (version %u, expected %d)\n",
+                path, r->header.version, TRACE_VERSION);
+        fclose(r->f);
+        return -1;
+    }
+    r->buf = malloc(TRACE_READ_BATCH * sizeof(trace_rec_t));
+    if (!r->buf) {
+        fclose(r->f);
+        return -1;
+    }
+    return 0;
+}
+
+const trace_rec_t *trace_reader_peek(trace_reader_t *r) {
+    if (r->pos == r->n) {
+        r->n = fread(r->buf, sizeof(trace_rec_t), TRACE_READ_BATCH, r->f);
+        r->pos = 0;
+        if (r->n == 0) return NULL;
+    }
+    return &r->buf[r->pos];
+}
+
+const trace_rec_t *trace_reader_next(trace_reader_t *r) {
+    const trace_rec_t *rec = trace_reader_peek(r);
+    if (rec) r->pos++;
+    return rec;
+}
+
+void trace_reader_close(trace_reader_t *r) {
+    if (r->f) fclose(r->f);
+    free(r->buf);
+    r->f = NULL;
+    r->buf = NULL;
+}
+
+static trace_map_slot_t *map_slot(trace_map_slot_t *slots, uint32_t cap, uint64_t key) {
+    uint32_t i = (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> 40) & (cap - 1);
+    while (slots[i].used && slots[i].key != key) i = (i + 1) & (cap - 1);
+    return &slots[i];
+}
+
+int *trace_map_get(trace_map_t *m, uint64_t key) {
+    if ((m->used + 1) * 10 > m->cap * 7) {
+        // Duplica a tabela quando passa 70% de ocupação
+        uint32_t cap = m->cap ? m->cap * 2 : 1024;
+        trace_map_slot_t *slots = calloc(cap, sizeof(trace_map_slot_t));
+        if (!slots) return NULL;
+        for (uint32_t i = 0; i < m->cap; i++) {
+            if (m->slots[i].used) *map_slot(slots, cap, m->slots[i].key) = m->slots[i];
+        }
+        free(m->slots);
+        m->slots = slots;
+        m->cap = cap;
+    }
+    trace_map_slot_t *s = map_slot(m->slots, m->cap, key);
+    if (!s->used) {
+        s->used = 1;
+        s->key = key;
+        s->value = -1;
+        m->used++;
+    }
+    return &s->value;
+}
+
+void trace_map_free(trace_map_t *m) {
+    free(m->slots);
+    m->slots = NULL;
+    m->cap = 0;
+    m->used = 0;
+}
@@ -0,0 +1,146 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "queue.h"
+
+/*
+ * Trace binário de uma simulação (--trace FILE).
+ *
+ * O ficheiro tem um cabeçalho trace_header_t seguido de registos de tamanho
+ * fixo trace_rec_t, por ordem de tempo, no formato nativo da máquina. O
+ * formato é lido por ferramentas offline (sched-bounds, sched-diff), que o
+ * percorrem do princípio ao fim sem o carregar todo em memória, e pelo
+ * trace-stats, que o mapeia em memória e o divide entre threads.
+ */
+
+#define TRACE_MAGIC "OSTR"
+#define TRACE_VERSION 1
+
+// Tipos de eventos
+typedef enum {
+    TRACE_ARRIVE = 0,   // pedido RUN ou job periódico (arg = duração pedida, arg2 = prazo absoluto ou 0)
+    TRACE_DISPATCH,     // burst colocado num CPU
+    TRACE_PREEMPT,      // burst retirado do CPU antes de terminar
+    TRACE_DONE,         // burst terminado (DONE enviado)
+    TRACE_BLOCK,        // pedido BLOCK recebido (arg = duração)
+    TRACE_UNBLOCK       // fim do BLOCK
+} trace_type_en;
+
+typedef struct {
+    char magic[4];              // TRACE_MAGIC
+    uint32_t version;           // TRACE_VERSION
+    uint32_t ncpus;
+    uint32_t critical_path_ms;  // caminho crítico do workflow (0 se não houver)
+    char policy[16];            // nome do escalonador
+} trace_header_t;
+
+typedef struct {
+    uint32_t time_ms;
+    int32_t pid;
+    uint32_t tid;
+    uint16_t type;              // trace_type_en
+    uint16_t cpu;               // DISPATCH/PREEMPT: CPU (0 nos restantes)
+    uint32_t arg;
+    uint32_t arg2;
+} trace_rec_t;
+
+/**
+ * @brief Abre o ficheiro de trace e escreve o cabeçalho
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int trace_open(const char *path, const char *policy, uint32_t ncpus, uint32_t critical_path_ms);
+
+/**
+ * @brief Indica se há um trace aberto
+ */
+int trace_enabled(void);
+
+/**
+ * @brief Regista um evento de um burst/pedido (não faz nada sem trace aberto)
+ */
+void trace_event(trace_type_en type, uint32_t now_ms, const pcb_t *task, uint32_t cpu, uint32_t arg);
+
+/**
+ * @brief Guarda o estado dos CPUs antes de correr os escalonadores
+ */
+void trace_cpus_begin(pcb_t *const *cpu_tasks, int ncpus);
+
+/**
+ * @brief Compara os CPUs com o estado guardado e regista despachos e preempções
+ *
+ * Os bursts que terminaram entretanto (TRACE_DONE já registado) não contam
+ * como preempção.
+ */
+void trace_cpus_end(uint32_t now_ms, pcb_t *const *cpu_tasks, int ncpus);
+
+/**
+ * @brief Fecha o trace
+ */
+void trace_close(void);
+
+// ---------------------------------------------------------
+// Leitura de traces (ferramentas offline)
+// ---------------------------------------------------------
+
+#define TRACE_READ_BATCH 4096   // registos lidos de cada vez
+
+typedef struct {
+    FILE *f;
+    trace_header_t header;
+    trace_rec_t *buf;
+    size_t n;                   // registos no buffer
+    size_t pos;                 // próximo registo a devolver
+} trace_reader_t;
+
+/**
+ * @brief Valida um cabeçalho lido de um trace (e termina o nome da política)
+ * @return 0 se for um trace desta versão, -1 caso contrário
+ */
+int trace_header_check(trace_header_t *h);
+
+/**
+ * @brief Abre um trace para leitura e valida o cabeçalho
+ * @return 0 em caso de sucesso, -1 em caso de erro (já reportado em stderr)
+ */
+int trace_reader_open(trace_reader_t *r, const char *path);
+
+/**
+ * @brief Próximo registo, sem o consumir (NULL no fim do ficheiro)
+ */
+const trace_rec_t *trace_reader_peek(trace_reader_t *r);
+
+/**
+ * @brief Próximo registo (NULL no fim do ficheiro)
+ */
+const trace_rec_t *trace_reader_next(trace_reader_t *r);
+
+void trace_reader_close(trace_reader_t *r);
+
+// Tabela de dispersão de (pid, tid) para um índice, usada pelas ferramentas
+typedef struct {
+    uint64_t key;
+    int used;
+    int value;
+} trace_map_slot_t;
+
+typedef struct {
+    trace_map_slot_t *slots;
+    uint32_t cap;
+    uint32_t used;
+} trace_map_t;
+
+static inline uint64_t trace_key(int32_t pid, uint32_t tid) {
+    return ((uint64_t)(uint32_t)pid << 32) | tid;
+}
+
+/**
+ * @brief Valor associado a key (inserido com -1 se ainda não existir)
+ * @return Ponteiro para o valor, ou NULL se faltar memória
+ */
+int *trace_map_get(trace_map_t *m, uint64_t key);
+
+void trace_map_free(trace_map_t *m);
+
+#endif //TRACE_H
@@ -0,0 +1,616 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "trace.h"
+
+/*
+ * trace-stats: per-pid and per-window metrics of a trace (ossim --trace FILE),
+ * computed on all cores.
+ *
+ * The trace is mapped in memory and its records are split into one chunk per
+ * worker thread (records have a fixed size, so any record index is an event
+ * boundary). Each worker builds a partial result for its chunk:
+ *
+ *  - additive parts: per-pid counters, per-window counters, the CPU time of
+ *    each pid in each window and the response/wait histograms;
+ *  - per-thread boundary state, for the intervals that cross chunks: an
+ *    ARRIVE in one chunk and its DONE in a later one, and so on.
+ *
+ * The partials are then merged in chunk order, which closes the intervals
+ * left open at the chunk boundaries, and the result is written as CSV:
+ * <prefix>.pids.csv, <prefix>.windows.csv and <prefix>.hist.csv.
+ *
+ * Run like: ./trace-stats [-j THREADS] [--window MS] [--prefix P] trace.bin
+ */
+
+#define NO_TIME UINT32_MAX
+#define HIST_BUCKETS 32         // log2 buckets in ms: [0,1], [2,3], [4,7], ...
+#define MAX_THREADS 256
+
+typedef struct {
+    int32_t pid;
+    uint32_t bursts;            // ARRIVE
+    uint32_t completed;         // DONE
+    uint32_t dispatches;
+    uint32_t preemptions;
+    uint32_t blocks;
+    uint64_t requested_ms;      // sum of the CPU time asked for
+    uint64_t cpu_ms;            // time on a CPU (DISPATCH to PREEMPT/DONE)
+    uint64_t block_ms;
+    uint64_t wait_sum_ms;       // ARRIVE to first DISPATCH
+    uint32_t waits;
+    uint64_t response_sum_ms;   // ARRIVE to DONE
+    uint32_t responses;
+    uint32_t response_max_ms;
+    uint32_t first_ms, last_ms;
+    uint32_t threads;           // distinct tids (filled in after the merge)
+} pid_acc_t;
+
+typedef struct {
+    uint32_t arrivals;
+    uint32_t completed;
+    uint32_t dispatches;
+    uint32_t preemptions;
+    uint64_t busy_ms;           // CPU time used in the window, over all CPUs
+} window_acc_t;
+
+// CPU time of one pid in one window (for the fairness index)
+typedef struct {
+    uint64_t key;               // window << 32 | pid
+    uint64_t cpu_ms;
+} share_t;
+
+// Additive part of a partial result
+typedef struct {
+    trace_map_t pid_index;
+    pid_acc_t *pids;
+    int npids, pids_cap;
+    window_acc_t *windows;      // nwindows entries (shared layout)
+    trace_map_t share_index;
+    share_t *shares;
+    int nshares, shares_cap;
+    uint64_t response_hist[HIST_BUCKETS];
+    uint64_t wait_hist[HIST_BUCKETS];
+} acc_t;
+
+/*
+ * One interval of a thread (waiting, response or running). "head" is the
+ * first event of the chunk that closes an interval opened before the chunk;
+ * after it, or after any event that opens an interval, the state is local
+ * ("touched") and "start" is the interval still open at the end of the chunk.
+ */
+typedef struct {
+    uint32_t head;
+    uint32_t start;
+    uint8_t touched;
+} span_t;
+
+enum { SPAN_WAIT = 0, SPAN_RESPONSE, SPAN_RUN, NSPANS };
+
+typedef struct {
+    int32_t pid;
+    uint32_t tid;
+    int pid_slot;               // index in the chunk's pids
+    span_t span[NSPANS];
+} thread_state_t;
+
+typedef struct {
+    const trace_rec_t *recs;
+    size_t n;
+    acc_t acc;
+    trace_map_t thread_index;
+    thread_state_t *threads;
+    int nthreads, threads_cap;
+    int failed;
+} chunk_t;
+
+static uint32_t window_ms = 1000;
+static uint32_t nwindows = 0;
+
+static int hist_bucket(uint32_t ms) {
+    int b = 0;
+    while (ms > 1 && b < HIST_BUCKETS - 1) {
+        ms >>= 1;
+        b++;
+    }
+    return b;
+}
+
+static int grow(void **array, int *cap, int need, size_t elem) {
+    if (need <= *cap) return 0;
+    int cap2 = *cap ? *cap * 2 : 1024;
+    while (cap2 < need) cap2 *= 2;
+    void *a = realloc(*array, (size_t)cap2 * elem);
+    if (!a) return -1;
+    *array = a;
+    *cap = cap2;
+    return 0;
+}
+
+static pid_acc_t *acc_pid(acc_t *a, int32_t pid) {
+    int *i = trace_map_get(&a->pid_index, trace_key(pid, 0));
+    if (!i) return NULL;
+    if (*i < 0) {
+        if (grow((void **)&a->pids, &a->pids_cap, a->npids + 1, sizeof(pid_acc_t)) < 0) return NULL;
+        *i = a->npids++;
+        memset(&a->pids[*i], 0, sizeof(pid_acc_t));
+        a->pids[*i].pid = pid;
+        a->pids[*i].first_ms = NO_TIME;
+    }
+    return &a->pids[*i];
+}
+
+static share_t *acc_share(acc_t *a, uint32_t window, int32_t pid) {
+    uint64_t key = ((uint64_t)window << 32) | (uint32_t)pid;
+    int *i = trace_map_get(&a->share_index, key);
+    if (!i) return NULL;
+    if (*i < 0) {
+        if (grow((void **)&a->shares, &a->shares_cap, a->nshares + 1, sizeof(share_t)) < 0) return NULL;
+        *i = a->nshares++;
+        a->shares[*i] = (share_t){.key = key, .cpu_ms = 0};
+    }
+    return &a->shares[*i];
+}
+
+static void touch_pid_time(pid_acc_t *p, uint32_t t) {
+    if (p->first_ms == NO_TIME || t < p->first_ms) p->first_ms = t;
+    if (t > p->last_ms) p->last_ms = t;
+}
+
+// Records a finished interval of kind "span" of a thread of pid p
+static int close_span(acc_t *a, pid_acc_t *p, int span, uint32_t start, uint32_t end) {
+    if (end < start) return 0;
+    uint32_t len = end - start;
+    switch (span) {
+        case SPAN_WAIT:
+            p->wait_sum_ms += len;
+            p->waits++;
+            a->wait_hist[hist_bucket(len)]++;
+            break;
+        case SPAN_RESPONSE:
+            p->response_sum_ms += len;
+            p->responses++;
+            if (len > p->response_max_ms) p->response_max_ms = len;
+            a->response_hist[hist_bucket(len)]++;
+            break;
+        case SPAN_RUN:
+            p->cpu_ms += len;
+            // Spread the run over the windows it covers
+            for (uint32_t w = start / window_ms; w < nwindows && (uint64_t)w * window_ms < end; w++) {
+                uint32_t from = w * window_ms > start ? w * window_ms : start;
+                uint32_t to = (w + 1) * window_ms < end ? (w + 1) * window_ms : end;
+                if (to <= from) continue;
+                a->windows[w].busy_ms += to - from;
+                share_t *s = acc_share(a, w, p->pid);
+                if (!s) return -1;
+                s->cpu_ms += to - from;
+            }
+            break;
+        default:
+            break;
+    }
+    return 0;
+}
+
+// Opens an interval at time t
+static void span_open(span_t *s, uint32_t t) {
+    s->touched = 1;
+    s->start = t;
+}
+
+/**
+ * Closes the interval at time t. If the interval was opened before the
+ * chunk, only the head is recorded, to be resolved when merging.
+ */
+static int span_close(acc_t *a, pid_acc_t *p, span_t *s, int span, uint32_t t) {
+    if (!s->touched) {
+        s->touched = 1;
+        s->head = t;
+        s->start = NO_TIME;
+        return 0;
+    }
+    if (s->start == NO_TIME) return 0;
+    int rc = close_span(a, p, span, s->start, t);
+    s->start = NO_TIME;
+    return rc;
+}
+
+static thread_state_t *chunk_thread(chunk_t *c, int32_t pid, uint32_t tid) {
+    int *i = trace_map_get(&c->thread_index, trace_key(pid, tid));
+    if (!i) return NULL;
+    if (*i < 0) {
+        if (grow((void **)&c->threads, &c->threads_cap, c->nthreads + 1, sizeof(thread_state_t)) < 0) return NULL;
+        pid_acc_t *p = acc_pid(&c->acc, pid);
+        if (!p) return NULL;
+        *i = c->nthreads++;
+        thread_state_t *t = &c->threads[*i];
+        memset(t, 0, sizeof(*t));
+        t->pid = pid;
+        t->tid = tid;
+        t->pid_slot = (int)(p - c->acc.pids);
+        for (int s = 0; s < NSPANS; s++) {
+            t->span[s].head = NO_TIME;
+            t->span[s].start = NO_TIME;
+        }
+    }
+    return &c->threads[*i];
+}
+
+static int process_record(chunk_t *c, const trace_rec_t *e) {
+    thread_state_t *t = chunk_thread(c, e->pid, e->tid);
+    if (!t) return -1;
+    acc_t *a = &c->acc;
+    pid_acc_t *p = &a->pids[t->pid_slot];
+    uint32_t w = e->time_ms / window_ms;
+    window_acc_t *win = w < nwindows ? &a->windows[w] : NULL;
+    touch_pid_time(p, e->time_ms);
+
+    int rc = 0;
+    switch (e->type) {
+        case TRACE_ARRIVE:
+            p->bursts++;
+            p->requested_ms += e->arg;
+            if (win) win->arrivals++;
+            span_open(&t->span[SPAN_WAIT], e->time_ms);
+            span_open(&t->span[SPAN_RESPONSE], e->time_ms);
+            // The pid competes for the CPU in this window even if it gets none
+            if (w < nwindows && !acc_share(a, w, e->pid)) rc = -1;
+            break;
+        case TRACE_DISPATCH:
+            p->dispatches++;
+            if (win) win->dispatches++;
+            rc = span_close(a, p, &t->span[SPAN_WAIT], SPAN_WAIT, e->time_ms);
+            span_open(&t->span[SPAN_RUN], e->time_ms);
+            break;
+        case TRACE_PREEMPT:
+            p->preemptions++;
+            if (win) win->preemptions++;
+            rc = span_close(a, p, &t->span[SPAN_RUN], SPAN_RUN, e->time_ms);
+            break;
+        case TRACE_DONE:
+            p->completed++;
+            if (win) win->completed++;
+            rc = span_close(a, p, &t->span[SPAN_RUN], SPAN_RUN, e->time_ms);
+            if (rc == 0) rc = span_close(a, p, &t->span[SPAN_RESPONSE], SPAN_RESPONSE, e->time_ms);
+            break;
+        case TRACE_BLOCK:
+            p->blocks++;
+            p->block_ms += e->arg;
+            break;
+        default:
+            break;
+    }
+    return rc;
+}
+
+static int acc_init(acc_t *a) {
+    memset(a, 0, sizeof(*a));
+    a->windows = calloc(nwindows ? nwindows : 1, sizeof(window_acc_t));
+    return a->windows ? 0 : -1;
+}
+
+static void acc_free(acc_t *a) {
+    trace_map_free(&a->pid_index);
+    trace_map_free(&a->share_index);
+    free(a->pids);
+    free(a->shares);
+    free(a->windows);
+}
+
+static void *worker(void *arg) {
+    chunk_t *c = arg;
+    for (size_t i = 0; i < c->n; i++) {
+        if (process_record(c, &c->recs[i]) < 0) {
+            c->failed = 1;
+            break;
+        }
+    }
+    return NULL;
+}
+
+// Adds the additive part of src to dst
+static int acc_merge(acc_t *dst, const acc_t *src) {
+    for (int i = 0; i < src->npids; i++) {
+        const pid_acc_t *s = &src->pids[i];
+        pid_acc_t *d = acc_pid(dst, s->pid);
+        if (!d) return -1;
+        d->bursts += s->bursts;
+        d->completed += s->completed;
+        d->dispatches += s->dispatches;
+        d->preemptions += s->preemptions;
+        d->blocks += s->blocks;
+        d->requested_ms += s->requested_ms;
+        d->cpu_ms += s->cpu_ms;
+        d->block_ms += s->block_ms;
+        d->wait_sum_ms += s->wait_sum_ms;
+        d->waits += s->waits;
+        d->response_sum_ms += s->response_sum_ms;
+        d->responses += s->responses;
+        if (s->response_max_ms > d->response_max_ms) d->response_max_ms = s->response_max_ms;
+        if (s->first_ms != NO_TIME) touch_pid_time(d, s->first_ms);
+        if (s->last_ms > d->last_ms) d->last_ms = s->last_ms;
+    }
+    for (uint32_t w = 0; w < nwindows; w++) {
+        dst->windows[w].arrivals += src->windows[w].arrivals;
+        dst->windows[w].completed += src->windows[w].completed;
+        dst->windows[w].dispatches += src->windows[w].dispatches;
+        dst->windows[w].preemptions += src->windows[w].preemptions;
+        dst->windows[w].busy_ms += src->windows[w].busy_ms;
+    }
+    for (int i = 0; i < src->nshares; i++) {
+        share_t *d = acc_share(dst, (uint32_t)(src->shares[i].key >> 32), (int32_t)(uint32_t)src->shares[i].key);
+        if (!d) return -1;
+        d->cpu_ms += src->shares[i].cpu_ms;
+    }
+    for (int b = 0; b < HIST_BUCKETS; b++) {
+        dst->response_hist[b] += src->response_hist[b];
+        dst->wait_hist[b] += src->wait_hist[b];
+    }
+    return 0;
+}
+
+/**
+ * Appends the thread states of the next chunk to the merged states (left),
+ * closing the intervals that cross the boundary into the final result.
+ */
+static int merge_threads(chunk_t *left, const chunk_t *right, acc_t *result) {
+    for (int i = 0; i < right->nthreads; i++) {
+        const thread_state_t *r = &right->threads[i];
+        int *slot = trace_map_get(&left->thread_index, trace_key(r->pid, r->tid));
+        if (!slot) return -1;
+        if (*slot < 0) {
+            // First chunk with this thread: heads have nothing to close
+            if (grow((void **)&left->threads, &left->threads_cap, left->nthreads + 1, sizeof(thread_state_t)) < 0) {
+                return -1;
+            }
+            *slot = left->nthreads++;
+            left->threads[*slot] = *r;
+            continue;
+        }
+        thread_state_t *l = &left->threads[*slot];
+        pid_acc_t *p = acc_pid(result, r->pid);
+        if (!p) return -1;
+        for (int s = 0; s < NSPANS; s++) {
+            span_t *ls = &l->span[s];
+            const span_t *rs = &r->span[s];
+            if (!ls->touched) {
+                *ls = *rs;
+                continue;
+            }
+            if (rs->head != NO_TIME && ls->start != NO_TIME) {
+                if (close_span(result, p, s, ls->start, rs->head) < 0) return -1;
+                ls->start = NO_TIME;
+            }
+            if (rs->touched) ls->start = rs->start;
+        }
+    }
+    return 0;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static FILE *open_csv(const char *prefix, const char *suffix) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s.%s.csv", prefix, suffix);
+    FILE *f = fopen(path, "w");
+    if (!f) perror(path);
+    return f;
+}
+
+static int write_pids(const char *prefix, const acc_t *a) {
+    FILE *f = open_csv(prefix, "pids");
+    if (!f) return -1;
+    fprintf(f, "pid,threads,bursts,completed,dispatches,preemptions,blocks,requested_ms,cpu_ms,block_ms,"
+               "mean_wait_ms,mean_response_ms,max_response_ms,first_ms,last_ms\n");
+    for (int i = 0; i < a->npids; i++) {
+        const pid_acc_t *p = &a->pids[i];
+        fprintf(f, "%d,%u,%u,%u,%u,%u,%u,%llu,%llu,%llu,%.1f,%.1f,%u,%u,%u\n",
+                p->pid, p->threads, p->bursts, p->completed, p->dispatches, p->preemptions,
+                p->blocks, (unsigned long long)p->requested_ms, (unsigned long long)p->cpu_ms,
+                (unsigned long long)p->block_ms,
+                p->waits ? (double)p->wait_sum_ms / p->waits : 0.0,
+                p->responses ? (double)p->response_sum_ms / p->responses : 0.0,
+                p->response_max_ms, p->first_ms == NO_TIME ? 0 : p->first_ms, p->last_ms);
+    }
+    return fclose(f);
+}
+
+static int write_windows(const char *prefix, const acc_t *a, uint32_t ncpus) {
+    FILE *f = open_csv(prefix, "windows");
+    if (!f) return -1;
+    // Jain's fairness index of the CPU time of the pids active in each window
+    double *sum = calloc(nwindows ? nwindows : 1, sizeof(double));
+    double *sumsq = calloc(nwindows ? nwindows : 1, sizeof(double));
+    uint32_t *active = calloc(nwindows ? nwindows : 1, sizeof(uint32_t));
+    if (!sum || !sumsq || !active) {
+        free(sum);
+        free(sumsq);
+        free(active);
+        fclose(f);
+        return -1;
+    }
+    for (int i = 0; i < a->nshares; i++) {
+        uint32_t w = (uint32_t)(a->shares[i].key >> 32);
+        double x = (double)a->shares[i].cpu_ms;
+        sum[w] += x;
+        sumsq[w] += x * x;
+        active[w]++;
+    }
+    fprintf(f, "window_start_ms,arrivals,completed,dispatches,preemptions,busy_ms,utilization,active_pids,jain\n");
+    for (uint32_t w = 0; w < nwindows; w++) {
+        const window_acc_t *win = &a->windows[w];
+        double jain = (active[w] > 0 && sumsq[w] > 0) ? sum[w] * sum[w] / (active[w] * sumsq[w]) : 1.0;
+        fprintf(f, "%llu,%u,%u,%u,%u,%llu,%.3f,%u,%.3f\n",
+                (unsigned long long)w * window_ms, win->arrivals, win->completed, win->dispatches,
+                win->preemptions, (unsigned long long)win->busy_ms,
+                (double)win->busy_ms / ((double)window_ms * ncpus), active[w], jain);
+    }
+    free(sum);
+    free(sumsq);
+    free(active);
+    return fclose(f);
+}
+
+static int write_hist(const char *prefix, const acc_t *a) {
+    FILE *f = open_csv(prefix, "hist");
+    if (!f) return -1;
+    fprintf(f, "from_ms,to_ms,responses,waits\n");
+    for (int b = 0; b < HIST_BUCKETS; b++) {
+        if (a->response_hist[b] == 0 && a->wait_hist[b] == 0) continue;
+        uint64_t from = b == 0 ? 0 : 1ull << b;
+        uint64_t to = (2ull << b) - 1;
+        fprintf(f, "%llu,%llu,%llu,%llu\n", (unsigned long long)from, (unsigned long long)to,
+                (unsigned long long)a->response_hist[b], (unsigned long long)a->wait_hist[b]);
+    }
+    return fclose(f);
+}
+
+static long parse_long(const char *s, long min, long max) {
+    char *end;
+    errno = 0;
+    long v = strtol(s, &end, 10);
+    if (errno != 0 || *end != '\0' || v < min || v > max) return -1;
+    return v;
+}
+
+int main(int argc, char *argv[]) {
+    long nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (nthreads < 1) nthreads = 1;
+    if (nthreads > MAX_THREADS) nthreads = MAX_THREADS;
+    const char *prefix = NULL;
+
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        long v = 0;
+        if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+            v = nthreads = parse_long(argv[++i], 1, MAX_THREADS);
+        } else if (!strcmp(argv[i], "--window") && i + 1 < argc) {
+            v = parse_long(argv[++i], 1, INT32_MAX);
+            window_ms = (uint32_t)v;
+        } else if (!strcmp(argv[i], "--prefix") && i + 1 < argc) {
+            prefix = argv[++i];
+        } else {
+            v = -1;
+        }
+        if (v < 0) {
+            fprintf(stderr, "Invalid option: %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc - i != 1) {
+        printf("Usage: %s [-j THREADS] [--window MS] [--prefix P] <trace.bin>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char *path = argv[i];
+    char default_prefix[PATH_MAX];
+    if (!prefix) {
+        // trace.bin -> trace.pids.csv, ...
+        snprintf(default_prefix, sizeof(default_prefix), "%s", path);
+        char *dot = strrchr(default_prefix, '.');
+        char *slash = strrchr(default_prefix, '/');
+        if (dot && (!slash || dot > slash)) *dot = '\0';
+        prefix = default_prefix;
+    }
+
+    double t0 = now_s();
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+    size_t size = (size_t)st.st_size;
+    if (size < sizeof(trace_header_t)) {
+        fprintf(stderr, "%s: not an ossim trace\n", path);
+        close(fd);
+        return EXIT_FAILURE;
+    }
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return EXIT_FAILURE;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+    madvise(map, size, MADV_WILLNEED);
+
+    trace_header_t header;
+    memcpy(&header, map, sizeof(header));
+    if (trace_header_check(&header) < 0) {
+        fprintf(stderr, "%s: not an ossim trace (version %u, expected %d)\n",
+                path, header.version, TRACE_VERSION);
+        munmap(map, size);
+        return EXIT_FAILURE;
+    }
+    const trace_rec_t *recs = (const trace_rec_t *)((const char *)map + sizeof(trace_header_t));
+    size_t nrecs = (size - sizeof(trace_header_t)) / sizeof(trace_rec_t);
+    // Records are in time order: the last one gives the number of windows
+    nwindows = nrecs ? recs[nrecs - 1].time_ms / window_ms + 1 : 0;
+    if ((size_t)nthreads > nrecs / 1024 + 1) nthreads = (long)(nrecs / 1024 + 1);
+
+    static chunk_t chunks[MAX_THREADS];
+    pthread_t tids[MAX_THREADS];
+    int rc = EXIT_SUCCESS;
+    size_t per = nrecs / (size_t)nthreads;
+    for (long c = 0; c < nthreads; c++) {
+        chunks[c].recs = recs + (size_t)c * per;
+        chunks[c].n = (c == nthreads - 1) ? nrecs - (size_t)c * per : per;
+        if (acc_init(&chunks[c].acc) < 0 ||
+            pthread_create(&tids[c], NULL, worker, &chunks[c]) != 0) {
+            fprintf(stderr, "Failed to start worker %ld\n", c);
+            return EXIT_FAILURE;
+        }
+    }
+    for (long c = 0; c < nthreads; c++) {
+        pthread_join(tids[c], NULL);
+        if (chunks[c].failed) rc = EXIT_FAILURE;
+    }
+    double t1 = now_s();
+
+    // Merge in chunk order; the first chunk becomes the result
+    acc_t *result = &chunks[0].acc;
+    for (long c = 1; c < nthreads && rc == EXIT_SUCCESS; c++) {
+        if (acc_merge(result, &chunks[c].acc) < 0 || merge_threads(&chunks[0], &chunks[c], result) < 0) {
+            rc = EXIT_FAILURE;
+        }
+    }
+    for (int t = 0; t < chunks[0].nthreads && rc == EXIT_SUCCESS; t++) {
+        pid_acc_t *p = acc_pid(result, chunks[0].threads[t].pid);
+        if (p) p->threads++; else rc = EXIT_FAILURE;
+    }
+    if (rc != EXIT_SUCCESS) {
+        fprintf(stderr, "Out of memory\n");
+    } else if (write_pids(prefix, result) != 0 ||
+               write_windows(prefix, result, header.ncpus) != 0 ||
+               write_hist(prefix, result) != 0) {
+        rc = EXIT_FAILURE;
+    }
+    double t2 = now_s();
+
+    printf("%s (%s, %u CPUs): %zu records, %d pids, %u windows of %u ms\n",
+           path, header.policy, header.ncpus, nrecs, result->npids, nwindows, window_ms);
+    printf("Scan: %.3f s (%.1f MB/s, %ld threads), merge and CSV: %.3f s\n",
+           t1 - t0, t1 > t0 ? size / (t1 - t0) / 1e6 : 0.0, nthreads, t2 - t1);
+    printf("Wrote %s.pids.csv, %s.windows.csv, %s.hist.csv\n", prefix, prefix, prefix);
+
+    for (long c = 0; c < nthreads; c++) {
+        acc_free(&chunks[c].acc);
+        trace_map_free(&chunks[c].thread_index);
+        free(chunks[c].threads);
+    }
+    munmap(map, size);
+    return rc;
+}
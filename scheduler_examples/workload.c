@@ -0,0 +1,563 @@
+#include "workload.h"
+#include "channel.h"
+#include "burst_queue.h"
+#include "locks.h"
+#include "debug.h"
+#include "hv.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_NAME_LEN 64
+#define MAX_LINE_LEN 1024
+
+typedef enum {
+    WL_WAITING = 0,     // à espera das dependências
+    WL_RUNNING,         // libertada, a executar os seus bursts
+    WL_FINISHED         // todos os bursts terminaram
+} wl_state_en;
+
+// Estado de uma thread da aplicação virtual
+typedef struct {
+    int next;                   // índice do burst em curso
+    process_request_t phase;    // pedido em curso (RUN, BLOCK, LOCK ou UNLOCK)
+} wl_thread_t;
+
+// Tarefa do workflow (e a aplicação virtual que a executa)
+typedef struct {
+    char name[MAX_NAME_LEN];
+    burst_t *script;            // burst script (igual para todas as threads)
+    int nbursts;
+    uint32_t work_ms;           // soma de CPU + I/O do burst script
+
+    wl_thread_t *threads;       // cada thread executa o burst script inteiro
+    int nthreads;
+    int threads_left;           // threads que ainda não terminaram
+
+    int *children;              // índices dos filhos no DAG
+    int nchildren;
+    int nparents;
+    int parents_left;           // pais que ainda não terminaram
+
+    double rank_u;              // caminho mais longo até ao fim (inclui work_ms)
+    double rank_d;              // caminho mais longo desde o início (exclui work_ms)
+    int rank_done;
+
+    // Tarefa periódica (period_ms > 0): um só pedido PERIODIC, um DONE por job
+    uint32_t period_ms;
+    uint32_t wcet_ms;
+    uint32_t deadline_ms;
+    uint32_t jobs;
+    uint32_t jobs_done;
+
+    // Reserva CBS pedida por cada thread antes do primeiro passo (0 = nenhuma)
+    uint32_t reserve_runtime_ms;
+    uint32_t reserve_period_ms;
+
+    // Classe de escalonamento dos pedidos RUN (política CLASSES)
+    uint32_t sched_class;
+    // Intensidade de memória dos pedidos RUN (ver membw.h)
+    uint32_t mem_intensity;
+
+    wl_state_en state;
+    uint32_t fd;                // canal virtual
+    uint32_t release_ms;
+    uint32_t start_ms;          // primeiro ACK recebido
+    uint32_t finish_ms;
+    int started;
+} wl_task_t;
+
+static wl_task_t *tasks = NULL;
+static int ntasks = 0;
+static int finished_count = 0;
+
+static int find_task(const char *name) {
+    for (int i = 0; i < ntasks; i++) {
+        if (!strcmp(tasks[i].name, name)) return i;
+    }
+    return -1;
+}
+
+// Junta a pasta do manifesto a um caminho relativo (-1 se não couber em out)
+static int resolve_path(char *out, size_t len, const char *manifest, const char *file) {
+    const char *slash = strrchr(manifest, '/');
+    int n;
+    if (file[0] == '/' || !slash) {
+        n = snprintf(out, len, "%s", file);
+    } else {
+        n = snprintf(out, len, "%.*s/%s", (int)(slash - manifest), manifest, file);
+    }
+    return n < 0 || (size_t)n >= len ? -1 : 0;
+}
+
+// Liberta os bursts que ainda estão na fila
+static void drop_bursts(burst_queue_t *q) {
+    burst_t *b;
+    while ((b = dequeue_burst(q)) != NULL) free(b);
+}
+
+// Acrescenta uma tarefa vazia com este nome (NULL se o nome já existir)
+static wl_task_t *new_task(const char *name) {
+    if (find_task(name) >= 0) {
+        fprintf(stderr, "Duplicate task '%s'\n", name);
+        return NULL;
+    }
+    wl_task_t *t = realloc(tasks, (size_t)(ntasks + 1) * sizeof(wl_task_t));
+    if (!t) return NULL;
+    tasks = t;
+    t = &tasks[ntasks];
+    memset(t, 0, sizeof(*t));
+    snprintf(t->name, sizeof(t->name), "%s", name);
+    return t;
+}
+
+static int add_task(const char *manifest, const char *name, const char *file, int nthreads) {
+    if (nthreads < 1 || nthreads > CHANNEL_INBOX) {
+        fprintf(stderr, "Task '%s': threads must be between 1 and %d\n", name, CHANNEL_INBOX);
+        return -1;
+    }
+    wl_task_t *t = new_task(name);
+    if (!t) return -1;
+
+    char path[PATH_MAX];
+    if (resolve_path(path, sizeof(path), manifest, file) < 0) {
+        fprintf(stderr, "Task '%s': burst file path too long\n", name);
+        return -1;
+    }
+    burst_queue_t bursts = {.head = NULL, .tail = NULL};
+    int n = read_queue_from_file(&bursts, path);
+    if (n <= 0) {
+        fprintf(stderr, "Failed to read burst file %s\n", path);
+        drop_bursts(&bursts);
+        return -1;
+    }
+    // As threads percorrem o mesmo burst script, por isso guarda-se num vetor
+    t->script = malloc((size_t)n * sizeof(burst_t));
+    t->threads = calloc((size_t)nthreads, sizeof(wl_thread_t));
+    if (!t->script || !t->threads) {
+        free(t->script);
+        free(t->threads);
+        t->script = NULL;
+        t->threads = NULL;
+        drop_bursts(&bursts);
+        return -1;
+    }
+    for (int i = 0; i < n; i++) {
+        burst_t *b = dequeue_burst(&bursts);
+        t->script[i] = *b;
+        t->work_ms += b->burst_time_ms + b->block_time_ms;
+        // Todos os utilizadores são conhecidos: o teto do mutex fica correto
+        if (b->kind == BURST_LOCK) locks_declare(b->lock_id, b->nice);
+        free(b);
+    }
+    t->nbursts = n;
+    t->nthreads = nthreads;
+    ntasks++;
+    return 0;
+}
+
+static int add_periodic(const char *name, uint32_t period_ms, uint32_t wcet_ms,
+                        uint32_t deadline_ms, uint32_t jobs) {
+    uint32_t d = deadline_ms ? deadline_ms : period_ms;
+    if (wcet_ms == 0 || period_ms == 0 || jobs == 0 ||
+        period_ms % TICKS_MS != 0 || d % TICKS_MS != 0 || d > period_ms) {
+        fprintf(stderr, "Periodic task '%s': need C > 0, jobs > 0, and T, D multiples of %d ms with D <= T\n",
+                name, TICKS_MS);
+        return -1;
+    }
+    wl_task_t *t = new_task(name);
+    if (!t) return -1;
+    t->threads = calloc(1, sizeof(wl_thread_t));
+    if (!t->threads) return -1;
+    t->nthreads = 1;
+    t->period_ms = period_ms;
+    t->wcet_ms = wcet_ms;
+    t->deadline_ms = deadline_ms;
+    t->jobs = jobs;
+    // Duração mínima da tarefa: do primeiro job até ao fim do último
+    t->work_ms = (jobs - 1) * period_ms + wcet_ms;
+    ntasks++;
+    return 0;
+}
+
+static int add_reserve(const char *name, uint32_t runtime_ms, uint32_t period_ms) {
+    int i = find_task(name);
+    if (i < 0 || tasks[i].period_ms > 0) {
+        fprintf(stderr, "Unknown task in reserve %s\n", name);
+        return -1;
+    }
+    tasks[i].reserve_runtime_ms = runtime_ms;
+    tasks[i].reserve_period_ms = period_ms;
+    return 0;
+}
+
+static int add_class(const char *name, const char *class_name) {
+    int i = find_task(name);
+    if (i < 0 || tasks[i].period_ms > 0) {
+        fprintf(stderr, "Unknown task in class %s\n", name);
+        return -1;
+    }
+    for (uint32_t k = 0; k < SCHED_CLASS_COUNT; k++) {
+        if (!strcmp(class_name, SCHED_CLASS_STRINGS[k])) {
+            tasks[i].sched_class = k;
+            return 0;
+        }
+    }
+    fprintf(stderr, "Unknown scheduling class %s\n", class_name);
+    return -1;
+}
+
+static int add_mem(const char *name, unsigned intensity) {
+    int i = find_task(name);
+    if (i < 0 || tasks[i].period_ms > 0 || intensity > 100) {
+        fprintf(stderr, "Unknown task or intensity above 100 in mem %s\n", name);
+        return -1;
+    }
+    tasks[i].mem_intensity = intensity;
+    return 0;
+}
+
+static int add_vm(const char *name, int vcpus, const char *policy, int32_t nice) {
+    if (hv_add_vm(name, vcpus, policy, nice) < 0) {
+        fprintf(stderr, "VM %s: need a new name and 1..%d vCPUs in total\n", name, HV_MAX_VCPUS);
+        return -1;
+    }
+    return 0;
+}
+
+static int add_guest(const char *name, const char *vm_name) {
+    int i = find_task(name);
+    int vm = hv_find_vm(vm_name);
+    if (i < 0 || vm < 0) {
+        fprintf(stderr, "Unknown task or VM in guest %s %s\n", name, vm_name);
+        return -1;
+    }
+    return hv_place(WORKLOAD_PID_BASE + i, vm);
+}
+
+static int add_edge(const char *parent, const char *child) {
+    int p = find_task(parent);
+    int c = find_task(child);
+    if (p < 0 || c < 0) {
+        fprintf(stderr, "Unknown task in edge %s -> %s\n", parent, child);
+        return -1;
+    }
+    int *v = realloc(tasks[p].children, (size_t)(tasks[p].nchildren + 1) * sizeof(int));
+    if (!v) return -1;
+    tasks[p].children = v;
+    tasks[p].children[tasks[p].nchildren++] = c;
+    tasks[c].nparents++;
+    tasks[c].parents_left++;
+    return 0;
+}
+
+// Upward rank: work_ms + maior rank_u entre os filhos (DFS com memória)
+static int compute_rank_u(int i, int depth) {
+    wl_task_t *t = &tasks[i];
+    if (t->rank_done) return 0;
+    if (depth > ntasks) {
+        fprintf(stderr, "Workflow has a dependency cycle (task %s)\n", t->name);
+        return -1;
+    }
+    double best = 0.0;
+    for (int k = 0; k < t->nchildren; k++) {
+        int c = t->children[k];
+        if (compute_rank_u(c, depth + 1) < 0) return -1;
+        if (tasks[c].rank_u > best) best = tasks[c].rank_u;
+    }
+    t->rank_u = t->work_ms + best;
+    t->rank_done = 1;
+    return 0;
+}
+
+// Downward rank: propagado por ordem decrescente de rank_u (ordem topológica,
+// porque um pai tem sempre rank_u maior do que qualquer filho)
+static int by_rank_desc(const void *a, const void *b) {
+    double ra = tasks[*(const int *)a].rank_u;
+    double rb = tasks[*(const int *)b].rank_u;
+    return (ra < rb) - (ra > rb);
+}
+
+static int compute_ranks(void) {
+    for (int i = 0; i < ntasks; i++) {
+        if (compute_rank_u(i, 0) < 0) return -1;
+    }
+    int *order = calloc((unsigned)ntasks, sizeof(int));
+    if (!order) return -1;
+    for (int i = 0; i < ntasks; i++) order[i] = i;
+    qsort(order, (size_t)ntasks, sizeof(int), by_rank_desc);
+    for (int k = 0; k < ntasks; k++) {
+        wl_task_t *t = &tasks[order[k]];
+        for (int j = 0; j < t->nchildren; j++) {
+            wl_task_t *c = &tasks[t->children[j]];
+            double d = t->rank_d + t->work_ms;
+            if (d > c->rank_d) c->rank_d = d;
+        }
+    }
+    free(order);
+    return 0;
+}
+
+int workload_load(const char *manifest) {
+    FILE *f = fopen(manifest, "r");
+    if (!f) {
+        perror("fopen");
+        return -1;
+    }
+
+    char line[MAX_LINE_LEN];
+    int lineno = 0;
+    int rc = 0;
+    while (rc == 0 && fgets(line, sizeof(line), f)) {
+        lineno++;
+        char *s = line;
+        while (isspace((unsigned char)*s)) s++;
+        if (*s == '#' || *s == '\0') continue;
+
+        char kind[16], a[MAX_NAME_LEN], b[PATH_MAX];
+        int nthreads = 1;
+        unsigned period, wcet, deadline = 0, jobs = WORKLOAD_PERIODIC_JOBS, runtime, intensity;
+        int vcpus, nice = 0;
+        int n = sscanf(s, "%15s %63s %4095s %d", kind, a, b, &nthreads);
+        if (n >= 1 && !strcmp(kind, "periodic") &&
+            sscanf(s, "%*s %63s %u %u %u %u", a, &period, &wcet, &deadline, &jobs) >= 3) {
+            rc = add_periodic(a, period, wcet, deadline, jobs);
+        } else if (n >= 1 && !strcmp(kind, "reserve") &&
+                   sscanf(s, "%*s %63s %u %u", a, &runtime, &period) == 3) {
+            rc = add_reserve(a, runtime, period);
+        } else if (n >= 1 && !strcmp(kind, "mem") &&
+                   sscanf(s, "%*s %63s %u", a, &intensity) == 2) {
+            rc = add_mem(a, intensity);
+        } else if (n >= 1 && !strcmp(kind, "vm") &&
+                   sscanf(s, "%*s %63s %d %4095s %d", a, &vcpus, b, &nice) >= 3) {
+            rc = add_vm(a, vcpus, b, nice);
+        } else if (n == 3 && !strcmp(kind, "guest")) {
+            rc = add_guest(a, b);
+        } else if (n == 3 && !strcmp(kind, "class")) {
+            rc = add_class(a, b);
+        } else if (n >= 3 && !strcmp(kind, "task")) {
+            rc = add_task(manifest, a, b, nthreads);
+        } else if (n == 3 && !strcmp(kind, "edge")) {
+            rc = add_edge(a, b);
+        } else {
+            fprintf(stderr, "%s:%d: malformed line: %s", manifest, lineno, line);
+            rc = -1;
+        }
+    }
+    fclose(f);
+
+    if (rc == 0 && ntasks == 0) {
+        fprintf(stderr, "Workflow %s has no tasks\n", manifest);
+        rc = -1;
+    }
+    if (rc == 0) rc = compute_ranks();
+    if (rc < 0) {
+        workload_free();
+        return -1;
+    }
+    return ntasks;
+}
+
+// ---------------------------------------------------------
+// Aplicação virtual (mesmo comportamento da app-io)
+// ---------------------------------------------------------
+
+// Primeiro pedido de um burst: RUN, ou LOCK/UNLOCK nos passos de mutex
+static process_request_t step_request(const burst_t *b) {
+    if (b->kind == BURST_LOCK) return PROCESS_REQUEST_LOCK;
+    if (b->kind == BURST_UNLOCK) return PROCESS_REQUEST_UNLOCK;
+    return PROCESS_REQUEST_RUN;
+}
+
+static void post_request(wl_task_t *t, uint32_t tid, process_request_t request) {
+    wl_thread_t *th = &t->threads[tid];
+    const burst_t *b = &t->script[th->next];
+    msg_t msg = {
+        .pid = WORKLOAD_PID_BASE + (int32_t)(t - tasks),
+        .tid = tid,
+        .request = request,
+        .time_ms = (request == PROCESS_REQUEST_BLOCK) ? b->block_time_ms : b->burst_time_ms,
+        .nice = b->nice,
+        .lock = b->lock_id,
+        .sched_class = t->sched_class,
+        .mem_intensity = t->mem_intensity
+    };
+    th->phase = request;
+    if (channel_post(t->fd, &msg) < 0) {
+        fprintf(stderr, "Task %s: channel full\n", t->name);
+    }
+}
+
+// Declaração da tarefa periódica: o simulador liberta os jobs sozinho
+static void post_periodic(wl_task_t *t) {
+    msg_t msg = {
+        .pid = WORKLOAD_PID_BASE + (int32_t)(t - tasks),
+        .tid = 0,
+        .request = PROCESS_REQUEST_PERIODIC,
+        .time_ms = t->wcet_ms,
+        .period_ms = t->period_ms,
+        .deadline_ms = t->deadline_ms,
+        .jobs = t->jobs
+    };
+    t->threads[0].phase = PROCESS_REQUEST_PERIODIC;
+    if (channel_post(t->fd, &msg) < 0) {
+        fprintf(stderr, "Task %s: channel full\n", t->name);
+    }
+}
+
+// Pedido de reserva de uma thread: o primeiro passo segue com ACK ou NACK
+static void post_reserve(wl_task_t *t, uint32_t tid) {
+    msg_t msg = {
+        .pid = WORKLOAD_PID_BASE + (int32_t)(t - tasks),
+        .tid = tid,
+        .request = PROCESS_REQUEST_RESERVE,
+        .time_ms = t->reserve_runtime_ms,
+        .period_ms = t->reserve_period_ms
+    };
+    t->threads[tid].phase = PROCESS_REQUEST_RESERVE;
+    if (channel_post(t->fd, &msg) < 0) {
+        fprintf(stderr, "Task %s: channel full\n", t->name);
+    }
+}
+
+// A última thread terminou: a tarefa termina e os filhos podem avançar
+static void finish_task(wl_task_t *t, uint32_t now_ms) {
+    t->state = WL_FINISHED;
+    t->finish_ms = now_ms;
+    finished_count++;
+    channel_hangup(t->fd);
+    for (int k = 0; k < t->nchildren; k++) {
+        tasks[t->children[k]].parents_left--;
+    }
+    DBG("Task %s finished at %u ms", t->name, now_ms);
+}
+
+static void on_message(uint32_t fd, const msg_t *msg, void *ctx) {
+    (void)fd;
+    wl_task_t *t = ctx;
+    if (msg->tid >= (uint32_t)t->nthreads) return;
+    if (t->threads[msg->tid].phase == PROCESS_REQUEST_RESERVE) {
+        // Rejeitada ou não, a thread corre (sem reserva se veio NACK)
+        post_request(t, msg->tid, step_request(&t->script[0]));
+        return;
+    }
+    if (msg->request == PROCESS_REQUEST_ACK) {
+        if (!t->started) {
+            t->started = 1;
+            t->start_ms = msg->time_ms;
+        }
+        return;
+    }
+    if (msg->request != PROCESS_REQUEST_DONE) return;
+
+    if (t->period_ms > 0) {
+        if (++t->jobs_done == t->jobs) finish_task(t, msg->time_ms);
+        return;
+    }
+
+    // DONE: a thread passa ao pedido seguinte (BLOCK do mesmo burst ou o próximo passo)
+    wl_thread_t *th = &t->threads[msg->tid];
+    if (th->phase == PROCESS_REQUEST_RUN && t->script[th->next].block_time_ms > 0) {
+        post_request(t, msg->tid, PROCESS_REQUEST_BLOCK);
+    } else if (++th->next < t->nbursts) {
+        post_request(t, msg->tid, step_request(&t->script[th->next]));
+    } else if (--t->threads_left == 0) {
+        finish_task(t, msg->time_ms);
+    }
+}
+
+void workload_tick(uint32_t now_ms, workload_connect_fn on_connect, void *ctx) {
+    for (int i = 0; i < ntasks; i++) {
+        wl_task_t *t = &tasks[i];
+        if (t->state != WL_WAITING || t->parents_left > 0) continue;
+
+        // O vetor tasks já não muda de sítio depois de workload_load(),
+        // por isso o ponteiro da tarefa pode servir de contexto do canal
+        t->fd = channel_open_virtual(on_message, t);
+        if (t->fd == (uint32_t)-1) continue;
+        t->state = WL_RUNNING;
+        t->release_ms = now_ms;
+        on_connect(t->fd, ctx);
+        if (t->period_ms > 0) {
+            post_periodic(t);
+            DBG("Periodic task %s released at %u ms", t->name, now_ms);
+            continue;
+        }
+        // Todas as threads arrancam ao mesmo tempo
+        t->threads_left = t->nthreads;
+        for (int k = 0; k < t->nthreads; k++) {
+            t->threads[k].next = 0;
+            if (t->reserve_period_ms > 0) {
+                post_reserve(t, (uint32_t)k);
+            } else {
+                post_request(t, (uint32_t)k, step_request(&t->script[0]));
+            }
+        }
+        DBG("Task %s released at %u ms", t->name, now_ms);
+    }
+}
+
+int workload_finished(void) {
+    return finished_count == ntasks;
+}
+
+double workload_rank(int32_t pid) {
+    int32_t i = pid - WORKLOAD_PID_BASE;
+    if (i < 0 || i >= ntasks) return 0.0;
+    return tasks[i].rank_u;
+}
+
+const char *workload_name(int32_t pid) {
+    int32_t i = pid - WORKLOAD_PID_BASE;
+    if (i < 0 || i >= ntasks) return NULL;
+    return tasks[i].name;
+}
+
+uint32_t workload_critical_path(void) {
+    double cp = 0.0;
+    for (int i = 0; i < ntasks; i++) {
+        if (tasks[i].rank_u > cp) cp = tasks[i].rank_u;
+    }
+    return (uint32_t)cp;
+}
+
+void workload_report(FILE *out) {
+    double cp = 0.0;
+    uint32_t makespan = 0;
+    for (int i = 0; i < ntasks; i++) {
+        if (tasks[i].rank_u > cp) cp = tasks[i].rank_u;
+        if (tasks[i].finish_ms > makespan) makespan = tasks[i].finish_ms;
+    }
+
+    fprintf(out, "---- Workflow (%d tasks) ----\n", ntasks);
+    fprintf(out, "Makespan:             %u ms\n", makespan);
+    fprintf(out, "Critical path:        %.0f ms\n", cp);
+    fprintf(out, "%-16s %8s %8s %8s %8s %8s %8s %8s\n",
+            "task", "work", "rank_u", "slack", "release", "start", "finish", "obs.slack");
+    for (int i = 0; i < ntasks; i++) {
+        wl_task_t *t = &tasks[i];
+        // Folga estática: quanto a tarefa pode atrasar sem aumentar o caminho crítico.
+        // Folga observada: quanto podia ter terminado mais tarde sem aumentar o
+        // makespan obtido, dado o trabalho que ainda depende dela.
+        double slack = cp - t->rank_u - t->rank_d;
+        double latest = makespan - (t->rank_u - t->work_ms);
+        fprintf(out, "%-16s %8u %8.0f %8.0f %8u %8u %8u %8.0f\n",
+                t->name, t->work_ms, t->rank_u, slack,
+                t->release_ms, t->start_ms, t->finish_ms, latest - t->finish_ms);
+    }
+    fflush(out);
+}
+
+void workload_free(void) {
+    for (int i = 0; i < ntasks; i++) {
+        free(tasks[i].script);
+        free(tasks[i].threads);
+        free(tasks[i].children);
+    }
+    free(tasks);
+    tasks = NULL;
+    ntasks = 0;
+    finished_count = 0;
+}
@@ -0,0 +1,99 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Workloads simulados dentro do próprio ossim.
+ *
+ * Um workflow é um grafo de dependências (DAG) entre tarefas. Cada tarefa é
+ * um burst script (o mesmo formato CSV da app-io) e só é libertada quando
+ * todas as tarefas de que depende terminaram. As tarefas são executadas por
+ * aplicações virtuais (ver channel.h) que seguem o mesmo protocolo da app-io:
+ * RUN → ACK → DONE, BLOCK → ACK → DONE, ... e desligam-se no fim.
+ *
+ * Formato do manifesto (linhas começadas por '#' são comentários):
+ *
+ *     task <nome> <burst-file.csv> [threads]
+ *     periodic <nome> <período_ms> <custo_ms> [prazo_ms] [jobs]
+ *     reserve <tarefa> <runtime_ms> <período_ms>
+ *     class <tarefa> <fair|rt-fifo|rt-rr|batch|idle>
+ *     mem <tarefa> <intensidade 0..100>
+ *     vm <nome> <vcpus> <FIFO|SJF|RR|PRIO|HEFT> [nice]
+ *     guest <tarefa> <vm>
+ *     edge <pai> <filho>
+ *
+ * Os caminhos dos burst scripts são relativos à pasta do manifesto.
+ * Uma tarefa com várias threads (até CHANNEL_INBOX) executa o burst script
+ * em cada thread, em paralelo, e só termina quando todas terminarem.
+ *
+ * Uma tarefa periódica envia um só pedido PERIODIC (ver periodic.h) e
+ * termina quando recebe o DONE do último dos seus jobs. Sem prazo (ou com
+ * 0) o prazo é o período; por omissão liberta WORKLOAD_PERIODIC_JOBS jobs.
+ *
+ * Uma linha reserve (depois da tarefa) faz cada thread da tarefa pedir uma
+ * reserva CBS (ver cbs.h) antes do primeiro passo; se for rejeitada, a
+ * thread corre sem reserva.
+ *
+ * Uma linha class escolhe a classe de escalonamento dos pedidos RUN da
+ * tarefa na política CLASSES (ver classes.h); por omissão é fair. Uma linha
+ * mem dá-lhes a intensidade de memória (ver membw.h); por omissão é 0.
+ *
+ * Com linhas vm o ossim escalona em dois níveis (ver hv.h): cada VM tem os
+ * seus vCPUs e a sua política de convidado, e a política da linha de
+ * comandos passa a ser a do anfitrião. Uma linha guest (depois da tarefa e
+ * da VM) põe a tarefa a correr nessa VM; por omissão corre na primeira.
+ */
+
+#define WORKLOAD_PID_BASE 100000   // PIDs das aplicações virtuais
+#define WORKLOAD_PERIODIC_JOBS 10  // jobs de uma tarefa periódica sem essa coluna
+
+// Chamada quando uma aplicação virtual "liga" ao simulador
+typedef void (*workload_connect_fn)(uint32_t fd, void *ctx);
+
+/**
+ * @brief Lê um manifesto de workflow
+ * @return Número de tarefas lidas, ou -1 em caso de erro
+ */
+int workload_load(const char *manifest);
+
+/**
+ * @brief Liberta as tarefas cujas dependências já terminaram
+ *
+ * Deve ser chamada no início de cada tick. Para cada tarefa libertada abre
+ * um canal virtual, chama on_connect e envia o primeiro pedido.
+ */
+void workload_tick(uint32_t now_ms, workload_connect_fn on_connect, void *ctx);
+
+/**
+ * @brief Indica se todas as tarefas do workflow já terminaram
+ */
+int workload_finished(void);
+
+/**
+ * @brief Prioridade HEFT (upward rank) da tarefa com este PID (0 se não existir)
+ */
+double workload_rank(int32_t pid);
+
+/**
+ * @brief Nome da tarefa do workflow com este PID (NULL se não existir)
+ */
+const char *workload_name(int32_t pid);
+
+/**
+ * @brief Comprimento do caminho crítico do workflow, em ms (0 sem workflow)
+ */
+uint32_t workload_critical_path(void);
+
+/**
+ * @brief Imprime makespan, caminho crítico e folga (slack) de cada tarefa
+ */
+void workload_report(FILE *out);
+
+/**
+ * @brief Liberta a memória do workload
+ */
+void workload_free(void);
+
+#endif //WORKLOAD_H